@@ -0,0 +1,55 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2021 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+
+// Timing and report layout shared by the kernel benchmarks, each comparing a
+// baseline against the optimized call on the same data
+namespace gr {
+namespace bench {
+
+// Runs fn until min_time has passed, returning the mean time per call in ns
+template <class F>
+double time_per_call(F&& fn, double min_time)
+{
+    uint64_t iterations = 0;
+    auto t1 = std::chrono::steady_clock::now();
+    double elapsed = 0;
+    do {
+        fn();
+        iterations++;
+        elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - t1).count();
+    } while (elapsed < min_time);
+    return elapsed * 1e9 / iterations;
+}
+
+inline void print_header(const char* baseline, const char* optimized, const char* rate)
+{
+    printf("%-24s %14s %14s %10s %12s\n", "Benchmark", baseline, optimized, "speedup", rate);
+}
+
+// The times per call in ns, and the rate of the optimized call in millions of
+// the units it handles per call
+inline void print_row(const char* label, double baseline, double optimized, double units)
+{
+    printf("%-24s %14.0f %14.0f %10.2f %12.1f\n",
+           label,
+           baseline,
+           optimized,
+           baseline / optimized,
+           units / optimized * 1e3);
+}
+
+} // namespace bench
+} // namespace gr
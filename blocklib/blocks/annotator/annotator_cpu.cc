@@ -13,6 +13,7 @@
 #include <pmtf/string.hpp>
 #include <pmtf/scalar.hpp>
 #include <string.h>
+#include <algorithm>
 #include <iomanip>
 #include <iostream>
 
@@ -30,6 +31,11 @@ annotator_cpu::annotator_cpu(const block_args& args)
 
     set_tag_propagation_policy(args.tpp);
 
+    // The data goes through untouched, where an output has an input of its own
+    for (size_t i = 0; i < std::min(d_num_inputs, d_num_outputs); i++) {
+        set_pass_through(i, i);
+    }
+
     d_tag_counter = 0;
     // set_relative_rate(1, 1);
 }
@@ -9,8 +9,10 @@ work_return_code_t copy_cpu::work(std::vector<block_work_input_sptr>& work_input
     auto iptr = work_input[0]->items<uint8_t>();
     int size = work_output[0]->n_items * work_output[0]->buffer->item_size();
     auto optr = work_output[0]->items<uint8_t>();
-    // std::copy(iptr, iptr + size, optr);
-    memcpy(optr, iptr, size);
+    // Nothing to do when the output is a view of the input
+    if (optr != iptr) {
+        memcpy(optr, iptr, size);
+    }
 
     work_output[0]->n_produced = work_output[0]->n_items;
     return work_return_code_t::WORK_OK;
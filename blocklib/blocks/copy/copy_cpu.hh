@@ -8,7 +8,10 @@ namespace blocks {
 class copy_cpu : public copy
 {
 public:
-    copy_cpu(block_args args) : sync_block("copy"), copy(args), d_itemsize(args.itemsize) {}
+    copy_cpu(block_args args) : sync_block("copy"), copy(args), d_itemsize(args.itemsize)
+    {
+        set_pass_through(0, 0);
+    }
     virtual work_return_code_t work(std::vector<block_work_input_sptr>& work_input,
                                     std::vector<block_work_output_sptr>& work_output) override;
 
@@ -17,6 +17,7 @@ namespace blocks {
 head_cpu::head_cpu(const block_args& args)
     : sync_block("head"), head(args), d_itemsize(args.itemsize), d_nitems(args.nitems)
 {
+    set_pass_through(0, 0);
 }
 
 work_return_code_t head_cpu::work(std::vector<block_work_input_sptr>& work_input,
@@ -37,7 +38,9 @@ work_return_code_t head_cpu::work(std::vector<block_work_input_sptr>& work_input
         return work_return_code_t::WORK_OK;
     }
 
-    memcpy(optr, iptr, n * work_input[0]->buffer->item_size());
+    if (optr != iptr) {
+        memcpy(optr, iptr, n * work_input[0]->buffer->item_size());
+    }
 
     d_ncopied_items += n;
     work_output[0]->n_produced = n;
@@ -0,0 +1,102 @@
+#include "latency_probe_cpu.hh"
+#include "latency_probe_cpu_gen.hh"
+
+#include <pmtf/scalar.hpp>
+#include <pmtf/string.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+
+namespace gr {
+namespace blocks {
+
+latency_probe_cpu::latency_probe_cpu(const block_args& args)
+    : sync_block("latency_probe"),
+      latency_probe(args),
+      d_max_samples(args.max_samples),
+      d_key(pmtf::string("latency_stamp"))
+{
+    if (d_max_samples == 0) {
+        throw std::invalid_argument("latency_probe: max_samples must be at least 1");
+    }
+    d_latencies.reserve(d_max_samples);
+}
+
+work_return_code_t latency_probe_cpu::work(std::vector<block_work_input_sptr>& work_input,
+                                           std::vector<block_work_output_sptr>& work_output)
+{
+    auto ninput_items = work_input[0]->n_items;
+
+    // Stamps from latency_stamp hold the steady clock time, in ns, when the item went
+    // through it
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    auto tags = work_input[0]->tags_in_window(0, ninput_items);
+    if (!tags.empty()) {
+        std::lock_guard<std::mutex> lock(d_mutex);
+        for (auto& t : tags) {
+            if (t.key != d_key) {
+                continue;
+            }
+            auto stamp = std::chrono::nanoseconds(pmtf::get_scalar<uint64_t>(t.value).value());
+            double latency = std::chrono::duration<double>(now - stamp).count();
+            if (d_latencies.size() < d_max_samples) {
+                d_latencies.push_back(latency);
+            } else {
+                d_latencies[d_next] = latency;
+            }
+            d_next = (d_next + 1) % d_max_samples;
+        }
+    }
+
+    work_input[0]->n_consumed = ninput_items;
+    return work_return_code_t::WORK_OK;
+}
+
+bool latency_probe_cpu::stop()
+{
+    if (num_samples() > 0) {
+        GR_LOG_INFO(_logger,
+                    "{} stamped items, latency p50 {} us, p99 {} us, max {} us",
+                    num_samples(),
+                    percentile(50) * 1e6,
+                    percentile(99) * 1e6,
+                    percentile(100) * 1e6);
+    }
+    return block::stop();
+}
+
+double latency_probe_cpu::percentile(double p)
+{
+    std::vector<double> latencies;
+    {
+        std::lock_guard<std::mutex> lock(d_mutex);
+        latencies = d_latencies;
+    }
+    if (latencies.empty()) {
+        return 0.0;
+    }
+
+    // Nearest rank
+    auto rank = (size_t)std::ceil(std::clamp(p, 0.0, 100.0) / 100.0 * latencies.size());
+    auto it = latencies.begin() + std::max(rank, (size_t)1) - 1;
+    std::nth_element(latencies.begin(), it, latencies.end());
+    return *it;
+}
+
+size_t latency_probe_cpu::num_samples()
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    return d_latencies.size();
+}
+
+void latency_probe_cpu::reset()
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    d_latencies.clear();
+    d_next = 0;
+}
+
+} // namespace blocks
+} // namespace gr
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <gnuradio/blocks/latency_probe.hh>
+
+#include <mutex>
+
+namespace gr {
+namespace blocks {
+
+class latency_probe_cpu : public latency_probe
+{
+public:
+    latency_probe_cpu(const block_args& args);
+    virtual work_return_code_t work(std::vector<block_work_input_sptr>& work_input,
+                                    std::vector<block_work_output_sptr>& work_output) override;
+    bool stop() override;
+
+    /**
+     * @brief Latency in seconds that p percent of the stamped items stayed under
+     *
+     * Over the last max_samples stamped items, 0 if none has arrived yet
+     */
+    double percentile(double p) override;
+    size_t num_samples() override;
+    void reset() override;
+
+protected:
+    size_t d_max_samples;
+    pmtf::wrap d_key;
+
+    std::mutex d_mutex;
+    // Most recent latencies in seconds, written round robin once full
+    std::vector<double> d_latencies;
+    size_t d_next = 0;
+};
+
+} // namespace blocks
+} // namespace gr
@@ -0,0 +1,60 @@
+#include "latency_stamp_cpu.hh"
+#include "latency_stamp_cpu_gen.hh"
+
+#include <pmtf/scalar.hpp>
+#include <pmtf/string.hpp>
+
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+
+namespace gr {
+namespace blocks {
+
+latency_stamp_cpu::latency_stamp_cpu(const block_args& args)
+    : sync_block("latency_stamp"),
+      latency_stamp(args),
+      d_period(args.period),
+      d_key(pmtf::string("latency_stamp"))
+{
+    if (d_period == 0) {
+        throw std::invalid_argument("latency_stamp: period must be at least 1");
+    }
+    set_pass_through(0, 0);
+}
+
+bool latency_stamp_cpu::start()
+{
+    d_srcid = pmtf::string(alias());
+    return block::start();
+}
+
+work_return_code_t latency_stamp_cpu::work(std::vector<block_work_input_sptr>& work_input,
+                                           std::vector<block_work_output_sptr>& work_output)
+{
+    auto in = work_input[0]->items<uint8_t>();
+    auto out = work_output[0]->items<uint8_t>();
+    auto noutput_items = work_output[0]->n_items;
+
+    // The output is normally a view of the input, so there is nothing to copy
+    if (out != in) {
+        std::memcpy(out, in, noutput_items * work_output[0]->buffer->item_size());
+    }
+
+    // Every period-th item carries the time it went through here, read back by
+    // latency_probe
+    uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                      std::chrono::steady_clock::now().time_since_epoch())
+                      .count();
+    auto abs_N = work_output[0]->buffer->total_written();
+    auto first = ((abs_N + d_period - 1) / d_period) * d_period;
+    for (auto offset = first; offset < abs_N + noutput_items; offset += d_period) {
+        work_output[0]->add_tag(offset, d_key, pmtf::scalar<uint64_t>(ns), d_srcid);
+    }
+
+    work_output[0]->n_produced = noutput_items;
+    return work_return_code_t::WORK_OK;
+}
+
+} // namespace blocks
+} // namespace gr
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <gnuradio/blocks/latency_stamp.hh>
+
+namespace gr {
+namespace blocks {
+
+class latency_stamp_cpu : public latency_stamp
+{
+public:
+    latency_stamp_cpu(const block_args& args);
+    bool start() override;
+    virtual work_return_code_t work(std::vector<block_work_input_sptr>& work_input,
+                                    std::vector<block_work_output_sptr>& work_output) override;
+
+protected:
+    uint64_t d_period;
+    pmtf::wrap d_key;
+    pmtf::wrap d_srcid;
+};
+
+} // namespace blocks
+} // namespace gr
@@ -1,5 +1,7 @@
 #include "throttle_cpu.hh"
-#include <thread>
+
+#include <algorithm>
+#include <cstring>
 
 namespace gr {
 namespace blocks {
@@ -18,64 +20,55 @@ void throttle_cpu::set_sample_rate(double rate)
     d_sample_period = std::chrono::duration<double>(1 / rate);
 }
 
+std::chrono::steady_clock::time_point throttle_cpu::due_time(uint64_t nsamples)
+{
+    return d_start + std::chrono::ceil<std::chrono::steady_clock::duration>(
+                         d_sample_period * nsamples);
+}
+
 bool throttle_cpu::start()
 {
     d_start = std::chrono::steady_clock::now();
     d_total_samples = 0;
+    d_wakeup = d_start;
     return block::start();
 }
 
 work_return_code_t throttle_cpu::work(std::vector<block_work_input_sptr>& work_input,
                                       std::vector<block_work_output_sptr>& work_output)
 {
-    if (d_sleeping)
-    {
-        produce_each(0, work_output);
-        consume_each(0, work_input);
-        return work_return_code_t::WORK_OK;
-    }
-
-    // copy all samples output[i] <= input[i]
     auto in = work_input[0]->items<uint8_t>();
     auto out = work_output[0]->items<uint8_t>();
 
     auto noutput_items = work_output[0]->n_items;
 
-    d_total_samples += noutput_items;
-
+    // Pass as many samples as are due by now
     auto now = std::chrono::steady_clock::now();
-    auto expected_time = d_start + d_sample_period * d_total_samples;
-    int n = noutput_items;
-    if (expected_time > now) {
-        auto limit_duration =
-            std::chrono::duration<double>(std::numeric_limits<long>::max());
+    auto due = (uint64_t)((now - d_start) / d_sample_period);
+    int n = 0;
+    if (due > d_total_samples) {
+        n = (int)std::min<uint64_t>(noutput_items, due - d_total_samples);
+    }
 
-        d_sleeping = true;
-        std::thread t([this, expected_time, now]() {
-            GR_LOG_DEBUG(
-                this->debug_logger(),
-                "Throttle sleeping {}",
-                std::chrono::duration_cast<std::chrono::milliseconds>(expected_time - now)
-                    .count());
-            std::this_thread::sleep_until(expected_time);
-            this->p_scheduler->push_message(
-                std::make_shared<scheduler_action>(scheduler_action_t::NOTIFY_INPUT));
-            this->d_sleeping = false;
-        });
-        t.detach();
+    if (n < noutput_items && now >= d_wakeup) {
+        // Come back once the rest are due, but no later than s_max_sleep from now
+        // unless not even the next sample is due by then
+        d_wakeup = std::max(
+            std::min(due_time(d_total_samples + noutput_items), now + s_max_sleep),
+            due_time(d_total_samples + n + 1));
 
-        n = 0;
-        d_total_samples -= noutput_items;
-        produce_each(0, work_output);
-        consume_each(0, work_input);
-        return work_return_code_t::WORK_OK;
+        GR_LOG_DEBUG(this->debug_logger(),
+                     "Throttle sleeping {} us",
+                     std::chrono::duration_cast<std::chrono::microseconds>(d_wakeup - now)
+                         .count());
+        notify_scheduler_at(d_wakeup);
     }
 
-    // TODO: blocks like throttle shouldn't need to do a memcpy, but this would have to be
-    // fixed in the buffering model and a special port type
-    if (n) {
+    // The output is normally a view of the input, so there is nothing to copy
+    if (n && out != in) {
         std::memcpy(out, in, n * work_output[0]->buffer->item_size());
     }
+    d_total_samples += n;
     work_output[0]->n_produced = n;
 
     GR_LOG_DEBUG(this->debug_logger(), "Throttle produced {}", n);
@@ -2,7 +2,6 @@
 
 #include <gnuradio/blocks/throttle.hh>
 #include <chrono>
-#include <atomic>
 
 namespace gr {
 namespace blocks {
@@ -16,6 +15,7 @@ public:
           d_ignore_tags(args.ignore_tags)
     {
         set_sample_rate(args.samples_per_sec);
+        set_pass_through(0, 0);
     }
     void set_sample_rate(double rate);
 
@@ -33,7 +33,14 @@ protected:
     double d_sample_rate;
     std::chrono::duration<double> d_sample_period;
 
-    std::atomic<bool> d_sleeping = false;
+    // Longest wait for the samples of one call to be due, so that slow rates still
+    // pass samples as they come due rather than a whole buffer at a time
+    static constexpr std::chrono::milliseconds s_max_sleep{ 10 };
+    // Time of the pending wake-up from the timer service
+    std::chrono::steady_clock::time_point d_wakeup;
+
+    // Time at which the first nsamples samples are due
+    std::chrono::steady_clock::time_point due_time(uint64_t nsamples);
 };
 
 } // namespace blocks
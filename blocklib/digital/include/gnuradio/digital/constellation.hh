@@ -74,6 +74,18 @@ public:
     //! Calculates distance.
     // unsigned int decision_maker_e(const gr_complex *sample, float *error);
 
+    /*!
+     * \brief Returns the constellation points that match best for \p nsymbols
+     * symbols of dimensionality() samples each.
+     *
+     * \details Does the work of decision_maker for a whole array in one call.
+     * Constellations with a cheaper test than the distance to every point
+     * override it.
+     */
+    virtual void decision_maker_n(const gr_complex* samples,
+                                  unsigned int* decisions,
+                                  unsigned int nsymbols);
+
     //! Calculates metrics for all points in the constellation.
     //! For use with the viterbi algorithm.
     virtual void calc_metric(const gr_complex* sample,
@@ -82,6 +94,12 @@ public:
     virtual void calc_euclidean_metric(const gr_complex* sample, float* metric);
     virtual void calc_hard_symbol_metric(const gr_complex* sample, float* metric);
 
+    //! Calculates the metrics of \p nsymbols symbols, arity() metrics for each.
+    void calc_metric_n(const gr_complex* samples,
+                       float* metrics,
+                       unsigned int nsymbols,
+                       gr::digital::trellis_metric_type_t type);
+
     //! Returns the set of points in this constellation.
     std::vector<gr_complex> points() { return d_constellation; }
     //! Returns the vector of points in this constellation.
@@ -186,6 +204,20 @@ public:
      */
     std::vector<float> soft_decision_maker(gr_complex sample);
 
+    /*! \brief Writes the soft decisions for \p nsamples samples.
+     *
+     * \details Like #soft_decision_maker, with the decisions of each sample
+     * placed one after another in \p soft_decisions, as many for each as
+     * #soft_decision_maker returns.
+     *
+     * \param samples The complex samples to get the soft decisions.
+     * \param soft_decisions Where to write the soft decisions.
+     * \param nsamples Number of samples.
+     */
+    void soft_decision_maker_n(const gr_complex* samples,
+                               float* soft_decisions,
+                               unsigned int nsamples);
+
 
 protected:
     std::vector<gr_complex> d_constellation;
@@ -203,8 +235,22 @@ protected:
     int d_lut_precision;
     float d_lut_scale;
 
+    // The points split into real and imaginary parts, and the soft decision LUT
+    // in one piece, for the batched calls
+    std::vector<float> d_points_re;
+    std::vector<float> d_points_im;
+    std::vector<float> d_soft_dec_lut_flat;
+
     float get_distance(unsigned int index, const gr_complex* sample);
     unsigned int get_closest_point(const gr_complex* sample);
+    void get_closest_points(const gr_complex* samples,
+                            unsigned int* indices,
+                            unsigned int nsymbols);
+    void calc_euclidean_metric_n(const gr_complex* samples,
+                                 float* metrics,
+                                 unsigned int nsymbols);
+    unsigned int soft_dec_lut_index(gr_complex sample);
+    void flatten_soft_dec_lut();
     void calc_arity();
 
     void max_min_axes();
@@ -249,6 +295,9 @@ public:
                      normalization_t normalization = AMPLITUDE_NORMALIZATION);
 
     unsigned int decision_maker(const gr_complex* sample) override;
+    void decision_maker_n(const gr_complex* samples,
+                          unsigned int* decisions,
+                          unsigned int nsymbols) override;
     // void calc_metric(gr_complex *sample, float *metric, trellis_metric_type_t type);
     // void calc_euclidean_metric(gr_complex *sample, float *metric);
     // void calc_hard_symbol_metric(gr_complex *sample, float *metric);
@@ -504,6 +553,9 @@ public:
     ~constellation_bpsk() override;
 
     unsigned int decision_maker(const gr_complex* sample) override;
+    void decision_maker_n(const gr_complex* samples,
+                          unsigned int* decisions,
+                          unsigned int nsymbols) override;
 
 protected:
     constellation_bpsk();
@@ -540,6 +592,9 @@ public:
     ~constellation_qpsk() override;
 
     unsigned int decision_maker(const gr_complex* sample) override;
+    void decision_maker_n(const gr_complex* samples,
+                          unsigned int* decisions,
+                          unsigned int nsymbols) override;
 
 protected:
     constellation_qpsk();
@@ -612,6 +667,9 @@ public:
     ~constellation_8psk() override;
 
     unsigned int decision_maker(const gr_complex* sample) override;
+    void decision_maker_n(const gr_complex* samples,
+                          unsigned int* decisions,
+                          unsigned int nsymbols) override;
 
 protected:
     constellation_8psk();
@@ -686,6 +744,9 @@ public:
     ~constellation_16qam() override;
 
     unsigned int decision_maker(const gr_complex* sample) override;
+    void decision_maker_n(const gr_complex* samples,
+                          unsigned int* decisions,
+                          unsigned int nsymbols) override;
 
 protected:
     constellation_16qam();
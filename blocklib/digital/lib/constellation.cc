@@ -16,14 +16,23 @@
 #include <gnuradio/math.hh>
 
 
+#include <algorithm>
 #include <cassert>
 #include <cfloat>
+#include <cmath>
 #include <cstdlib>
+#include <cstring>
 #include <stdexcept>
 
 namespace gr {
 namespace digital {
 
+namespace {
+// Samples the batched calls work on at once, small enough for their state to
+// stay on the stack
+constexpr unsigned int sample_block = 64;
+} // namespace
+
 // Base Constellation Class
 constellation::constellation(std::vector<gr_complex> constell,
                              std::vector<int> pre_diff_code,
@@ -145,6 +154,57 @@ unsigned int constellation::get_closest_point(const gr_complex* sample)
     return min_index;
 }
 
+// The distances to one point at a time over a block of samples, which the compiler
+// vectorizes, instead of one sample at a time over all the points
+void constellation::get_closest_points(const gr_complex* samples,
+                                       unsigned int* indices,
+                                       unsigned int nsymbols)
+{
+    if (d_dimensionality != 1) {
+        for (unsigned int i = 0; i < nsymbols; i++) {
+            indices[i] = get_closest_point(samples + i * d_dimensionality);
+        }
+        return;
+    }
+
+    float re[sample_block];
+    float im[sample_block];
+    float min_dist[sample_block];
+    unsigned int min_index[sample_block];
+
+    for (unsigned int i0 = 0; i0 < nsymbols; i0 += sample_block) {
+        unsigned int n = std::min(sample_block, nsymbols - i0);
+        for (unsigned int i = 0; i < n; i++) {
+            re[i] = samples[i0 + i].real();
+            im[i] = samples[i0 + i].imag();
+            min_dist[i] = FLT_MAX;
+            min_index[i] = 0;
+        }
+        for (unsigned int j = 0; j < d_arity; j++) {
+            const float point_re = d_points_re[j];
+            const float point_im = d_points_im[j];
+            for (unsigned int i = 0; i < n; i++) {
+                float dre = re[i] - point_re;
+                float dim = im[i] - point_im;
+                float dist = dre * dre + dim * dim;
+                bool closer = dist < min_dist[i];
+                min_dist[i] = closer ? dist : min_dist[i];
+                min_index[i] = closer ? j : min_index[i];
+            }
+        }
+        memcpy(indices + i0, min_index, n * sizeof(unsigned int));
+    }
+}
+
+void constellation::decision_maker_n(const gr_complex* samples,
+                                     unsigned int* decisions,
+                                     unsigned int nsymbols)
+{
+    for (unsigned int i = 0; i < nsymbols; i++) {
+        decisions[i] = decision_maker(samples + i * d_dimensionality);
+    }
+}
+
 unsigned int constellation::decision_maker_pe(const gr_complex* sample,
                                               float* phase_error)
 {
@@ -221,12 +281,78 @@ void constellation::calc_hard_symbol_metric(const gr_complex* sample, float* met
     }
 }
 
+void constellation::calc_metric_n(const gr_complex* samples,
+                                  float* metrics,
+                                  unsigned int nsymbols,
+                                  trellis_metric_type_t type)
+{
+    switch (type) {
+    case TRELLIS_EUCLIDEAN:
+        calc_euclidean_metric_n(samples, metrics, nsymbols);
+        break;
+    case TRELLIS_HARD_SYMBOL: {
+        unsigned int closest[sample_block];
+        for (unsigned int i0 = 0; i0 < nsymbols; i0 += sample_block) {
+            unsigned int n = std::min(sample_block, nsymbols - i0);
+            get_closest_points(samples + i0 * d_dimensionality, closest, n);
+            float* m = metrics + (size_t)i0 * d_arity;
+            std::fill(m, m + (size_t)n * d_arity, 1.0f);
+            for (unsigned int i = 0; i < n; i++) {
+                m[(size_t)i * d_arity + closest[i]] = 0.0f;
+            }
+        }
+        break;
+    }
+    case TRELLIS_HARD_BIT:
+        throw std::runtime_error("Invalid metric type (not yet implemented).");
+        break;
+    default:
+        throw std::runtime_error("Invalid metric type.");
+    }
+}
+
+void constellation::calc_euclidean_metric_n(const gr_complex* samples,
+                                            float* metrics,
+                                            unsigned int nsymbols)
+{
+    if (d_dimensionality != 1) {
+        for (unsigned int i = 0; i < nsymbols; i++) {
+            for (unsigned int o = 0; o < d_arity; o++) {
+                metrics[(size_t)i * d_arity + o] =
+                    get_distance(o, samples + i * d_dimensionality);
+            }
+        }
+        return;
+    }
+
+    const float* points_re = d_points_re.data();
+    const float* points_im = d_points_im.data();
+    for (unsigned int i = 0; i < nsymbols; i++) {
+        const float re = samples[i].real();
+        const float im = samples[i].imag();
+        float* m = metrics + (size_t)i * d_arity;
+        for (unsigned int o = 0; o < d_arity; o++) {
+            float dre = re - points_re[o];
+            float dim = im - points_im[o];
+            m[o] = dre * dre + dim * dim;
+        }
+    }
+}
+
 void constellation::calc_arity()
 {
     if (d_constellation.size() % d_dimensionality != 0)
         throw std::runtime_error(
             "Constellation vector size must be a multiple of the dimensionality.");
     d_arity = d_constellation.size() / d_dimensionality;
+
+    // Every constructor ends here once the points are final
+    d_points_re.resize(d_constellation.size());
+    d_points_im.resize(d_constellation.size());
+    for (size_t i = 0; i < d_constellation.size(); i++) {
+        d_points_re[i] = d_constellation[i].real();
+        d_points_im[i] = d_constellation[i].imag();
+    }
 }
 
 unsigned int constellation::decision_maker_v(std::vector<gr_complex> sample)
@@ -257,6 +383,7 @@ void constellation::gen_soft_dec_lut(int precision, float npwr)
     }
 
     d_lut_precision = precision;
+    flatten_soft_dec_lut();
 }
 
 std::vector<float> constellation::calc_soft_dec(gr_complex sample, float npwr)
@@ -312,46 +439,92 @@ void constellation::set_soft_dec_lut(const std::vector<std::vector<float>>& soft
     d_soft_dec_lut = soft_dec_lut;
     d_lut_precision = precision;
     d_lut_scale = powf(2.0, static_cast<float>(precision));
+    flatten_soft_dec_lut();
+}
+
+void constellation::flatten_soft_dec_lut()
+{
+    d_soft_dec_lut_flat.clear();
+    if (d_soft_dec_lut.empty()) {
+        return;
+    }
+
+    const size_t k = d_soft_dec_lut[0].size();
+    d_soft_dec_lut_flat.reserve(d_soft_dec_lut.size() * k);
+    for (const auto& decisions : d_soft_dec_lut) {
+        if (decisions.size() != k) {
+            throw std::runtime_error(
+                "All soft decision LUT entries must be of the same length.");
+        }
+        d_soft_dec_lut_flat.insert(
+            d_soft_dec_lut_flat.end(), decisions.begin(), decisions.end());
+    }
 }
 
 bool constellation::has_soft_dec_lut() { return !d_soft_dec_lut.empty(); }
 
 std::vector<std::vector<float>> constellation::soft_dec_lut() { return d_soft_dec_lut; }
 
+unsigned int constellation::soft_dec_lut_index(gr_complex sample)
+{
+    // Clip to just below 1 --> at 1, we can overflow the index
+    // that will put us in the next row of the 2D LUT.
+    float xre = branchless_clip(sample.real(), 0.99);
+    float xim = branchless_clip(sample.imag(), 0.99);
+
+    // We normalize the constellation in the ctor, so we know that
+    // the maximum dimensions go from -1 to +1. We can infer the x
+    // and y scale directly.
+    float scale = d_lut_scale / (2.0f);
+
+    // Convert the clipped x and y samples to nearest index offset
+    xre = floorf((1.0f + xre) * scale);
+    xim = floorf((1.0f + xim) * scale);
+    int index = static_cast<int>(d_lut_scale * xim + xre);
+
+    int max_index = d_lut_scale * d_lut_scale;
+
+    // Make sure we are in bounds of the index
+    while (index >= max_index) {
+        index -= d_lut_scale;
+    }
+    while (index < 0) {
+        index += d_lut_scale;
+    }
+
+    return index;
+}
+
 std::vector<float> constellation::soft_decision_maker(gr_complex sample)
 {
     if (has_soft_dec_lut()) {
-        // Clip to just below 1 --> at 1, we can overflow the index
-        // that will put us in the next row of the 2D LUT.
-        float xre = branchless_clip(sample.real(), 0.99);
-        float xim = branchless_clip(sample.imag(), 0.99);
-
-        // We normalize the constellation in the ctor, so we know that
-        // the maximum dimensions go from -1 to +1. We can infer the x
-        // and y scale directly.
-        float scale = d_lut_scale / (2.0f);
-
-        // Convert the clipped x and y samples to nearest index offset
-        xre = floorf((1.0f + xre) * scale);
-        xim = floorf((1.0f + xim) * scale);
-        int index = static_cast<int>(d_lut_scale * xim + xre);
-
-        int max_index = d_lut_scale * d_lut_scale;
-
-        // Make sure we are in bounds of the index
-        while (index >= max_index) {
-            index -= d_lut_scale;
-        }
-        while (index < 0) {
-            index += d_lut_scale;
-        }
-
-        return d_soft_dec_lut[index];
+        return d_soft_dec_lut[soft_dec_lut_index(sample)];
     } else {
         return calc_soft_dec(sample);
     }
 }
 
+void constellation::soft_decision_maker_n(const gr_complex* samples,
+                                          float* soft_decisions,
+                                          unsigned int nsamples)
+{
+    if (!has_soft_dec_lut()) {
+        for (unsigned int i = 0; i < nsamples; i++) {
+            auto decisions = calc_soft_dec(samples[i]);
+            soft_decisions = std::copy(decisions.begin(), decisions.end(), soft_decisions);
+        }
+        return;
+    }
+
+    const size_t k = d_soft_dec_lut[0].size();
+    const float* lut = d_soft_dec_lut_flat.data();
+    for (unsigned int i = 0; i < nsamples; i++) {
+        memcpy(soft_decisions + i * k,
+               lut + soft_dec_lut_index(samples[i]) * k,
+               k * sizeof(float));
+    }
+}
+
 void constellation::max_min_axes()
 {
     // Find min/max of constellation for both real and imag axes.
@@ -411,6 +584,13 @@ unsigned int constellation_calcdist::decision_maker(const gr_complex* sample)
     return get_closest_point(sample);
 }
 
+void constellation_calcdist::decision_maker_n(const gr_complex* samples,
+                                              unsigned int* decisions,
+                                              unsigned int nsymbols)
+{
+    get_closest_points(samples, decisions, nsymbols);
+}
+
 
 /********************************************************************/
 
@@ -643,6 +823,15 @@ unsigned int constellation_bpsk::decision_maker(const gr_complex* sample)
     return (real(*sample) > 0);
 }
 
+void constellation_bpsk::decision_maker_n(const gr_complex* samples,
+                                          unsigned int* decisions,
+                                          unsigned int nsymbols)
+{
+    for (unsigned int i = 0; i < nsymbols; i++) {
+        decisions[i] = (real(samples[i]) > 0);
+    }
+}
+
 
 /********************************************************************/
 
@@ -705,6 +894,15 @@ unsigned int constellation_qpsk::decision_maker(const gr_complex* sample)
     */
 }
 
+void constellation_qpsk::decision_maker_n(const gr_complex* samples,
+                                          unsigned int* decisions,
+                                          unsigned int nsymbols)
+{
+    for (unsigned int i = 0; i < nsymbols; i++) {
+        decisions[i] = 2 * (imag(samples[i]) > 0) + (real(samples[i]) > 0);
+    }
+}
+
 
 /********************************************************************/
 
@@ -806,6 +1004,17 @@ unsigned int constellation_8psk::decision_maker(const gr_complex* sample)
     return ret;
 }
 
+void constellation_8psk::decision_maker_n(const gr_complex* samples,
+                                          unsigned int* decisions,
+                                          unsigned int nsymbols)
+{
+    for (unsigned int i = 0; i < nsymbols; i++) {
+        float re = samples[i].real();
+        float im = samples[i].imag();
+        decisions[i] = 4 * (fabsf(re) <= fabsf(im)) + 2 * (im <= 0) + (re <= 0);
+    }
+}
+
 
 /********************************************************************/
 
@@ -935,6 +1144,35 @@ unsigned int constellation_16qam::decision_maker(const gr_complex* sample)
     return ret;
 }
 
+void constellation_16qam::decision_maker_n(const gr_complex* samples,
+                                           unsigned int* decisions,
+                                           unsigned int nsymbols)
+{
+    // The point for each square between the decision boundaries, by imag then real
+    static const unsigned int square_point[4][4] = {
+        { 3, 6, 7, 2 }, { 4, 1, 0, 5 }, { 15, 10, 11, 14 }, { 8, 13, 12, 9 }
+    };
+    const float level = sqrt(float(0.1));
+
+    for (unsigned int i = 0; i < nsymbols; i++) {
+        float re = samples[i].real();
+        float im = samples[i].imag();
+        int col = (re > -2 * level) + (re > 0) + (re > 2 * level);
+        int row = (im > -2 * level) + (im > 0) + (im > 2 * level);
+        decisions[i] = square_point[row][col];
+    }
+
+    // Samples right on a boundary are decided like decision_maker does
+    for (unsigned int i = 0; i < nsymbols; i++) {
+        float re = samples[i].real();
+        float im = samples[i].imag();
+        if (re == 0 || fabsf(re) == 2 * level || im == 0 || fabsf(im) == 2 * level ||
+            std::isnan(re) || std::isnan(im)) {
+            decisions[i] = decision_maker(samples + i);
+        }
+    }
+}
+
 
 } /* namespace digital */
 } /* namespace gr */
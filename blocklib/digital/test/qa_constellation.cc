@@ -0,0 +1,151 @@
+#include <gtest/gtest.h>
+
+#include <gnuradio/digital/constellation.hh>
+
+#include <cmath>
+#include <random>
+
+using namespace gr;
+using namespace gr::digital;
+
+namespace {
+// Random samples around the constellation, and the samples a fast path is most likely
+// to get wrong: the points themselves, the points midway between any two of them
+// (on a decision boundary), the axes with both signed zeros, and far outliers
+std::vector<gr_complex> test_samples(constellation_sptr c)
+{
+    std::vector<gr_complex> samples;
+    auto points = c->points();
+    for (auto& p : points) {
+        samples.push_back(p);
+        samples.push_back(-p);
+        for (auto& q : points) {
+            samples.push_back((p + q) / 2.0f);
+        }
+    }
+
+    for (float x : { -1.0f, -0.5f, -0.0f, 0.0f, 0.5f, 1.0f }) {
+        samples.emplace_back(x, 0.0f);
+        samples.emplace_back(x, -0.0f);
+        samples.emplace_back(0.0f, x);
+        samples.emplace_back(-0.0f, x);
+        samples.emplace_back(x, x);
+        samples.emplace_back(x, -x);
+    }
+    samples.emplace_back(4.0f, -4.0f);
+    samples.emplace_back(-1e-30f, 1e-30f);
+
+    std::mt19937 gen(42);
+    std::normal_distribution<float> dist(0.0f, 0.8f);
+    for (int i = 0; i < 1000; i++) {
+        samples.emplace_back(dist(gen), dist(gen));
+    }
+    return samples;
+}
+
+void check_decisions(constellation_sptr c)
+{
+    auto samples = test_samples(c);
+    unsigned int n = samples.size();
+
+    std::vector<unsigned int> decisions(n);
+    c->decision_maker_n(samples.data(), decisions.data(), n);
+    for (unsigned int i = 0; i < n; i++) {
+        EXPECT_EQ(decisions[i], c->decision_maker(&samples[i])) << samples[i];
+    }
+
+    // Batches not a multiple of the block size, and shorter than one
+    for (unsigned int len : { 1u, 63u, 65u }) {
+        c->decision_maker_n(samples.data() + 1, decisions.data(), len);
+        for (unsigned int i = 0; i < len; i++) {
+            EXPECT_EQ(decisions[i], c->decision_maker(&samples[i + 1])) << samples[i + 1];
+        }
+    }
+}
+
+void check_metrics(constellation_sptr c)
+{
+    auto samples = test_samples(c);
+    unsigned int n = samples.size();
+    unsigned int arity = c->arity();
+
+    std::vector<float> metrics(n * arity);
+    std::vector<float> expected(arity);
+
+    c->calc_metric_n(samples.data(), metrics.data(), n, TRELLIS_EUCLIDEAN);
+    for (unsigned int i = 0; i < n; i++) {
+        c->calc_metric(&samples[i], expected.data(), TRELLIS_EUCLIDEAN);
+        for (unsigned int o = 0; o < arity; o++) {
+            EXPECT_NEAR(metrics[i * arity + o],
+                        expected[o],
+                        1e-6f * std::max(1.0f, std::abs(expected[o])))
+                << samples[i];
+        }
+    }
+
+    c->calc_metric_n(samples.data(), metrics.data(), n, TRELLIS_HARD_SYMBOL);
+    for (unsigned int i = 0; i < n; i++) {
+        c->calc_metric(&samples[i], expected.data(), TRELLIS_HARD_SYMBOL);
+        for (unsigned int o = 0; o < arity; o++) {
+            EXPECT_EQ(metrics[i * arity + o], expected[o]) << samples[i];
+        }
+    }
+
+    EXPECT_THROW(c->calc_metric_n(samples.data(), metrics.data(), n, TRELLIS_HARD_BIT),
+                 std::runtime_error);
+}
+
+void check_soft_decisions(constellation_sptr c)
+{
+    auto samples = test_samples(c);
+    unsigned int n = samples.size();
+    size_t k = c->bits_per_symbol();
+
+    // Computed for each sample without a LUT, then looked up in one
+    for (bool lut : { false, true }) {
+        if (lut) {
+            c->gen_soft_dec_lut(8);
+            ASSERT_TRUE(c->has_soft_dec_lut());
+        }
+
+        std::vector<float> soft(n * k);
+        c->soft_decision_maker_n(samples.data(), soft.data(), n);
+        for (unsigned int i = 0; i < n; i++) {
+            auto expected = c->soft_decision_maker(samples[i]);
+            ASSERT_EQ(expected.size(), k);
+            for (size_t b = 0; b < k; b++) {
+                EXPECT_EQ(soft[i * k + b], expected[b]) << samples[i] << " lut " << lut;
+            }
+        }
+    }
+}
+
+void check_all(constellation_sptr c)
+{
+    check_decisions(c);
+    check_metrics(c);
+    check_soft_decisions(c);
+}
+} // namespace
+
+TEST(ConstellationBatch, BPSK) { check_all(constellation_bpsk::make()); }
+
+TEST(ConstellationBatch, QPSK) { check_all(constellation_qpsk::make()); }
+
+TEST(ConstellationBatch, PSK8) { check_all(constellation_8psk::make()); }
+
+TEST(ConstellationBatch, QAM16) { check_all(constellation_16qam::make()); }
+
+TEST(ConstellationBatch, Calcdist)
+{
+    // Irregular, so only the distance to each point decides
+    std::vector<gr_complex> points{ { 1.0f, 0.2f },
+                                    { -0.7f, 0.9f },
+                                    { -0.3f, -1.1f },
+                                    { 0.6f, -0.4f },
+                                    { 0.0f, 0.0f },
+                                    { 1.5f, 1.5f },
+                                    { -1.4f, 0.1f },
+                                    { 0.2f, 1.3f } };
+    check_all(constellation_calcdist::make(points, { 0, 1, 2, 3, 4, 5, 6, 7 }, 1, 1));
+}
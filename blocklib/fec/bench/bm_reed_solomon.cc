@@ -0,0 +1,172 @@
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <random>
+
+#include <gnuradio/fec/frame_processor.hh>
+#include <gnuradio/fec/reed_solomon.hh>
+
+extern "C" {
+#include <gnuradio/fec/rs.h>
+}
+
+#include "bench_utils.hh"
+
+#include "CLI/App.hpp"
+#include "CLI/Config.hpp"
+#include "CLI/Formatter.hpp"
+
+using namespace gr::fec;
+using namespace gr::bench;
+
+namespace {
+
+constexpr unsigned int n = 255;
+constexpr unsigned int k = 223;
+
+// The CCSDS (255,223) code, one encode_rs_ccsds call per codeword against the
+// batched encoder
+void bm_encode(unsigned long ncodewords, double min_time)
+{
+    std::mt19937 gen(0);
+    std::vector<uint8_t> data(ncodewords * k);
+    for (auto& x : data) {
+        x = gen();
+    }
+    std::vector<uint8_t> codewords(ncodewords * n);
+    reed_solomon rs;
+
+    auto per_codeword = time_per_call(
+        [&] {
+            for (unsigned long c = 0; c < ncodewords; c++) {
+                uint8_t* cw = &codewords[c * n];
+                memcpy(cw, &data[c * k], k);
+                encode_rs_ccsds(cw, cw + k);
+            }
+        },
+        min_time);
+    auto batched = time_per_call(
+        [&] { rs.encode(data.data(), codewords.data(), ncodewords); }, min_time);
+
+    print_row("encode", per_codeword, batched, ncodewords * k * 8);
+}
+
+// Gives every codeword of the buffer nerrors symbol errors
+void corrupt(std::vector<uint8_t>& codewords, double error_rate, int nerrors, std::mt19937& gen)
+{
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    std::uniform_int_distribution<unsigned int> position(0, n - 1);
+    for (size_t c = 0; c < codewords.size() / n; c++) {
+        if (uniform(gen) < error_rate) {
+            for (int e = 0; e < nerrors; e++) {
+                codewords[c * n + position(gen)] ^= 1 + gen() % 255;
+            }
+        }
+    }
+}
+
+// Decoding with the given fraction of codewords carrying nerrors symbol errors each
+void bm_decode(unsigned long ncodewords, double error_rate, int nerrors, double min_time)
+{
+    std::mt19937 gen(1);
+    std::vector<uint8_t> data(ncodewords * k);
+    for (auto& x : data) {
+        x = gen();
+    }
+    std::vector<uint8_t> codewords(ncodewords * n);
+    reed_solomon rs;
+    rs.encode(data.data(), codewords.data(), ncodewords);
+
+    corrupt(codewords, error_rate, nerrors, gen);
+
+    std::vector<uint8_t> scratch(n);
+    std::vector<uint8_t> decoded(ncodewords * k);
+    auto per_codeword = time_per_call(
+        [&] {
+            for (unsigned long c = 0; c < ncodewords; c++) {
+                memcpy(scratch.data(), &codewords[c * n], n);
+                decode_rs_ccsds(scratch.data(), nullptr, 0);
+                memcpy(&decoded[c * k], scratch.data(), k);
+            }
+        },
+        min_time);
+    auto batched = time_per_call(
+        [&] { rs.decode(codewords.data(), decoded.data(), ncodewords); }, min_time);
+
+    char label[64];
+    snprintf(label, sizeof(label), "decode/%.3f/%d", error_rate, nerrors);
+    print_row(label, per_codeword, batched, ncodewords * k * 8);
+}
+
+// The batched decoder on one thread against nthreads of a parallel_frame_processor
+void bm_decode_threads(unsigned long ncodewords,
+                       double error_rate,
+                       int nerrors,
+                       unsigned int nthreads,
+                       double min_time)
+{
+    std::mt19937 gen(2);
+    std::vector<uint8_t> data(ncodewords * k);
+    for (auto& x : data) {
+        x = gen();
+    }
+    std::vector<uint8_t> codewords(ncodewords * n);
+    std::vector<std::unique_ptr<reed_solomon>> rs;
+    for (unsigned int t = 0; t < nthreads; t++) {
+        rs.push_back(std::make_unique<reed_solomon>());
+    }
+    rs[0]->encode(data.data(), codewords.data(), ncodewords);
+    corrupt(codewords, error_rate, nerrors, gen);
+
+    parallel_frame_processor processor(
+        n,
+        k,
+        nthreads,
+        [&](unsigned int thread, const uint8_t* in, uint8_t* out, size_t nframes) {
+            rs[thread]->decode(in, out, nframes);
+        },
+        reed_solomon::group_size);
+
+    std::vector<uint8_t> decoded(ncodewords * k);
+    auto single = time_per_call(
+        [&] { rs[0]->decode(codewords.data(), decoded.data(), ncodewords); }, min_time);
+    auto threaded = time_per_call(
+        [&] { processor.process(codewords.data(), decoded.data(), ncodewords); },
+        min_time);
+
+    char label[64];
+    snprintf(label, sizeof(label), "threads/%.3f/%u", error_rate, nthreads);
+    print_row(label, single, threaded, ncodewords * k * 8);
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    std::vector<double> error_rates = { 0.0, 0.01, 0.1, 1.0 };
+    int nerrors = 8;
+    std::vector<unsigned int> nthreads = { 2, 4 };
+    unsigned long ncodewords = 1024;
+    double min_time = 0.5;
+
+    CLI::App app{ "Reed-Solomon benchmark, per codeword CCSDS codec vs batched" };
+
+    app.add_option("--error_rate", error_rates, "Fractions of codewords with errors");
+    app.add_option("--nerrors", nerrors, "Symbol errors in a codeword with errors");
+    app.add_option("--nthreads", nthreads, "Thread counts for the parallel decoder");
+    app.add_option("--ncodewords", ncodewords, "Codewords per call");
+    app.add_option("--min_time", min_time, "Minimum seconds per measurement");
+
+    CLI11_PARSE(app, argc, argv);
+
+    print_header("per-cw ns", "batched ns", "Mbit/s");
+    bm_encode(ncodewords, min_time);
+    for (auto r : error_rates) {
+        bm_decode(ncodewords, r, nerrors, min_time);
+    }
+    // The first column is one thread of the batched decoder here
+    for (auto t : nthreads) {
+        bm_decode_threads(ncodewords * t, 1.0, nerrors, t, min_time);
+    }
+}
@@ -0,0 +1,100 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2021 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#pragma once
+
+#include <gnuradio/fec/api.h>
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace gr {
+namespace fec {
+
+/*!
+ * \brief Spreads fixed size frames over a pool of worker threads
+ * \ingroup error_coding_blk
+ *
+ * \details
+ * For blocks that work on a stream of whole frames, such as codewords, with
+ * each frame independent of the others.  A call to process() splits the frames
+ * into one contiguous run per thread, the calling thread taking the first, and
+ * returns once all of them are done.  Each run writes the outputs of its own
+ * frames, so the output stays in input order and a block that makes one item
+ * of each frame keeps its tags on the frame boundaries.
+ *
+ * The function given is called with the index of the thread running it, from 0
+ * to nthreads() - 1, so that each thread can keep its own working state.
+ */
+class FEC_API parallel_frame_processor
+{
+public:
+    using process_fn = std::function<void(
+        unsigned int thread, const uint8_t* in, uint8_t* out, size_t nframes)>;
+
+    /*!
+     * \param in_frame_size bytes of each input frame
+     * \param out_frame_size bytes of each output frame
+     * \param nthreads threads to process with, counting the caller
+     * \param fn processes the given frames on the given thread
+     * \param granularity runs are a multiple of this many frames, all but the last
+     */
+    parallel_frame_processor(size_t in_frame_size,
+                             size_t out_frame_size,
+                             unsigned int nthreads,
+                             process_fn fn,
+                             size_t granularity = 1);
+    ~parallel_frame_processor();
+    parallel_frame_processor(const parallel_frame_processor&) = delete;
+    parallel_frame_processor& operator=(const parallel_frame_processor&) = delete;
+
+    unsigned int nthreads() const { return d_nthreads; }
+
+    /*!
+     * \brief Processes \p nframes frames from \p in into \p out, rethrowing the
+     * first exception of any thread.
+     */
+    void process(const uint8_t* in, uint8_t* out, size_t nframes);
+
+private:
+    struct run {
+        const uint8_t* in;
+        uint8_t* out;
+        size_t nframes;
+    };
+
+    size_t d_in_frame_size;
+    size_t d_out_frame_size;
+    unsigned int d_nthreads;
+    process_fn d_fn;
+    size_t d_granularity;
+
+    std::vector<std::thread> d_threads;
+    std::mutex d_mutex;
+    std::condition_variable d_start_cv;
+    std::condition_variable d_done_cv;
+    std::vector<run> d_runs;     // by thread, for the current call
+    uint64_t d_generation = 0;   // counts the calls, to wake the workers
+    unsigned int d_pending = 0;  // workers still busy with the current call
+    std::exception_ptr d_error;
+    bool d_stop = false;
+
+    void worker(unsigned int thread);
+    void run_one(unsigned int thread);
+};
+
+} // namespace fec
+} // namespace gr
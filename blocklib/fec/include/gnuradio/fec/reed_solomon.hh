@@ -0,0 +1,130 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2021 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#pragma once
+
+#include <gnuradio/fec/api.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace gr {
+namespace fec {
+
+/*!
+ * \brief Reed-Solomon codec with 8 bit symbols that works on many codewords per call
+ * \ingroup error_coding_blk
+ *
+ * \details
+ * Codewords are encoded and checked in groups laid out with one symbol of each
+ * codeword side by side, so every multiply by a constant of GF(2^8) covers the
+ * whole group.  The multiplies look up the low and high nibble of each symbol
+ * in two 16 entry tables, 16 or 32 symbols per shuffle instruction where the
+ * build targets SSSE3, AVX2 or NEON.
+ *
+ * Decoding computes the syndromes of the whole group the same way.  Codewords
+ * with all zero syndromes are copied out as they are; only the others go on to
+ * the Berlekamp-Massey, Chien search and Forney steps, one at a time, from the
+ * syndromes already found.
+ *
+ * The defaults are the CCSDS (255,223) code.  A code with n < 255 is the
+ * (255, 255 - n + k) code shortened by 255 - n leading zero symbols.
+ *
+ * An instance keeps its working buffers, so it is not to be shared between
+ * threads.
+ */
+class FEC_API reed_solomon
+{
+public:
+    /*!
+     * \param n codeword length in symbols, at most 255
+     * \param k data symbols per codeword, n - k parity symbols follow them
+     * \param gfpoly field generator polynomial
+     * \param fcr first consecutive root of the code generator polynomial, index form
+     * \param prim primitive element to generate the roots, index form
+     * \param dual_basis symbols are in the CCSDS dual basis representation
+     */
+    reed_solomon(unsigned int n = 255,
+                 unsigned int k = 223,
+                 unsigned int gfpoly = 0x187,
+                 unsigned int fcr = 112,
+                 unsigned int prim = 11,
+                 bool dual_basis = true);
+
+    //! Codewords worked on side by side; calls with a multiple of it go fastest
+    static constexpr size_t group_size = 64;
+
+    unsigned int n() const { return d_n; }
+    unsigned int k() const { return d_k; }
+    unsigned int nroots() const { return d_nroots; }
+
+    /*!
+     * \brief Encodes \p ncodewords blocks of k() symbols from \p data into
+     * codewords of n() symbols in \p codewords, the data followed by the parity.
+     */
+    void encode(const uint8_t* data, uint8_t* codewords, size_t ncodewords);
+
+    /*!
+     * \brief Corrects \p ncodewords codewords of n() symbols from \p codewords and
+     * writes their k() data symbols to \p data.
+     *
+     * The data of a codeword with too many errors is written as received.
+     *
+     * \param nerrors if not null, gets the number of symbols corrected in each
+     *                codeword, or -1 if it could not be corrected
+     * \return the number of codewords that could not be corrected
+     */
+    size_t
+    decode(const uint8_t* codewords, uint8_t* data, size_t ncodewords, int* nerrors = nullptr);
+
+private:
+    // Products with a constant of the 16 low and the 16 high nibble values
+    struct nibble_table {
+        uint8_t lo[16];
+        uint8_t hi[16];
+    };
+
+    unsigned int d_n;
+    unsigned int d_k;
+    unsigned int d_nroots;
+    unsigned int d_pad;
+    unsigned int d_fcr;
+    unsigned int d_iprim;
+    bool d_dual_basis;
+
+    std::vector<uint8_t> d_exp; // antilog table, twice over to skip the modulo
+    std::vector<uint8_t> d_log;
+    std::vector<nibble_table> d_genpoly_tables; // by coefficient of the generator
+    std::vector<nibble_table> d_root_tables;    // by root, for the syndromes
+
+    std::vector<uint8_t> d_feedback;
+    std::vector<uint8_t> d_parity;
+    std::vector<uint8_t> d_symbols;
+    std::vector<uint8_t> d_syndromes;
+
+    // Decoder state for one codeword, in polynomial and in log form
+    std::vector<uint8_t> d_lambda;
+    std::vector<uint8_t> d_t;
+    std::vector<unsigned int> d_s;
+    std::vector<unsigned int> d_reg;
+    std::vector<unsigned int> d_lambda_log;
+    std::vector<unsigned int> d_omega;
+    std::vector<unsigned int> d_root;
+    std::vector<unsigned int> d_loc;
+    std::vector<unsigned int> d_b_log;
+
+    uint8_t multiply(uint8_t a, uint8_t b) const;
+    nibble_table make_table(uint8_t c) const;
+    int decode_one(const uint8_t* syndromes, const uint8_t* codeword, uint8_t* data);
+};
+
+} // namespace fec
+} // namespace gr
@@ -0,0 +1,141 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2021 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#include <gnuradio/fec/frame_processor.hh>
+#include <gnuradio/thread.hh>
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace gr {
+namespace fec {
+
+parallel_frame_processor::parallel_frame_processor(size_t in_frame_size,
+                                                   size_t out_frame_size,
+                                                   unsigned int nthreads,
+                                                   process_fn fn,
+                                                   size_t granularity)
+    : d_in_frame_size(in_frame_size),
+      d_out_frame_size(out_frame_size),
+      d_nthreads(nthreads),
+      d_fn(fn),
+      d_granularity(granularity),
+      d_runs(nthreads)
+{
+    if (nthreads < 1) {
+        throw std::invalid_argument("parallel_frame_processor: nthreads must be at least 1");
+    }
+    if (granularity < 1) {
+        throw std::invalid_argument(
+            "parallel_frame_processor: granularity must be at least 1");
+    }
+
+    // The caller is thread 0
+    for (unsigned int t = 1; t < nthreads; t++) {
+        d_threads.emplace_back(&parallel_frame_processor::worker, this, t);
+        thread::set_thread_name(d_threads.back().native_handle(),
+                                "frame_worker" + std::to_string(t));
+    }
+}
+
+parallel_frame_processor::~parallel_frame_processor()
+{
+    {
+        std::lock_guard<std::mutex> lock(d_mutex);
+        d_stop = true;
+    }
+    d_start_cv.notify_all();
+    for (auto& t : d_threads) {
+        t.join();
+    }
+}
+
+void parallel_frame_processor::run_one(unsigned int thread)
+{
+    auto& r = d_runs[thread];
+    if (r.nframes == 0) {
+        return;
+    }
+    try {
+        d_fn(thread, r.in, r.out, r.nframes);
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(d_mutex);
+        if (!d_error) {
+            d_error = std::current_exception();
+        }
+    }
+}
+
+void parallel_frame_processor::worker(unsigned int thread)
+{
+    uint64_t seen = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(d_mutex);
+            d_start_cv.wait(lock, [&] { return d_stop || d_generation != seen; });
+            if (d_stop) {
+                return;
+            }
+            seen = d_generation;
+        }
+
+        run_one(thread);
+
+        std::lock_guard<std::mutex> lock(d_mutex);
+        if (--d_pending == 0) {
+            d_done_cv.notify_one();
+        }
+    }
+}
+
+void parallel_frame_processor::process(const uint8_t* in, uint8_t* out, size_t nframes)
+{
+    if (nframes == 0) {
+        return;
+    }
+
+    // Runs of whole granules, spread as evenly as they go
+    size_t ngranules = (nframes + d_granularity - 1) / d_granularity;
+    size_t per_thread = ngranules / d_nthreads;
+    size_t extra = ngranules % d_nthreads;
+    size_t start = 0;
+    for (unsigned int t = 0; t < d_nthreads; t++) {
+        size_t n = std::min((per_thread + (t < extra ? 1 : 0)) * d_granularity,
+                            nframes - start);
+        d_runs[t] = { in + start * d_in_frame_size, out + start * d_out_frame_size, n };
+        start += n;
+    }
+
+    // Too little to share, or nobody to share it with
+    if (d_nthreads == 1 || d_runs[1].nframes == 0) {
+        d_fn(0, in, out, nframes);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(d_mutex);
+        d_pending = d_nthreads - 1;
+        d_error = nullptr;
+        d_generation++;
+    }
+    d_start_cv.notify_all();
+
+    run_one(0);
+
+    std::unique_lock<std::mutex> lock(d_mutex);
+    d_done_cv.wait(lock, [&] { return d_pending == 0; });
+    if (d_error) {
+        std::rethrow_exception(d_error);
+    }
+}
+
+} // namespace fec
+} // namespace gr
@@ -0,0 +1,431 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2021 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#include <gnuradio/fec/reed_solomon.hh>
+
+extern "C" {
+#include <gnuradio/fec/rs.h> // dual basis tables
+}
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+#include <stdexcept>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSSE3__)
+#include <tmmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+namespace gr {
+namespace fec {
+
+namespace {
+
+constexpr unsigned int nn = 255;
+
+// out = c * x ^ y over n symbols, c given by its nibble products
+void multiply_xor(const uint8_t* lo,
+                  const uint8_t* hi,
+                  const uint8_t* x,
+                  const uint8_t* y,
+                  uint8_t* out,
+                  size_t n)
+{
+    size_t i = 0;
+#if defined(__AVX2__)
+    const __m256i lo_table =
+        _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(lo)));
+    const __m256i hi_table =
+        _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(hi)));
+    const __m256i mask = _mm256_set1_epi8(0x0f);
+    for (; i + 32 <= n; i += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x + i));
+        __m256i p = _mm256_xor_si256(
+            _mm256_shuffle_epi8(lo_table, _mm256_and_si256(v, mask)),
+            _mm256_shuffle_epi8(hi_table, _mm256_and_si256(_mm256_srli_epi16(v, 4), mask)));
+        p = _mm256_xor_si256(p, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(y + i)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), p);
+    }
+#elif defined(__SSSE3__)
+    const __m128i lo_table = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lo));
+    const __m128i hi_table = _mm_loadu_si128(reinterpret_cast<const __m128i*>(hi));
+    const __m128i mask = _mm_set1_epi8(0x0f);
+    for (; i + 16 <= n; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(x + i));
+        __m128i p =
+            _mm_xor_si128(_mm_shuffle_epi8(lo_table, _mm_and_si128(v, mask)),
+                          _mm_shuffle_epi8(hi_table, _mm_and_si128(_mm_srli_epi16(v, 4), mask)));
+        p = _mm_xor_si128(p, _mm_loadu_si128(reinterpret_cast<const __m128i*>(y + i)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), p);
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    const uint8x16_t lo_table = vld1q_u8(lo);
+    const uint8x16_t hi_table = vld1q_u8(hi);
+    const uint8x16_t mask = vdupq_n_u8(0x0f);
+    for (; i + 16 <= n; i += 16) {
+        uint8x16_t v = vld1q_u8(x + i);
+        uint8x16_t p = veorq_u8(vqtbl1q_u8(lo_table, vandq_u8(v, mask)),
+                                vqtbl1q_u8(hi_table, vshrq_n_u8(v, 4)));
+        vst1q_u8(out + i, veorq_u8(p, vld1q_u8(y + i)));
+    }
+#endif
+    for (; i < n; i++) {
+        out[i] = lo[x[i] & 0x0f] ^ hi[x[i] >> 4] ^ y[i];
+    }
+}
+
+} // namespace
+
+reed_solomon::reed_solomon(unsigned int n,
+                           unsigned int k,
+                           unsigned int gfpoly,
+                           unsigned int fcr,
+                           unsigned int prim,
+                           bool dual_basis)
+    : d_n(n),
+      d_k(k),
+      d_nroots(n - k),
+      d_pad(nn - n),
+      d_fcr(fcr),
+      d_dual_basis(dual_basis),
+      d_exp(2 * nn),
+      d_log(nn + 1)
+{
+    if (n > nn || k == 0 || k >= n) {
+        throw std::invalid_argument("reed_solomon: need 0 < k < n <= 255");
+    }
+    if (fcr > nn || prim == 0 || prim >= nn || std::gcd(prim, nn) != 1) {
+        throw std::invalid_argument("reed_solomon: invalid fcr or prim");
+    }
+
+    // Galois field tables
+    d_log[0] = nn;
+    unsigned int sr = 1;
+    for (unsigned int i = 0; i < nn; i++) {
+        d_log[sr] = i;
+        d_exp[i] = d_exp[i + nn] = sr;
+        sr <<= 1;
+        if (sr & 0x100) {
+            sr ^= gfpoly;
+        }
+        sr &= nn;
+    }
+    if (sr != 1) {
+        throw std::invalid_argument("reed_solomon: gfpoly is not primitive");
+    }
+
+    // Generator polynomial from its roots, and the roots themselves
+    std::vector<uint8_t> genpoly(d_nroots + 1, 0);
+    genpoly[0] = 1;
+    for (unsigned int i = 0; i < d_nroots; i++) {
+        uint8_t root = d_exp[((fcr + i) * prim) % nn];
+        d_root_tables.push_back(make_table(root));
+        for (unsigned int j = i + 1; j > 0; j--) {
+            genpoly[j] = genpoly[j - 1] ^ multiply(genpoly[j], root);
+        }
+        genpoly[0] = multiply(genpoly[0], root);
+    }
+    for (unsigned int j = 0; j < d_nroots; j++) {
+        d_genpoly_tables.push_back(make_table(genpoly[j]));
+    }
+
+    // prim * iprim = 1 mod 255, to step through the codeword positions
+    d_iprim = 1;
+    while (d_iprim % prim != 0) {
+        d_iprim += nn;
+    }
+    d_iprim /= prim;
+
+    d_feedback.resize(group_size);
+    d_parity.resize(d_nroots * group_size);
+    d_symbols.resize(d_n * group_size);
+    d_syndromes.resize(d_nroots * group_size);
+    d_lambda.resize(d_nroots + 1);
+    d_t.resize(d_nroots + 1);
+    d_s.resize(d_nroots);
+    d_reg.resize(d_nroots + 1);
+    d_lambda_log.resize(d_nroots + 1);
+    d_omega.resize(d_nroots + 1);
+    d_root.resize(d_nroots);
+    d_loc.resize(d_nroots);
+    d_b_log.resize(d_nroots + 1);
+}
+
+uint8_t reed_solomon::multiply(uint8_t a, uint8_t b) const
+{
+    if (a == 0 || b == 0) {
+        return 0;
+    }
+    return d_exp[d_log[a] + d_log[b]];
+}
+
+reed_solomon::nibble_table reed_solomon::make_table(uint8_t c) const
+{
+    nibble_table t;
+    for (unsigned int i = 0; i < 16; i++) {
+        t.lo[i] = multiply(c, i);
+        t.hi[i] = multiply(c, i << 4);
+    }
+    return t;
+}
+
+void reed_solomon::encode(const uint8_t* data, uint8_t* codewords, size_t ncodewords)
+{
+    auto fb = d_feedback.data();
+
+    for (size_t c0 = 0; c0 < ncodewords; c0 += group_size) {
+        size_t m = std::min(group_size, ncodewords - c0);
+        const uint8_t* in = data + c0 * d_k;
+        uint8_t* out = codewords + c0 * d_n;
+
+        // The parity shift register of each codeword, kept as a ring of rows so
+        // shifting is moving the head
+        std::fill(d_parity.begin(), d_parity.end(), 0);
+        std::fill(d_feedback.begin(), d_feedback.end(), 0);
+        unsigned int head = 0;
+        for (unsigned int i = 0; i < d_k; i++) {
+            uint8_t* first = &d_parity[head * group_size];
+            for (size_t c = 0; c < m; c++) {
+                uint8_t s = in[c * d_k + i];
+                fb[c] = (d_dual_basis ? Tal1tab[s] : s) ^ first[c];
+            }
+            std::fill(first, first + group_size, 0);
+
+            for (unsigned int j = 0; j < d_nroots; j++) {
+                uint8_t* row = &d_parity[((head + 1 + j) % d_nroots) * group_size];
+                const auto& t = d_genpoly_tables[d_nroots - 1 - j];
+                multiply_xor(t.lo, t.hi, fb, row, row, group_size);
+            }
+            head = (head + 1) % d_nroots;
+        }
+
+        for (size_t c = 0; c < m; c++) {
+            memcpy(out + c * d_n, in + c * d_k, d_k);
+            uint8_t* parity = out + c * d_n + d_k;
+            for (unsigned int j = 0; j < d_nroots; j++) {
+                uint8_t s = d_parity[((head + j) % d_nroots) * group_size + c];
+                parity[j] = d_dual_basis ? Taltab[s] : s;
+            }
+        }
+    }
+}
+
+size_t reed_solomon::decode(const uint8_t* codewords,
+                            uint8_t* data,
+                            size_t ncodewords,
+                            int* nerrors)
+{
+    size_t nfailed = 0;
+
+    for (size_t c0 = 0; c0 < ncodewords; c0 += group_size) {
+        size_t m = std::min(group_size, ncodewords - c0);
+        const uint8_t* in = codewords + c0 * d_n;
+        uint8_t* out = data + c0 * d_k;
+
+        // Symbol i of every codeword in row i
+        if (m < group_size) {
+            std::fill(d_symbols.begin(), d_symbols.end(), 0);
+        }
+        for (size_t c = 0; c < m; c++) {
+            for (unsigned int i = 0; i < d_n; i++) {
+                uint8_t s = in[c * d_n + i];
+                d_symbols[i * group_size + c] = d_dual_basis ? Tal1tab[s] : s;
+            }
+        }
+
+        // The codeword polynomials at the roots of the generator, by Horner's rule
+        for (unsigned int r = 0; r < d_nroots; r++) {
+            uint8_t* syn = &d_syndromes[r * group_size];
+            const auto& t = d_root_tables[r];
+            memcpy(syn, d_symbols.data(), group_size);
+            for (unsigned int i = 1; i < d_n; i++) {
+                multiply_xor(t.lo, t.hi, syn, &d_symbols[i * group_size], syn, group_size);
+            }
+        }
+
+        uint8_t any_error[group_size] = {};
+        for (unsigned int r = 0; r < d_nroots; r++) {
+            const uint8_t* syn = &d_syndromes[r * group_size];
+            for (size_t c = 0; c < group_size; c++) {
+                any_error[c] |= syn[c];
+            }
+        }
+
+        for (size_t c = 0; c < m; c++) {
+            int count = 0;
+            if (any_error[c]) {
+                count = decode_one(&d_syndromes[c], in + c * d_n, out + c * d_k);
+            }
+            if (count <= 0) {
+                memcpy(out + c * d_k, in + c * d_n, d_k);
+            }
+            if (count < 0) {
+                nfailed++;
+            }
+            if (nerrors) {
+                nerrors[c0 + c] = count;
+            }
+        }
+    }
+
+    return nfailed;
+}
+
+// Berlekamp-Massey, Chien search and Forney for one codeword, from the syndromes
+// found for its group.  As decode_rs_char, less the erasures
+int reed_solomon::decode_one(const uint8_t* syndromes, const uint8_t* codeword, uint8_t* data)
+{
+    const unsigned int a0 = nn; // log of zero
+    const unsigned int nroots = d_nroots;
+    auto modnn = [](unsigned int x) { return x % nn; };
+
+    uint8_t* lambda = d_lambda.data();
+    uint8_t* t = d_t.data();
+    unsigned int* s = d_s.data();
+    unsigned int* reg = d_reg.data();
+    unsigned int* lambda_log = d_lambda_log.data();
+    unsigned int* omega = d_omega.data();
+    unsigned int* root = d_root.data();
+    unsigned int* loc = d_loc.data();
+    unsigned int* b_log = d_b_log.data();
+
+    for (unsigned int i = 0; i < nroots; i++) {
+        s[i] = d_log[syndromes[i * group_size]];
+    }
+
+    std::fill(lambda, lambda + nroots + 1, 0);
+    lambda[0] = 1;
+    for (unsigned int i = 0; i <= nroots; i++) {
+        b_log[i] = d_log[lambda[i]];
+    }
+
+    // The error locator polynomial
+    unsigned int el = 0;
+    for (unsigned int r = 1; r <= nroots; r++) {
+        uint8_t discr = 0;
+        for (unsigned int i = 0; i < r; i++) {
+            if (lambda[i] != 0 && s[r - i - 1] != a0) {
+                discr ^= d_exp[d_log[lambda[i]] + s[r - i - 1]];
+            }
+        }
+        if (discr == 0) {
+            memmove(&b_log[1], b_log, nroots * sizeof(b_log[0]));
+            b_log[0] = a0;
+            continue;
+        }
+        unsigned int discr_log = d_log[discr];
+        t[0] = lambda[0];
+        for (unsigned int i = 0; i < nroots; i++) {
+            t[i + 1] =
+                b_log[i] != a0 ? lambda[i + 1] ^ d_exp[discr_log + b_log[i]] : lambda[i + 1];
+        }
+        if (2 * el <= r - 1) {
+            el = r - el;
+            for (unsigned int i = 0; i <= nroots; i++) {
+                b_log[i] = lambda[i] == 0 ? a0 : modnn(d_log[lambda[i]] + nn - discr_log);
+            }
+        } else {
+            memmove(&b_log[1], b_log, nroots * sizeof(b_log[0]));
+            b_log[0] = a0;
+        }
+        std::copy(t, t + nroots + 1, lambda);
+    }
+
+    unsigned int deg_lambda = 0;
+    for (unsigned int i = 0; i <= nroots; i++) {
+        lambda_log[i] = d_log[lambda[i]];
+        if (lambda_log[i] != a0) {
+            deg_lambda = i;
+        }
+    }
+
+    // Its roots, the error locations; positions in the padding are not in the codeword
+    std::copy(lambda_log + 1, lambda_log + nroots + 1, reg + 1);
+    unsigned int count = 0;
+    for (unsigned int i = 1, k = d_iprim - 1; i <= nn; i++, k = modnn(k + d_iprim)) {
+        uint8_t q = 1;
+        for (unsigned int j = deg_lambda; j > 0; j--) {
+            if (reg[j] != a0) {
+                reg[j] = modnn(reg[j] + j);
+                q ^= d_exp[reg[j]];
+            }
+        }
+        if (q != 0) {
+            continue;
+        }
+        if (k < d_pad) {
+            return -1;
+        }
+        root[count] = i;
+        loc[count] = k - d_pad;
+        if (++count == deg_lambda) {
+            break;
+        }
+    }
+    if (count != deg_lambda) {
+        return -1;
+    }
+
+    // The error evaluator polynomial, s(x) lambda(x) mod x^nroots
+    unsigned int deg_omega = 0;
+    for (unsigned int i = 0; i < nroots; i++) {
+        uint8_t tmp = 0;
+        for (int j = std::min(deg_lambda, i); j >= 0; j--) {
+            if (s[i - j] != a0 && lambda_log[j] != a0) {
+                tmp ^= d_exp[s[i - j] + lambda_log[j]];
+            }
+        }
+        if (tmp != 0) {
+            deg_omega = i;
+        }
+        omega[i] = d_log[tmp];
+    }
+
+    for (unsigned int i = 0; i < d_k; i++) {
+        data[i] = d_dual_basis ? Tal1tab[codeword[i]] : codeword[i];
+    }
+
+    // The error values by Forney's formula
+    for (unsigned int j = 0; j < count; j++) {
+        uint8_t num1 = 0;
+        for (int i = deg_omega; i >= 0; i--) {
+            if (omega[i] != a0) {
+                num1 ^= d_exp[modnn(omega[i] + i * root[j])];
+            }
+        }
+        uint8_t num2 = d_exp[modnn(root[j] * (d_fcr + nn - 1))];
+        uint8_t den = 0;
+        for (int i = std::min(deg_lambda, nroots - 1) & ~1; i >= 0; i -= 2) {
+            if (lambda_log[i + 1] != a0) {
+                den ^= d_exp[modnn(lambda_log[i + 1] + i * root[j])];
+            }
+        }
+        if (den == 0) {
+            return -1;
+        }
+        if (num1 != 0 && loc[j] < d_k) {
+            data[loc[j]] ^= d_exp[modnn(d_log[num1] + d_log[num2] + nn - d_log[den])];
+        }
+    }
+
+    if (d_dual_basis) {
+        for (unsigned int i = 0; i < d_k; i++) {
+            data[i] = Taltab[data[i]];
+        }
+    }
+    return count;
+}
+
+} // namespace fec
+} // namespace gr
@@ -0,0 +1,51 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2021 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#include "rs_decoder_cpu.hh"
+#include "rs_decoder_cpu_gen.hh"
+
+namespace gr {
+namespace fec {
+
+rs_decoder_cpu::rs_decoder_cpu(const block_args& args)
+    : sync_block("rs_decoder"),
+      rs_decoder(args),
+      d_processor(
+          args.n,
+          args.k,
+          args.nthreads,
+          [this](unsigned int thread, const uint8_t* in, uint8_t* out, size_t nframes) {
+              d_rs[thread]->decode(in, out, nframes);
+          },
+          reed_solomon::group_size)
+{
+    for (unsigned int t = 0; t < args.nthreads; t++) {
+        d_rs.push_back(std::make_unique<reed_solomon>(
+            args.n, args.k, args.gfpoly, args.fcr, args.prim, args.dual_basis));
+    }
+}
+
+work_return_code_t rs_decoder_cpu::work(std::vector<block_work_input_sptr>& work_input,
+                                        std::vector<block_work_output_sptr>& work_output)
+{
+    auto in = work_input[0]->items<uint8_t>();
+    auto out = work_output[0]->items<uint8_t>();
+    auto noutput_items = work_output[0]->n_items;
+
+    // Each item is a whole codeword in, its data out.  Codewords with too many
+    // errors pass their data through as received.
+    d_processor.process(in, out, noutput_items);
+
+    work_output[0]->n_produced = noutput_items;
+    return work_return_code_t::WORK_OK;
+}
+
+} // namespace fec
+} // namespace gr
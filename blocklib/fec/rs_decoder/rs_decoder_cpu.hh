@@ -0,0 +1,25 @@
+#pragma once
+
+#include <gnuradio/fec/frame_processor.hh>
+#include <gnuradio/fec/reed_solomon.hh>
+#include <gnuradio/fec/rs_decoder.hh>
+
+#include <memory>
+
+namespace gr {
+namespace fec {
+
+class rs_decoder_cpu : public rs_decoder
+{
+public:
+    rs_decoder_cpu(const block_args& args);
+    virtual work_return_code_t work(std::vector<block_work_input_sptr>& work_input,
+                                    std::vector<block_work_output_sptr>& work_output) override;
+
+private:
+    std::vector<std::unique_ptr<reed_solomon>> d_rs; // one per thread
+    parallel_frame_processor d_processor;
+};
+
+} // namespace fec
+} // namespace gr
@@ -0,0 +1,39 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2021 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#include "rs_encoder_cpu.hh"
+#include "rs_encoder_cpu_gen.hh"
+
+namespace gr {
+namespace fec {
+
+rs_encoder_cpu::rs_encoder_cpu(const block_args& args)
+    : sync_block("rs_encoder"),
+      rs_encoder(args),
+      d_rs(args.n, args.k, args.gfpoly, args.fcr, args.prim, args.dual_basis)
+{
+}
+
+work_return_code_t rs_encoder_cpu::work(std::vector<block_work_input_sptr>& work_input,
+                                        std::vector<block_work_output_sptr>& work_output)
+{
+    auto in = work_input[0]->items<uint8_t>();
+    auto out = work_output[0]->items<uint8_t>();
+    auto noutput_items = work_output[0]->n_items;
+
+    // Each item is a whole block of data in, a whole codeword out
+    d_rs.encode(in, out, noutput_items);
+
+    work_output[0]->n_produced = noutput_items;
+    return work_return_code_t::WORK_OK;
+}
+
+} // namespace fec
+} // namespace gr
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <gnuradio/fec/reed_solomon.hh>
+#include <gnuradio/fec/rs_encoder.hh>
+
+namespace gr {
+namespace fec {
+
+class rs_encoder_cpu : public rs_encoder
+{
+public:
+    rs_encoder_cpu(const block_args& args);
+    virtual work_return_code_t work(std::vector<block_work_input_sptr>& work_input,
+                                    std::vector<block_work_output_sptr>& work_output) override;
+
+private:
+    reed_solomon d_rs;
+};
+
+} // namespace fec
+} // namespace gr
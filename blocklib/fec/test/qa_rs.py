@@ -0,0 +1,163 @@
+#!/usr/bin/env python3
+#
+# Copyright 2021 Free Software Foundation, Inc.
+#
+# This file is part of GNU Radio
+#
+# SPDX-License-Identifier: GPL-3.0-or-later
+#
+#
+
+
+from newsched import gr, gr_unittest, fec, blocks
+import random
+
+
+def reference_encode(data, nroots, gfpoly, fcr, prim):
+    # Conventional basis systematic encoder, one codeword at a time
+    exp = [0] * 510
+    log = [0] * 256
+    sr = 1
+    for i in range(255):
+        log[sr] = i
+        exp[i] = exp[i + 255] = sr
+        sr <<= 1
+        if sr & 0x100:
+            sr ^= gfpoly
+        sr &= 0xff
+
+    def mul(a, b):
+        return 0 if a == 0 or b == 0 else exp[log[a] + log[b]]
+
+    genpoly = [1] + [0] * nroots
+    for i in range(nroots):
+        root = exp[((fcr + i) * prim) % 255]
+        for j in range(i + 1, 0, -1):
+            genpoly[j] = genpoly[j - 1] ^ mul(genpoly[j], root)
+        genpoly[0] = mul(genpoly[0], root)
+
+    parity = [0] * nroots
+    for s in data:
+        fb = s ^ parity[0]
+        parity = parity[1:] + [0]
+        for j in range(nroots):
+            parity[j] ^= mul(fb, genpoly[nroots - 1 - j])
+    return list(data) + parity
+
+
+def dual_basis_tables():
+    # Conventional to CCSDS dual basis and back, as gen_ccsds_tal
+    tal = [0x8d, 0xef, 0xec, 0x86, 0xfa, 0x99, 0xaf, 0x7b]
+    taltab = [0] * 256
+    tal1tab = [0] * 256
+    for i in range(256):
+        for j in range(8):
+            for k in range(8):
+                if i & (1 << k):
+                    taltab[i] ^= tal[7 - k] & (1 << j)
+        tal1tab[taltab[i]] = i
+    return taltab, tal1tab
+
+
+class test_rs(gr_unittest.TestCase):
+
+    def setUp(self):
+        random.seed(0)
+        self.tb = gr.flowgraph()
+
+    def tearDown(self):
+        self.tb = None
+
+    def run_block(self, src_data, op, vlen_in, vlen_out):
+        tb = gr.flowgraph()
+        src = blocks.vector_source_b(src_data, False, vlen_in)
+        dst = blocks.vector_sink_b(vlen_out)
+        tb.connect(src, 0, op, 0)
+        tb.connect(op, 0, dst, 0)
+        tb.run()
+        return list(dst.data())
+
+    def corrupt(self, codewords, n, nerrors):
+        out = list(codewords)
+        for c in range(len(codewords) // n):
+            for pos in random.sample(range(n), nerrors):
+                out[c * n + pos] ^= random.randint(1, 255)
+        return out
+
+    def test_encode_reference(self):
+        # DVB (204,188), shortened from the (255,239) code
+        n, k = 204, 188
+        params = dict(n=n, k=k, gfpoly=0x11d, fcr=0, prim=1, dual_basis=False)
+        ncodewords = 100
+        src_data = [random.randint(0, 255) for _ in range(ncodewords * k)]
+
+        expected = []
+        for c in range(ncodewords):
+            expected += reference_encode(src_data[c * k:(c + 1) * k],
+                                         n - k, 0x11d, 0, 1)
+
+        result = self.run_block(src_data, fec.rs_encoder(**params), k, n)
+        self.assertEqual(result, expected)
+
+    def test_ccsds_roundtrip(self):
+        n, k = 255, 223
+        ncodewords = 150
+        src_data = [random.randint(0, 255) for _ in range(ncodewords * k)]
+
+        # The code works in the conventional basis, the symbols are in the dual basis
+        taltab, tal1tab = dual_basis_tables()
+        expected = []
+        for c in range(ncodewords):
+            data = src_data[c * k:(c + 1) * k]
+            codeword = reference_encode([tal1tab[s] for s in data], n - k, 0x187, 112, 11)
+            expected += data + [taltab[s] for s in codeword[k:]]
+
+        encoded = self.run_block(src_data, fec.rs_encoder(), k, n)
+        self.assertEqual(encoded, expected)
+
+        # Up to (n - k) / 2 symbol errors per codeword are corrected
+        received = self.corrupt(encoded, n, (n - k) // 2)
+        result = self.run_block(received, fec.rs_decoder(), n, k)
+        self.assertEqual(result, src_data)
+
+    def test_uncorrectable(self):
+        n, k = 255, 223
+        ncodewords = 100
+        src_data = [random.randint(0, 255) for _ in range(ncodewords * k)]
+
+        # Too many errors to correct, so the data goes out as received
+        encoded = self.run_block(src_data, fec.rs_encoder(), k, n)
+        received = self.corrupt(encoded, n, (n - k) // 2 + 4)
+        result = self.run_block(received, fec.rs_decoder(), n, k)
+
+        expected = []
+        for c in range(ncodewords):
+            expected += received[c * n:c * n + k]
+        self.assertEqual(result, expected)
+        self.assertNotEqual(result, src_data)
+
+    def test_shortened_roundtrip(self):
+        n, k = 60, 44
+        params = dict(n=n, k=k, gfpoly=0x11d, fcr=0, prim=1, dual_basis=False)
+        ncodewords = 200
+        src_data = [random.randint(0, 255) for _ in range(ncodewords * k)]
+
+        encoded = self.run_block(src_data, fec.rs_encoder(**params), k, n)
+        received = self.corrupt(encoded, n, random.randint(0, (n - k) // 2))
+        result = self.run_block(received, fec.rs_decoder(**params), n, k)
+        self.assertEqual(result, src_data)
+
+    def test_threaded_decoder(self):
+        n, k = 255, 223
+        ncodewords = 1000
+        src_data = [random.randint(0, 255) for _ in range(ncodewords * k)]
+
+        encoded = self.run_block(src_data, fec.rs_encoder(), k, n)
+        received = self.corrupt(encoded, n, (n - k) // 2)
+        # The threads each decode a run of the codewords, put back in order
+        result = self.run_block(received, fec.rs_decoder(nthreads=4), n, k)
+        self.assertEqual(result, src_data)
+
+
+if __name__ == '__main__':
+    gr_unittest.run(test_rs)
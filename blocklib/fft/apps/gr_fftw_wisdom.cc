@@ -0,0 +1,69 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2021 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+// Plans FFTs ahead of time so the wisdom file has them when flowgraphs start, e.g.
+//   gr_fftw_wisdom --sizes 64 1024 4096 --batches 1 128 --effort patient
+
+#include <iostream>
+#include <map>
+
+#include <gnuradio/fft/fftw_fft.hh>
+
+#include "CLI/App.hpp"
+#include "CLI/Config.hpp"
+#include "CLI/Formatter.hpp"
+
+using namespace gr::fft;
+
+int main(int argc, char* argv[])
+{
+    std::vector<int> sizes;
+    std::vector<int> batches = { 1 };
+    std::string effort = "patient";
+    int nthreads = 1;
+    bool complex_only = false;
+
+    CLI::App app{ "Generate FFTW wisdom for the given transform sizes" };
+
+    app.add_option("-s,--sizes", sizes, "FFT sizes")->required();
+    app.add_option("-b,--batches", batches, "Number of transforms per plan");
+    app.add_option("-e,--effort", effort, "measure, patient or exhaustive");
+    app.add_option("-t,--nthreads", nthreads, "Number of FFTW threads");
+    app.add_flag("--complex-only", complex_only, "Skip the real transforms");
+
+    CLI11_PARSE(app, argc, argv);
+
+    const std::map<std::string, planner_effort> efforts = {
+        { "measure", planner_effort::MEASURE },
+        { "patient", planner_effort::PATIENT },
+        { "exhaustive", planner_effort::EXHAUSTIVE }
+    };
+    auto it = efforts.find(effort);
+    if (it == efforts.end()) {
+        std::cerr << "Unknown planner effort: " << effort << std::endl;
+        return 1;
+    }
+    planner::set_effort(it->second);
+
+    // Each plan not in the wisdom yet is added to the wisdom file as it is made
+    for (auto batch : batches) {
+        for (auto size : sizes) {
+            std::cout << "planning " << size << " x " << batch << std::endl;
+            fft_complex_fwd cfwd(size, nthreads, batch);
+            fft_complex_rev crev(size, nthreads, batch);
+            if (!complex_only) {
+                fft_real_fwd rfwd(size, nthreads, batch);
+                fft_real_rev rrev(size, nthreads, batch);
+            }
+        }
+    }
+
+    return 0;
+}
@@ -1,16 +1,43 @@
 #include "fft_cpu.hh"
 #include "fft_cpu_gen.hh"
 
+#include <volk/volk.h>
+#include <cmath>
+#include <type_traits>
+
 namespace gr {
 namespace fft {
 
+namespace {
+// Items transformed per batched plan execution
+constexpr size_t fft_batch_items = 8192;
+
+int batch_size(size_t fft_size) { return std::max((size_t)1, fft_batch_items / fft_size); }
+
+// x[n] * exp(j 2 pi n s / N) moves bin k of the transform to bin k + s.  For even N
+// and s = N / 2 it is exactly (-1)^n
+volk::vector<gr_complex> modulation(size_t fft_size, size_t s, int sign)
+{
+    volk::vector<gr_complex> m(fft_size);
+    for (size_t n = 0; n < fft_size; n++) {
+        if (2 * s == fft_size) {
+            m[n] = n % 2 ? -1.0f : 1.0f;
+        } else {
+            m[n] = std::polar(1.0, sign * 2.0 * M_PI * ((n * s) % fft_size) / fft_size);
+        }
+    }
+    return m;
+}
+} // namespace
+
 template <class T, bool forward>
 fft_cpu<T, forward>::fft_cpu(const typename fft<T, forward>::block_args& args) 
     : sync_block("fft"),
       fft<T, forward>(args),
       d_fft_size(args.fft_size),
       d_shift(args.shift),
-      d_fft(args.fft_size)
+      d_fft(args.fft_size),
+      d_batch_fft(args.fft_size, 1, batch_size(args.fft_size))
 {
     if (args.window.empty() || args.window.size() == d_fft_size) {
         d_window = args.window;
@@ -18,12 +45,36 @@ fft_cpu<T, forward>::fft_cpu(const typename fft<T, forward>::block_args& args)
         throw std::runtime_error("fft: window not the same length as fft_size");
     }
 
+    // The forward shift swaps the halves of the output, the reverse one those of
+    // the input.  Both are a modulation by half the transform: before it on the
+    // forward side, and after it on the reverse side.  The window is applied to the
+    // input as given.
+    volk::vector<gr_complex> shift;
+    if (d_shift) {
+        shift = modulation(d_fft_size, d_fft_size / 2, forward ? 1 : -1);
+    }
+
+    if (!d_window.empty() || (forward && d_shift)) {
+        d_premultiply = volk::vector<gr_complex>(d_fft_size, 1.0f);
+        for (size_t n = 0; n < d_fft_size; n++) {
+            if (!d_window.empty()) {
+                d_premultiply[n] *= d_window[n];
+            }
+            if (forward && d_shift) {
+                d_premultiply[n] *= shift[n];
+            }
+        }
+    }
+    if (!forward && d_shift) {
+        d_postmultiply = shift;
+    }
 }
 
 template <class T, bool forward>
 void fft_cpu<T, forward>::set_nthreads(int n)
 {
     d_fft.set_nthreads(n);
+    d_batch_fft.set_nthreads(n);
 }
 
 template <class T, bool forward>
@@ -32,124 +83,48 @@ int fft_cpu<T, forward>::nthreads() const
     return d_fft.nthreads();
 }
 
-template <>
-void fft_cpu<gr_complex, true>::fft_and_shift(const gr_complex* in, gr_complex* out)
-{
-    if (!d_window.empty()) {
-        gr_complex* dst = d_fft.get_inbuf();
-        volk_32fc_32f_multiply_32fc(&dst[0], in, &d_window[0], d_fft_size);
-    } else {
-        memcpy(d_fft.get_inbuf(), in, sizeof(gr_complex) * d_fft_size);
-    }
-    d_fft.execute();
-    if (d_shift) {
-        unsigned int len = (unsigned int)(ceil(d_fft_size / 2.0));
-        memcpy(
-            &out[0], &d_fft.get_outbuf()[len], sizeof(gr_complex) * (d_fft_size - len));
-        memcpy(&out[d_fft_size - len], &d_fft.get_outbuf()[0], sizeof(gr_complex) * len);
-    } else {
-
-        memcpy(out, d_fft.get_outbuf(), sizeof(gr_complex) * d_fft_size);
-    }
-}
-
-template <>
-void fft_cpu<gr_complex, false>::fft_and_shift(const gr_complex* in, gr_complex* out)
+template <class T, bool forward>
+void fft_cpu<T, forward>::transform(fftw_fft<gr_complex, forward>& fft,
+                                    const T* in,
+                                    gr_complex* out,
+                                    size_t nvectors)
 {
-    if (!d_window.empty()) {
-        gr_complex* dst = d_fft.get_inbuf();
-        if (d_shift) {
-            unsigned int offset = d_fft_size / 2;
-            int fft_m_offset = d_fft_size - offset;
-            volk_32fc_32f_multiply_32fc(&dst[fft_m_offset], &in[0], &d_window[0], offset);
-            volk_32fc_32f_multiply_32fc(
-                &dst[0], &in[offset], &d_window[offset], d_fft_size - offset);
+    // Complex input with nothing to apply is transformed straight out of the input
+    // buffer, anything else is written to the plan's input buffer on the way
+    const gr_complex* src = fft.get_inbuf();
+    if constexpr (std::is_same<T, gr_complex>::value) {
+        if (d_premultiply.empty()) {
+            src = in;
         } else {
-            volk_32fc_32f_multiply_32fc(&dst[0], in, &d_window[0], d_fft_size);
-        }
-    } else {
-        if (d_shift) { // apply an ifft shift on the data
-            gr_complex* dst = d_fft.get_inbuf();
-            unsigned int len =
-                (unsigned int)(floor(d_fft_size / 2.0)); // half length of complex array
-            memcpy(&dst[0], &in[len], sizeof(gr_complex) * (d_fft_size - len));
-            memcpy(&dst[d_fft_size - len], &in[0], sizeof(gr_complex) * len);
-        } else {
-            memcpy(d_fft.get_inbuf(), in, sizeof(gr_complex) * d_fft_size);
-        }
-    }
-    d_fft.execute();
-    memcpy(out, d_fft.get_outbuf(), sizeof(gr_complex) * d_fft_size);
-}
-
-template <>
-void fft_cpu<float, true>::fft_and_shift(const float* in, gr_complex* out)
-{
-    // copy input into optimally aligned buffer
-    if (!d_window.empty()) {
-        gr_complex* dst = d_fft.get_inbuf();
-        for (unsigned int i = 0; i < d_fft_size; i++) // apply window
-            dst[i] = in[i] * d_window[i];
-    } else {
-        gr_complex* dst = d_fft.get_inbuf();
-        for (unsigned int i = 0; i < d_fft_size; i++) // float to complex conversion
-            dst[i] = in[i];
-    }
-
-    d_fft.execute();
-    if (d_shift) {
-        unsigned int len = (unsigned int)(ceil(d_fft_size / 2.0));
-        memcpy(
-            &out[0], &d_fft.get_outbuf()[len], sizeof(gr_complex) * (d_fft_size - len));
-        memcpy(&out[d_fft_size - len], &d_fft.get_outbuf()[0], sizeof(gr_complex) * len);
-    } else {
-
-        memcpy(out, d_fft.get_outbuf(), sizeof(gr_complex) * d_fft_size);
-    }
-}
-
-template <>
-void fft_cpu<float, false>::fft_and_shift(const float* in, gr_complex* out)
-{
-    // copy input into optimally aligned buffer
-    if (!d_window.empty()) {
-        gr_complex* dst = d_fft.get_inbuf();
-        if (d_shift) {
-            unsigned int len =
-                (unsigned int)(floor(d_fft_size / 2.0)); // half length of complex array
-            for (unsigned int i = 0; i < len; i++) {
-                dst[i] = in[len + i] * d_window[len + i];
+            for (size_t v = 0; v < nvectors; v++) {
+                volk_32fc_x2_multiply_32fc(fft.get_inbuf() + v * d_fft_size,
+                                           in + v * d_fft_size,
+                                           d_premultiply.data(),
+                                           d_fft_size);
             }
-            for (unsigned int i = len; i < d_fft_size; i++) {
-                dst[i] = in[i - len] * d_window[i - len];
-            }
-        } else {
-            for (unsigned int i = 0; i < d_fft_size; i++) // apply window
-                dst[i] = in[i] * d_window[i];
         }
-
     } else {
-        gr_complex* dst = d_fft.get_inbuf();
-        if (d_shift) {
-            unsigned int len =
-                (unsigned int)(floor(d_fft_size / 2.0)); // half length of complex array
-            for (unsigned int i = 0; i < len; i++) {
-                dst[i] = in[len + i];
-            }
-            for (unsigned int i = len; i < d_fft_size; i++) {
-                dst[i] = in[i - len];
+        gr_complex* dst = fft.get_inbuf();
+        for (size_t v = 0; v < nvectors; v++) {
+            for (size_t i = 0; i < d_fft_size; i++) {
+                dst[i] = d_premultiply.empty() ? gr_complex(in[i])
+                                               : in[i] * d_premultiply[i];
             }
-        } else {
-            for (unsigned int i = 0; i < d_fft_size; i++) // float to complex conversion
-                dst[i] = in[i];
+            dst += d_fft_size;
+            in += d_fft_size;
         }
     }
 
-    // compute the fft
-    d_fft.execute();
+    fft.execute(src, out);
 
-    // copy result to output stream
-    memcpy(out, d_fft.get_outbuf(), sizeof(gr_complex) * d_fft_size);
+    if (!d_postmultiply.empty()) {
+        for (size_t v = 0; v < nvectors; v++) {
+            volk_32fc_x2_multiply_32fc(out + v * d_fft_size,
+                                       out + v * d_fft_size,
+                                       d_postmultiply.data(),
+                                       d_fft_size);
+        }
+    }
 }
 
 template <class T, bool forward>
@@ -158,18 +133,16 @@ work_return_code_t fft_cpu<T, forward>::work(std::vector<block_work_input_sptr>&
 {
     auto in = work_input[0]->items<T>();
     auto out = work_output[0]->items<gr_complex>();
-    auto noutput_items = work_output[0]->n_items;
-
-    int count = 0;
-
-    while (count++ < noutput_items) {
+    size_t noutput_items = work_output[0]->n_items;
 
-        fft_and_shift(in, out);
-
-        in += d_fft_size;
-        out += d_fft_size;
+    size_t batch = d_batch_fft.batch();
+    size_t count = 0;
+    for (; count + batch <= noutput_items; count += batch) {
+        transform(d_batch_fft, in + count * d_fft_size, out + count * d_fft_size, batch);
+    }
+    for (; count < noutput_items; count++) {
+        transform(d_fft, in + count * d_fft_size, out + count * d_fft_size, 1);
     }
-
 
     work_output[0]->n_produced = noutput_items;
     return work_return_code_t::WORK_OK;
@@ -177,4 +150,4 @@ work_return_code_t fft_cpu<T, forward>::work(std::vector<block_work_input_sptr>&
 
 
 } // namespace fft
-} // namespace gr
\ No newline at end of file
+} // namespace gr
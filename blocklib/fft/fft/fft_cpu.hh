@@ -22,9 +22,19 @@ protected:
     std::vector<float> d_window;
     bool d_shift;
 
+    // Full batches go through one plan, the vectors left over one at a time
     fftw_fft<gr_complex, forward> d_fft;
+    fftw_fft<gr_complex, forward> d_batch_fft;
 
-    void fft_and_shift(const T* in, gr_complex* out);
+    // The window and shift folded into a multiply before and after the transform,
+    // empty when not needed
+    volk::vector<gr_complex> d_premultiply;
+    volk::vector<gr_complex> d_postmultiply;
+
+    void transform(fftw_fft<gr_complex, forward>& fft,
+                   const T* in,
+                   gr_complex* out,
+                   size_t nvectors);
 };
 
 } // namespace fft
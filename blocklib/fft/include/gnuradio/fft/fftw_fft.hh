@@ -19,6 +19,7 @@
 #include <gnuradio/logging.hh>
 #include <volk/volk_alloc.hh>
 
+#include <memory>
 #include <mutex>
 
 namespace gr {
@@ -41,9 +42,23 @@ FFT_API double* malloc_double(int size);
 FFT_API void free(void* b);
 
 
+/*!
+ * \brief How long FFTW may spend finding the fastest plan
+ *
+ * Wisdom from a more rigorous planner is used by the less rigorous ones, so
+ * sizes planned offline at PATIENT get the better plans at MEASURE.
+ */
+enum class planner_effort { ESTIMATE, MEASURE, PATIENT, EXHAUSTIVE };
+
 /*!
  * \brief Export reference to planner mutex for those apps that
  * want to use FFTW w/o using the fft_impl_fftw* classes.
+ *
+ * Plans are cached for the life of the process and shared by every fftw_fft
+ * with the same type, direction, size, layout, thread count and buffer
+ * alignment, so only the first of them plans and touches the wisdom file.
+ * The wisdom file is read again before each new plan, as other processes may
+ * have added to it, and written back after.
  */
 class FFT_API planner
 {
@@ -52,6 +67,23 @@ public:
      * Return reference to planner mutex
      */
     static std::mutex& mutex();
+
+    /*!
+     * Set the effort of the plans made from now on, MEASURE by default
+     */
+    static void set_effort(planner_effort effort);
+    static planner_effort effort();
+
+    /*!
+     * Number of plans in the cache
+     */
+    static size_t cached_plans();
+
+    /*!
+     * Drop the cache's references to its plans.  Plans still in use by an
+     * fftw_fft live on until it is destroyed.
+     */
+    static void clear_cache();
 };
 
 
@@ -85,16 +117,30 @@ struct fft_outbuf<float, true> {
 template <class T, bool forward>
 class FFT_API fftw_fft
 {
+    int d_fft_size;
     int d_nthreads;
+    int d_batch;
+    int d_stride;
+    int d_dist;
     volk::vector<typename fft_inbuf<T, forward>::type> d_inbuf;
     volk::vector<typename fft_outbuf<T, forward>::type> d_outbuf;
-    void* d_plan;
+    std::shared_ptr<void> d_plan; // from the plan cache, shared with other instances
     gr::logger_sptr d_logger;
     gr::logger_sptr d_debug_logger;
-    void initialize_plan(int fft_size);
+    void* initialize_plan(int fft_size, unsigned int flags);
+    std::shared_ptr<void> get_plan(int nthreads);
 
 public:
-    fftw_fft(int fft_size, int nthreads = 1);
+    /*!
+     * \param fft_size length of each transform
+     * \param nthreads threads FFTW may use
+     * \param batch number of transforms done per execute()
+     * \param stride distance in items between the points of a transform, in both
+     *               the input and the output
+     * \param dist distance in items between the starts of consecutive transforms,
+     *             0 for back to back (fft_size * stride)
+     */
+    fftw_fft(int fft_size, int nthreads = 1, int batch = 1, int stride = 1, int dist = 0);
     // Copy disabled due to d_plan.
     fftw_fft(const fftw_fft&) = delete;
     fftw_fft& operator=(const fftw_fft&) = delete;
@@ -111,8 +157,14 @@ public:
     int inbuf_length() const { return d_inbuf.size(); }
     int outbuf_length() const { return d_outbuf.size(); }
 
+    int fft_size() const { return d_fft_size; }
+    int batch() const { return d_batch; }
+    int stride() const { return d_stride; }
+    int dist() const { return d_dist; }
+
     /*!
-     *  Set the number of threads to use for calculation.
+     *  Set the number of threads to use for calculation.  This switches to
+     *  the plan for n threads, planning it if it isn't cached yet.
      */
     void set_nthreads(int n);
 
@@ -123,9 +175,21 @@ public:
 
     /*!
      * compute FFT. The input comes from inbuf, the output is placed in
-     * outbuf.
+     * outbuf.  All batch() transforms are done in the one call.
      */
     void execute();
+
+    /*!
+     * compute FFT from in to out, which are laid out like inbuf and outbuf and
+     * must not overlap.
+     *
+     * FFTW only runs a plan on arrays with the same alignment as the ones it
+     * was planned on, so misaligned arrays go through inbuf and outbuf
+     * instead.  in may be inbuf itself.  The complex to real transform
+     * overwrites its input, as with execute().
+     */
+    void execute(const typename fft_inbuf<T, forward>::type* in,
+                 typename fft_outbuf<T, forward>::type* out);
 };
 
 using fft_complex_fwd = fftw_fft<gr_complex, true>;
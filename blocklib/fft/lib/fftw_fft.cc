@@ -31,11 +31,15 @@ static int my_fftw_read_char(void* f) { return fgetc((FILE*)f); }
 #define O_NONBLOCK 0
 #endif //_WIN32
 
+#include <algorithm>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <filesystem>
+#include <map>
 #include <stdexcept>
+#include <tuple>
+#include <type_traits>
 
 #include <gnuradio/prefs.hh>
 
@@ -155,17 +159,128 @@ static void export_wisdom()
     }
 }
 
+// Items spanned by batch transforms of fft_size points
+static size_t buffer_length(int fft_size, int batch, int stride, int dist)
+{
+    if (fft_size <= 0 || batch <= 0 || stride <= 0) {
+        return 1; // the constructor throws
+    }
+    return (size_t)(batch - 1) * dist + (size_t)(fft_size - 1) * stride + 1;
+}
+
+// Runs a plan on other arrays than it was made with
+static void execute_plan(void* plan, gr_complex* in, gr_complex* out)
+{
+    fftwf_execute_dft((fftwf_plan)plan,
+                      reinterpret_cast<fftwf_complex*>(in),
+                      reinterpret_cast<fftwf_complex*>(out));
+}
+
+static void execute_plan(void* plan, float* in, gr_complex* out)
+{
+    fftwf_execute_dft_r2c((fftwf_plan)plan, in, reinterpret_cast<fftwf_complex*>(out));
+}
+
+static void execute_plan(void* plan, gr_complex* in, float* out)
+{
+    fftwf_execute_dft_c2r((fftwf_plan)plan, reinterpret_cast<fftwf_complex*>(in), out);
+}
+
+// Modify while holding 'planner::mutex()'
+static planner_effort s_effort = planner_effort::MEASURE;
+
+void planner::set_effort(planner_effort effort)
+{
+    std::scoped_lock lock(planner::mutex());
+    s_effort = effort;
+}
+
+planner_effort planner::effort()
+{
+    std::scoped_lock lock(planner::mutex());
+    return s_effort;
+}
+
+static unsigned int planner_flags(planner_effort effort)
+{
+    switch (effort) {
+    case planner_effort::ESTIMATE:
+        return FFTW_ESTIMATE;
+    case planner_effort::PATIENT:
+        return FFTW_PATIENT;
+    case planner_effort::EXHAUSTIVE:
+        return FFTW_EXHAUSTIVE;
+    default:
+        return FFTW_MEASURE;
+    }
+}
+
+// Everything a plan depends on.  A plan runs on any arrays with the alignment of
+// the ones it was made with, so instances with their own buffers can share it.
+using plan_key = std::tuple<bool, // real
+                            bool, // forward
+                            int,  // fft_size
+                            int,  // batch
+                            int,  // stride
+                            int,  // dist
+                            int,  // nthreads
+                            int,  // input alignment
+                            int,  // output alignment
+                            unsigned int>; // planner flags
+
+// Plans for the life of the process, all access while holding 'planner::mutex()'
+struct plan_cache {
+    plan_cache()
+    {
+        // The mutex has to outlive the cache, whose plans lock it when destroyed
+        planner::mutex();
+    }
+    std::map<plan_key, std::shared_ptr<void>> plans;
+};
+
+static plan_cache& cache()
+{
+    static plan_cache s_cache;
+    return s_cache;
+}
+
+static void destroy_plan(void* plan)
+{
+    std::scoped_lock lock(planner::mutex());
+    fftwf_destroy_plan((fftwf_plan)plan);
+}
+
+size_t planner::cached_plans()
+{
+    std::scoped_lock lock(planner::mutex());
+    return cache().plans.size();
+}
+
+void planner::clear_cache()
+{
+    std::map<plan_key, std::shared_ptr<void>> plans;
+    {
+        std::scoped_lock lock(planner::mutex());
+        plans.swap(cache().plans);
+    }
+    // the unused plans are destroyed here, outside of the lock
+}
+
 // ----------------------------------------------------------------
 
 
 template <class T, bool forward>
-fftw_fft<T, forward>::fftw_fft(int fft_size, int nthreads)
-    : d_nthreads(nthreads), d_inbuf(fft_size), d_outbuf(fft_size)
+fftw_fft<T, forward>::fftw_fft(int fft_size, int nthreads, int batch, int stride, int dist)
+    : d_fft_size(fft_size),
+      d_nthreads(nthreads),
+      d_batch(batch),
+      d_stride(stride),
+      d_dist(dist > 0 ? dist : fft_size * stride),
+      d_inbuf(buffer_length(fft_size, batch, stride, d_dist)),
+      d_outbuf(buffer_length(fft_size, batch, stride, d_dist))
 {
     d_logger = logging::get_logger("fft_complex", "default");
     d_debug_logger = logging::get_logger("fft_complex(dbg)", "debug");
-    // Hold global mutex during plan construction and destruction.
-    std::scoped_lock lock(planner::mutex());
 
     static_assert(sizeof(fftwf_complex) == sizeof(gr_complex),
                   "The size of fftwf_complex is not equal to gr_complex");
@@ -173,67 +288,151 @@ fftw_fft<T, forward>::fftw_fft(int fft_size, int nthreads)
     if (fft_size <= 0) {
         throw std::out_of_range("fft_impl_fftw: invalid fft_size");
     }
+    if (batch <= 0 || stride <= 0) {
+        throw std::out_of_range("fft_impl_fftw: invalid batch layout");
+    }
+
+    d_plan = get_plan(nthreads);
+}
+
+template <class T, bool forward>
+std::shared_ptr<void> fftw_fft<T, forward>::get_plan(int nthreads)
+{
+    // Hold global mutex during plan lookup and construction.
+    std::scoped_lock lock(planner::mutex());
+
+    auto flags = planner_flags(s_effort);
+    plan_key key{ std::is_same<T, float>::value,
+                  forward,
+                  d_fft_size,
+                  d_batch,
+                  d_stride,
+                  d_dist,
+                  nthreads,
+                  fftwf_alignment_of((float*)d_inbuf.data()),
+                  fftwf_alignment_of((float*)d_outbuf.data()),
+                  flags };
+    auto& cached = cache().plans[key];
+    if (cached) {
+        return cached;
+    }
 
     config_threading(nthreads);
     lock_wisdom();
+    // Other processes may have added to the file since, and the export below
+    // overwrites it
     import_wisdom(); // load prior wisdom from disk
 
-    initialize_plan(fft_size);
-    if (d_plan == NULL) {
+    auto plan = initialize_plan(d_fft_size, flags);
+    if (plan == NULL) {
+        unlock_wisdom();
+        cache().plans.erase(key);
         GR_LOG_ERROR(d_logger, "creating plan failed");
         throw std::runtime_error("Creating fftw plan failed");
     }
     export_wisdom(); // store new wisdom to disk
     unlock_wisdom();
+
+    cached = std::shared_ptr<void>(plan, destroy_plan);
+    return cached;
 }
 
+// A single back to back transform is planned as the plain 1d transform, so the
+// wisdom matches
 template <>
-void fftw_fft<gr_complex, true>::initialize_plan(int fft_size)
+void* fftw_fft<gr_complex, true>::initialize_plan(int fft_size, unsigned int flags)
 {
-    d_plan = fftwf_plan_dft_1d(fft_size,
-                               reinterpret_cast<fftwf_complex*>(d_inbuf.data()),
-                               reinterpret_cast<fftwf_complex*>(d_outbuf.data()),
-                               FFTW_FORWARD,
-                               FFTW_MEASURE);
+    return fftwf_plan_many_dft(1,
+                                 &fft_size,
+                                 d_batch,
+                                 reinterpret_cast<fftwf_complex*>(d_inbuf.data()),
+                                 nullptr,
+                                 d_stride,
+                                 d_dist,
+                                 reinterpret_cast<fftwf_complex*>(d_outbuf.data()),
+                                 nullptr,
+                                 d_stride,
+                                 d_dist,
+                                 FFTW_FORWARD,
+                                 flags);
 }
 
 template <>
-void fftw_fft<gr_complex, false>::initialize_plan(int fft_size)
+void* fftw_fft<gr_complex, false>::initialize_plan(int fft_size, unsigned int flags)
 {
-    d_plan = fftwf_plan_dft_1d(fft_size,
-                               reinterpret_cast<fftwf_complex*>(d_inbuf.data()),
-                               reinterpret_cast<fftwf_complex*>(d_outbuf.data()),
-                               FFTW_BACKWARD,
-                               FFTW_MEASURE);
+    return fftwf_plan_many_dft(1,
+                                 &fft_size,
+                                 d_batch,
+                                 reinterpret_cast<fftwf_complex*>(d_inbuf.data()),
+                                 nullptr,
+                                 d_stride,
+                                 d_dist,
+                                 reinterpret_cast<fftwf_complex*>(d_outbuf.data()),
+                                 nullptr,
+                                 d_stride,
+                                 d_dist,
+                                 FFTW_BACKWARD,
+                                 flags);
 }
 
 
 template <>
-void fftw_fft<float, true>::initialize_plan(int fft_size)
+void* fftw_fft<float, true>::initialize_plan(int fft_size, unsigned int flags)
 {
-    d_plan = fftwf_plan_dft_r2c_1d(fft_size,
-                                   d_inbuf.data(),
-                                   reinterpret_cast<fftwf_complex*>(d_outbuf.data()),
-                                   FFTW_MEASURE);
+    return fftwf_plan_many_dft_r2c(1,
+                                     &fft_size,
+                                     d_batch,
+                                     d_inbuf.data(),
+                                     nullptr,
+                                     d_stride,
+                                     d_dist,
+                                     reinterpret_cast<fftwf_complex*>(d_outbuf.data()),
+                                     nullptr,
+                                     d_stride,
+                                     d_dist,
+                                     flags);
 }
 
 template <>
-void fftw_fft<float, false>::initialize_plan(int fft_size)
+void* fftw_fft<float, false>::initialize_plan(int fft_size, unsigned int flags)
 {
-    d_plan = fftwf_plan_dft_c2r_1d(fft_size,
-                                   reinterpret_cast<fftwf_complex*>(d_inbuf.data()),
-                                   d_outbuf.data(),
-                                   FFTW_MEASURE);
+    return fftwf_plan_many_dft_c2r(1,
+                                     &fft_size,
+                                     d_batch,
+                                     reinterpret_cast<fftwf_complex*>(d_inbuf.data()),
+                                     nullptr,
+                                     d_stride,
+                                     d_dist,
+                                     d_outbuf.data(),
+                                     nullptr,
+                                     d_stride,
+                                     d_dist,
+                                     flags);
 }
 
 
 template <class T, bool forward>
-fftw_fft<T, forward>::~fftw_fft()
+void fftw_fft<T, forward>::execute(const typename fft_inbuf<T, forward>::type* in,
+                                   typename fft_outbuf<T, forward>::type* out)
 {
-    // Hold global mutex during plan construction and destruction.
-    std::scoped_lock lock(planner::mutex());
+    if (fftwf_alignment_of((float*)in) == fftwf_alignment_of((float*)d_inbuf.data()) &&
+        fftwf_alignment_of((float*)out) == fftwf_alignment_of((float*)d_outbuf.data())) {
+        execute_plan(
+            d_plan.get(), const_cast<typename fft_inbuf<T, forward>::type*>(in), out);
+        return;
+    }
 
-    fftwf_destroy_plan((fftwf_plan)d_plan);
+    if (in != d_inbuf.data()) {
+        memcpy(d_inbuf.data(), in, d_inbuf.size() * sizeof(*in));
+    }
+    execute_plan(d_plan.get(), d_inbuf.data(), d_outbuf.data());
+    memcpy(out, d_outbuf.data(), d_outbuf.size() * sizeof(*out));
+}
+
+template <class T, bool forward>
+fftw_fft<T, forward>::~fftw_fft()
+{
+    // The plan is destroyed with the last reference to it, under the planner mutex
 }
 
 template <class T, bool forward>
@@ -242,17 +441,18 @@ void fftw_fft<T, forward>::set_nthreads(int n)
     if (n <= 0) {
         throw std::out_of_range("gr::fft: invalid number of threads");
     }
+    if (n == d_nthreads) {
+        return;
+    }
+    d_plan = get_plan(n);
     d_nthreads = n;
-
-#ifdef FFTW3F_THREADS
-    fftwf_plan_with_nthreads(d_nthreads);
-#endif
 }
 
 template <class T, bool forward>
 void fftw_fft<T, forward>::execute()
 {
-    fftwf_execute((fftwf_plan)d_plan);
+    // The plan may have been made with another instance's buffers
+    execute_plan(d_plan.get(), d_inbuf.data(), d_outbuf.data());
 }
 
 
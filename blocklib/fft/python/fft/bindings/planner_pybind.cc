@@ -0,0 +1,23 @@
+/*
+ * Copyright 2021 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#include <pybind11/pybind11.h>
+
+namespace py = pybind11;
+
+#include <gnuradio/fft/fftw_fft.hh>
+
+void bind_planner(py::module& m)
+{
+    using planner = gr::fft::planner;
+
+    py::class_<planner>(m, "planner")
+        .def_static("cached_plans", &planner::cached_plans)
+        .def_static("clear_cache", &planner::clear_cache);
+}
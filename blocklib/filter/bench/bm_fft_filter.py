@@ -0,0 +1,102 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+
+#
+# SPDX-License-Identifier: GPL-3.0
+#
+# Compares the direct form and overlap-save FFT filter kernels across tap counts,
+# or runs a single fft_filter block in a flowgraph
+
+from newsched import gr, blocks
+from newsched import filter
+import numpy as np
+import sys
+import signal
+from argparse import ArgumentParser
+import time
+
+
+class benchmark_fft_filter(gr.flowgraph):
+
+    def __init__(self, args):
+        gr.flowgraph.__init__(self)
+
+        nsamples = args.samples
+        taps = np.random.uniform(-1, 1, args.ntaps).tolist()
+
+        self.nsrc = blocks.null_source(gr.sizeof_gr_complex*1)
+        self.nsnk = blocks.null_sink(gr.sizeof_gr_complex*1)
+        self.hd = blocks.head(gr.sizeof_gr_complex*1, int(nsamples))
+        self.filt = filter.fft_filter_ccf(args.decimation, taps, args.nthreads)
+
+        self.connect([self.nsrc, self.hd, self.filt, self.nsnk])
+
+
+def sweep_kernels(args):
+    nsamples = int(args.samples)
+    print(f'{"ntaps":>8} {"direct (MS/s)":>14} {"fft (MS/s)":>12}')
+    crossover = None
+    for ntaps in [int(x) for x in args.sweep.split(',')]:
+        taps = np.random.uniform(-1, 1, ntaps).astype(np.float32)
+        x = (np.random.randn(nsamples + ntaps - 1) +
+             1j * np.random.randn(nsamples + ntaps - 1)).astype(np.complex64)
+
+        rates = []
+        for k in (filter.kernel.fir_filter_ccf(taps),
+                  filter.kernel.fft_filter_ccf(args.decimation, taps, args.nthreads)):
+            startt = time.time()
+            if isinstance(k, filter.kernel.fir_filter_ccf):
+                k.filter(x, args.decimation)
+            else:
+                k.filter(x)
+            rates.append(nsamples / (time.time() - startt) / 1e6)
+
+        print(f'{ntaps:>8} {rates[0]:>14.1f} {rates[1]:>12.1f}')
+        if crossover is None and rates[1] > rates[0]:
+            crossover = ntaps
+
+    if crossover is not None:
+        print(f'fft filter is faster from {crossover} taps')
+
+
+def main(top_block_cls=benchmark_fft_filter, options=None):
+
+    parser = ArgumentParser(description='Run a flowgraph iterating over parameters for benchmarking')
+    parser.add_argument('--rt_prio', help='enable realtime scheduling', action='store_true')
+    parser.add_argument('--samples', type=int, default=1e8)
+    parser.add_argument('--ntaps', type=int, default=256)
+    parser.add_argument('--decimation', type=int, default=1)
+    parser.add_argument('--nthreads', type=int, default=1)
+    parser.add_argument('--sweep', type=str, default='',
+                        help='comma separated tap counts, compare the kernels instead of running a flowgraph')
+
+    args = parser.parse_args()
+    print(args)
+
+    if args.sweep:
+        sweep_kernels(args)
+        return
+
+    if args.rt_prio and gr.enable_realtime_scheduling() != gr.RT_OK:
+        print("Error: failed to enable real-time scheduling.")
+
+    tb = top_block_cls(args)
+
+    def sig_handler(sig=None, frame=None):
+        tb.stop()
+        tb.wait()
+        sys.exit(0)
+
+    signal.signal(signal.SIGINT, sig_handler)
+    signal.signal(signal.SIGTERM, sig_handler)
+
+    print("starting ...")
+    startt = time.time()
+    tb.start()
+
+    tb.wait()
+    endt = time.time()
+    print(f'[PROFILE_TIME]{endt-startt}[PROFILE_TIME]')
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,92 @@
+#include <cstdio>
+#include <iostream>
+#include <random>
+
+#include <gnuradio/filter/fir_filter.hh>
+
+#include "bench_utils.hh"
+
+#include "CLI/App.hpp"
+#include "CLI/Config.hpp"
+#include "CLI/Formatter.hpp"
+
+using namespace gr::filter::kernel;
+using namespace gr::bench;
+
+namespace {
+
+template <class T>
+T random_value(std::mt19937& gen)
+{
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    if constexpr (std::is_same<T, float>::value) {
+        return dist(gen);
+    } else {
+        return T(dist(gen), dist(gen));
+    }
+}
+
+template <class IN_T, class OUT_T, class TAP_T>
+void bm_fir(const std::string& name,
+            unsigned int ntaps,
+            unsigned int decimation,
+            unsigned long noutput,
+            double min_time)
+{
+    std::mt19937 gen(ntaps);
+    std::vector<TAP_T> taps(ntaps);
+    for (auto& t : taps) {
+        t = random_value<TAP_T>(gen);
+    }
+    std::vector<IN_T> input(noutput * decimation + ntaps);
+    for (auto& x : input) {
+        x = random_value<IN_T>(gen);
+    }
+    std::vector<OUT_T> output(noutput);
+    fir_filter<IN_T, OUT_T, TAP_T> fir(taps);
+
+    // One filter() call per output, what filterNdec used to do
+    auto per_sample = time_per_call(
+        [&] {
+            for (unsigned long i = 0; i < noutput; i++) {
+                output[i] = fir.filter(&input[i * decimation]);
+            }
+        },
+        min_time);
+    auto batched = time_per_call(
+        [&] { fir.filterNdec(output.data(), input.data(), noutput, decimation); },
+        min_time);
+
+    char label[64];
+    snprintf(label, sizeof(label), "%s/%u/%u", name.c_str(), ntaps, decimation);
+    print_row(label, per_sample, batched, noutput);
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    std::vector<unsigned int> ntaps = { 16, 64, 256 };
+    std::vector<unsigned int> decimations = { 1, 4 };
+    unsigned long noutput = 8192;
+    double min_time = 0.5;
+
+    CLI::App app{ "FIR kernel benchmark, per output filter() vs filterN/filterNdec" };
+
+    app.add_option("--ntaps", ntaps, "Tap counts to run");
+    app.add_option("--decimation", decimations, "Decimations to run");
+    app.add_option("--noutput", noutput, "Outputs per call");
+    app.add_option("--min_time", min_time, "Minimum seconds per measurement");
+
+    CLI11_PARSE(app, argc, argv);
+
+    print_header("per-sample ns", "batched ns", "Moutputs/s");
+    for (auto d : decimations) {
+        for (auto n : ntaps) {
+            bm_fir<float, float, float>("fir_fff", n, d, noutput, min_time);
+            bm_fir<gr_complex, gr_complex, float>("fir_ccf", n, d, noutput, min_time);
+            bm_fir<gr_complex, gr_complex, gr_complex>("fir_ccc", n, d, noutput, min_time);
+            bm_fir<float, gr_complex, gr_complex>("fir_fcc", n, d, noutput, min_time);
+        }
+    }
+}
@@ -0,0 +1,82 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2005,2010,2012 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#include "fft_filter_cpu.hh"
+#include "fft_filter_cpu_gen.hh"
+
+#include <algorithm>
+
+namespace gr {
+namespace filter {
+
+template <class T>
+fft_filter_cpu<T>::fft_filter_cpu(const typename fft_filter<T>::block_args& args)
+    : block("fft_filter"),
+      fft_filter<T>(args),
+      d_decimation(args.decimation),
+      d_filter(args.decimation, args.taps, args.nthreads)
+{
+    this->set_relative_rate(1.0 / d_decimation);
+    // The input pointer starts ntaps - 1 samples before the new input, set_taps may
+    // grow that up to max_ntaps
+    this->set_max_history(std::max<size_t>(args.max_ntaps, d_filter.ntaps()));
+    this->set_history(d_filter.ntaps());
+}
+
+template <class T>
+void fft_filter_cpu<T>::set_taps(const std::vector<float>& taps)
+{
+    std::scoped_lock guard(d_mutex);
+
+    if (taps.size() > this->max_history()) {
+        throw std::invalid_argument("fft_filter: more taps than max_ntaps");
+    }
+
+    d_filter.set_taps(taps);
+    this->set_history(d_filter.ntaps());
+    d_updated = true;
+}
+
+template <class T>
+work_return_code_t fft_filter_cpu<T>::work(std::vector<block_work_input_sptr>& work_input,
+                                           std::vector<block_work_output_sptr>& work_output)
+{
+    std::scoped_lock guard(d_mutex);
+
+    if (d_updated) {
+        d_updated = false;
+        this->consume_each(0, work_input);
+        this->produce_each(0, work_output);
+        return work_return_code_t::WORK_OK; // history requirements may have changed.
+    }
+
+    auto in = work_input[0]->items<T>();
+    auto out = work_output[0]->items<T>();
+
+    // Each output needs decimation new samples, the ntaps - 1 before them are history
+    auto noutput_items = std::min((size_t)work_output[0]->n_items,
+                                  work_input[0]->n_items / d_decimation);
+    if (noutput_items == 0) {
+        this->consume_each(0, work_input);
+        this->produce_each(0, work_output);
+        return work_output[0]->n_items == 0
+                   ? work_return_code_t::WORK_INSUFFICIENT_OUTPUT_ITEMS
+                   : work_return_code_t::WORK_INSUFFICIENT_INPUT_ITEMS;
+    }
+
+    d_filter.filter(noutput_items, in, out);
+
+    this->consume_each(noutput_items * d_decimation, work_input);
+    this->produce_each(noutput_items, work_output);
+    return work_return_code_t::WORK_OK;
+}
+
+} /* namespace filter */
+} /* namespace gr */
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <gnuradio/filter/fft_filter.hh>
+#include <gnuradio/filter/fft_filter.h>
+
+#include <mutex>
+
+namespace gr {
+namespace filter {
+
+template <class T>
+class fft_filter_cpu : public fft_filter<T>
+{
+public:
+    fft_filter_cpu(const typename fft_filter<T>::block_args& args);
+
+    virtual work_return_code_t work(std::vector<block_work_input_sptr>& work_input,
+                                    std::vector<block_work_output_sptr>& work_output) override;
+
+    /**
+     * @brief Replace the taps, also while running
+     *
+     * The buffers keep max_ntaps items of history, fixed when the flowgraph starts, so
+     * more taps throw std::invalid_argument
+     */
+    void set_taps(const std::vector<float>& taps) override;
+
+protected:
+    size_t d_decimation;
+    kernel::fft_filter<T, T, float> d_filter;
+    bool d_updated = false;
+    std::mutex d_mutex; // mutex to protect set/work access
+};
+
+
+} // namespace filter
+} // namespace gr
@@ -0,0 +1,108 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2010,2012,2014 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#pragma once
+
+#include <gnuradio/fft/fftw_fft.hh>
+#include <gnuradio/types.hh>
+#include <volk/volk_alloc.hh>
+#include <memory>
+#include <vector>
+
+namespace gr {
+namespace filter {
+namespace kernel {
+
+/*!
+ * \brief Fast FIR filter using FFT overlap-save
+ * \ingroup filter_blk
+ *
+ * \details
+ * Computes the same outputs as fir_filter::filterNdec: output i is the dot product
+ * of the reversed taps with input[i * decimation ... i * decimation + ntaps - 1], so
+ * the input must hold ntaps - 1 samples of history before the first new sample.
+ * Each transform of fftsize input samples yields fftsize - ntaps + 1 outputs at
+ * the input rate, of which every decimation-th is kept.  The cost per output is
+ * O(log(ntaps)) instead of O(ntaps), which wins for long filters.
+ *
+ * Valid instantiations are fff, ccf and ccc.  Real input uses real transforms.
+ */
+template <class IN_T, class OUT_T, class TAP_T>
+class fft_filter
+{
+public:
+    /*!
+     * \param decimation keep every decimation-th output
+     * \param taps filter taps
+     * \param nthreads number of FFTW threads per transform
+     */
+    fft_filter(int decimation, const std::vector<TAP_T>& taps, int nthreads = 1);
+
+    // The FFTW plans cannot be copied
+    fft_filter(const fft_filter&) = delete;
+    fft_filter& operator=(const fft_filter&) = delete;
+    fft_filter(fft_filter&&) = default;
+    fft_filter& operator=(fft_filter&&) = default;
+
+    /*!
+     * \brief Set new taps, rebuilding the transforms when the FFT size changes
+     *
+     * \return the number of history samples needed before the first input, ntaps - 1
+     */
+    int set_taps(const std::vector<TAP_T>& taps);
+    std::vector<TAP_T> taps() const;
+    unsigned int ntaps() const;
+    int fftsize() const;
+    int decimation() const;
+
+    void set_nthreads(int n);
+    int nthreads() const;
+
+    /*!
+     * \brief Filter noutput_items decimated outputs
+     *
+     * \param noutput_items number of outputs to produce
+     * \param input (noutput_items - 1) * decimation + ntaps samples, read every
+     *              stride-th item, so one stream of interleaved data can be filtered
+     *              in place
+     * \param output noutput_items outputs
+     * \param stride distance between consecutive input samples
+     * \return noutput_items
+     */
+    int filter(int noutput_items,
+               const IN_T* input,
+               OUT_T* output,
+               unsigned int stride = 1);
+
+private:
+    typedef fft::fftw_fft<IN_T, true> fwd_fft;
+    typedef fft::fftw_fft<OUT_T, false> inv_fft;
+
+    void compute_sizes(int ntaps);
+
+    int d_decimation;
+    int d_nthreads;
+    int d_ntaps = 0;
+    int d_fftsize = 0;
+    int d_nsamples = 0; // new outputs per transform, fftsize - ntaps + 1
+    int d_nbins = 0;    // fftsize / 2 + 1 for real transforms
+    std::vector<TAP_T> d_taps;
+    volk::vector<gr_complex> d_xformed_taps; // scaled by 1 / fftsize
+    std::unique_ptr<fwd_fft> d_fwdfft;
+    std::unique_ptr<inv_fft> d_invfft;
+};
+
+typedef fft_filter<float, float, float> fft_filter_fff;
+typedef fft_filter<gr_complex, gr_complex, float> fft_filter_ccf;
+typedef fft_filter<gr_complex, gr_complex, gr_complex> fft_filter_ccc;
+
+} /* namespace kernel */
+} /* namespace filter */
+} /* namespace gr */
@@ -40,7 +40,21 @@ public:
     unsigned int ntaps() const;
 
     OUT_T filter(const IN_T input[]) const;
+
+    /*!
+     * \brief Computes n outputs, output[i] being filter(&input[i])
+     *
+     * Blocks of outputs are accumulated together while walking the taps once, so
+     * the input is loaded once per block rather than once per output.
+     */
     void filterN(OUT_T output[], const IN_T input[], unsigned long n);
+
+    /*!
+     * \brief Computes n decimated outputs, output[i] being filter(&input[i * decimate])
+     *
+     * The input is split into its decimate phases, each filtered with its share of
+     * the taps, so only the outputs that are kept get computed.
+     */
     void filterNdec(OUT_T output[],
                     const IN_T input[],
                     unsigned long n,
@@ -53,6 +67,11 @@ protected:
     volk::vector<OUT_T> d_output;
     int d_align;
     int d_naligned;
+
+    // Polyphase split of d_taps for filterNdec, rebuilt when the decimation changes
+    unsigned int d_phase_decim = 0;
+    std::vector<std::vector<TAP_T>> d_phase_taps;
+    std::vector<IN_T> d_phase_input;
 };
 typedef fir_filter<float, float, float> fir_filter_fff;
 typedef fir_filter<gr_complex, gr_complex, float> fir_filter_ccf;
@@ -14,7 +14,7 @@
 
 #include <gnuradio/fft/fftw_fft.hh>
 #include <gnuradio/filter/api.h>
-// #include <gnuradio/filter/fft_filter.h>
+#include <gnuradio/filter/fft_filter.h>
 #include <gnuradio/filter/fir_filter.hh>
 
 namespace gr {
@@ -91,7 +91,9 @@ class FILTER_API polyphase_filterbank
 protected:
     unsigned int d_nfilts;
     std::vector<kernel::fir_filter_ccf> d_fir_filters;
-    // std::vector<kernel::fft_filter_ccf> d_fft_filters;
+    // Only built when selected, one per arm with the same taps as d_fir_filters
+    bool d_use_fft_filters;
+    std::vector<kernel::fft_filter_ccf> d_fft_filters;
     std::vector<std::vector<float>> d_taps;
     unsigned int d_taps_per_filter;
 
@@ -105,8 +107,13 @@ public:
      *               channels <EM>M</EM>
      * \param taps (vector/list of floats) The prototype filter to
      *             populate the filterbank.
+     * \param use_fft_filters (bool) Also build FFT overlap-save filters for
+     *             the arms, faster than the direct form for long arms when
+     *             filtering many samples per call.
      */
-    polyphase_filterbank(unsigned int nfilts, const std::vector<float>& taps);
+    polyphase_filterbank(unsigned int nfilts,
+                         const std::vector<float>& taps,
+                         bool use_fft_filters = false);
 
     virtual ~polyphase_filterbank() = default;
 
@@ -128,6 +135,8 @@ public:
      * Return a vector<vector<>> of the filterbank taps
      */
     std::vector<std::vector<float>> taps() const;
+
+    bool use_fft_filters() const { return d_use_fft_filters; }
 };
 
 } /* namespace kernel */
@@ -0,0 +1,167 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2010,2012,2014 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#include <gnuradio/filter/fft_filter.h>
+#include <volk/volk.h>
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+
+namespace gr {
+namespace filter {
+namespace kernel {
+
+template <class IN_T, class OUT_T, class TAP_T>
+fft_filter<IN_T, OUT_T, TAP_T>::fft_filter(int decimation,
+                                           const std::vector<TAP_T>& taps,
+                                           int nthreads)
+    : d_decimation(decimation), d_nthreads(nthreads)
+{
+    if (decimation < 1) {
+        throw std::invalid_argument("fft_filter: decimation must be at least 1");
+    }
+    set_taps(taps);
+}
+
+template <class IN_T, class OUT_T, class TAP_T>
+void fft_filter<IN_T, OUT_T, TAP_T>::compute_sizes(int ntaps)
+{
+    // Smallest power of two holding twice the taps, so at least half of each
+    // transform is new output
+    int fftsize = 1;
+    while (fftsize < 2 * ntaps) {
+        fftsize <<= 1;
+    }
+
+    d_ntaps = ntaps;
+    d_nsamples = fftsize - ntaps + 1;
+
+    if (fftsize != d_fftsize) {
+        d_fftsize = fftsize;
+        d_nbins = std::is_same<IN_T, float>::value ? fftsize / 2 + 1 : fftsize;
+        d_fwdfft = std::make_unique<fwd_fft>(fftsize, d_nthreads);
+        d_invfft = std::make_unique<inv_fft>(fftsize, d_nthreads);
+        d_xformed_taps.resize(d_nbins);
+    }
+}
+
+template <class IN_T, class OUT_T, class TAP_T>
+int fft_filter<IN_T, OUT_T, TAP_T>::set_taps(const std::vector<TAP_T>& taps)
+{
+    if (taps.empty()) {
+        throw std::invalid_argument("fft_filter: taps cannot be empty");
+    }
+
+    d_taps = taps;
+    compute_sizes(taps.size());
+
+    // Transform the zero padded taps once, folding in the 1/fftsize of the inverse
+    auto in = d_fwdfft->get_inbuf();
+    float scale = 1.0f / d_fftsize;
+    for (int i = 0; i < d_fftsize; i++) {
+        in[i] = i < d_ntaps ? static_cast<IN_T>(d_taps[i] * scale) : IN_T(0);
+    }
+    d_fwdfft->execute();
+    memcpy(d_xformed_taps.data(), d_fwdfft->get_outbuf(), d_nbins * sizeof(gr_complex));
+
+    return d_ntaps - 1;
+}
+
+template <class IN_T, class OUT_T, class TAP_T>
+std::vector<TAP_T> fft_filter<IN_T, OUT_T, TAP_T>::taps() const
+{
+    return d_taps;
+}
+
+template <class IN_T, class OUT_T, class TAP_T>
+unsigned int fft_filter<IN_T, OUT_T, TAP_T>::ntaps() const
+{
+    return d_ntaps;
+}
+
+template <class IN_T, class OUT_T, class TAP_T>
+int fft_filter<IN_T, OUT_T, TAP_T>::fftsize() const
+{
+    return d_fftsize;
+}
+
+template <class IN_T, class OUT_T, class TAP_T>
+int fft_filter<IN_T, OUT_T, TAP_T>::decimation() const
+{
+    return d_decimation;
+}
+
+template <class IN_T, class OUT_T, class TAP_T>
+void fft_filter<IN_T, OUT_T, TAP_T>::set_nthreads(int n)
+{
+    d_nthreads = n;
+    d_fwdfft->set_nthreads(n);
+    d_invfft->set_nthreads(n);
+}
+
+template <class IN_T, class OUT_T, class TAP_T>
+int fft_filter<IN_T, OUT_T, TAP_T>::nthreads() const
+{
+    return d_nthreads;
+}
+
+template <class IN_T, class OUT_T, class TAP_T>
+int fft_filter<IN_T, OUT_T, TAP_T>::filter(int noutput_items,
+                                           const IN_T* input,
+                                           OUT_T* output,
+                                           unsigned int stride)
+{
+    if (noutput_items <= 0) {
+        return 0;
+    }
+
+    auto fwd_in = d_fwdfft->get_inbuf();
+    auto fwd_out = d_fwdfft->get_outbuf();
+    auto inv_in = d_invfft->get_inbuf();
+    auto inv_out = d_invfft->get_outbuf();
+
+    // Outputs at the input rate spanned by the decimated outputs
+    int nfull = (noutput_items - 1) * d_decimation + 1;
+    int next = 0; // next input rate output to keep
+
+    for (int j = 0; j < nfull; j += d_nsamples) {
+        // Samples j ... j + fftsize - 1, zero padded past the end of the input
+        int navail = std::min(d_fftsize, nfull - j + d_ntaps - 1);
+        if (stride == 1) {
+            memcpy(fwd_in, input + j, navail * sizeof(IN_T));
+        } else {
+            for (int k = 0; k < navail; k++) {
+                fwd_in[k] = input[(size_t)(j + k) * stride];
+            }
+        }
+        std::fill(fwd_in + navail, fwd_in + d_fftsize, IN_T(0));
+
+        d_fwdfft->execute();
+        volk_32fc_x2_multiply_32fc(inv_in, fwd_out, d_xformed_taps.data(), d_nbins);
+        d_invfft->execute();
+
+        // The first ntaps - 1 points of the circular convolution wrap around
+        int end = std::min(j + d_nsamples, nfull);
+        for (; next < end; next += d_decimation) {
+            output[next / d_decimation] = inv_out[d_ntaps - 1 + next - j];
+        }
+    }
+
+    return noutput_items;
+}
+
+template class fft_filter<float, float, float>;
+template class fft_filter<gr_complex, gr_complex, float>;
+template class fft_filter<gr_complex, gr_complex, gr_complex>;
+
+} /* namespace kernel */
+} /* namespace filter */
+} /* namespace gr */
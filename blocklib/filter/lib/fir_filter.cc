@@ -13,11 +13,168 @@
 #include <algorithm>
 #include <cstdio>
 #include <cstring>
+#include <type_traits>
 
 namespace gr {
 namespace filter {
 namespace kernel {
 
+namespace {
+
+// Partial sums kept live per block of outputs, in floats.  Sized so the
+// accumulators stay in vector registers while the taps are walked once per block
+constexpr unsigned int block_floats = 32;
+
+// Outputs per deinterleaved chunk in filterNdec, keeping the phase copy in cache
+constexpr unsigned long phase_chunk = 2048;
+
+// Type combinations with a block kernel below, the others go through filter()
+template <class IN_T, class OUT_T, class TAP_T>
+struct has_fir_block : std::false_type {
+};
+template <>
+struct has_fir_block<float, float, float> : std::true_type {
+};
+template <>
+struct has_fir_block<gr_complex, gr_complex, float> : std::true_type {
+};
+template <>
+struct has_fir_block<float, gr_complex, gr_complex> : std::true_type {
+};
+template <>
+struct has_fir_block<gr_complex, gr_complex, gr_complex> : std::true_type {
+};
+
+// Real taps over samples of L interleaved floats.  The inner loop runs over
+// contiguous input with the tap broadcast, which the compiler vectorizes for
+// whatever SIMD width the build targets
+template <unsigned int L>
+void fir_block_real_taps(float* out,
+                         const float* in,
+                         const float* taps,
+                         unsigned int ntaps,
+                         unsigned long n,
+                         bool accumulate)
+{
+    for (unsigned long i = 0; i < n; i += block_floats / L) {
+        unsigned int nf = std::min(n - i, (unsigned long)block_floats / L) * L;
+        const float* x = in + i * L;
+        float acc[block_floats] = {};
+        // Full blocks get a fixed trip count so the accumulators stay in registers
+        if (nf == block_floats) {
+            for (unsigned int k = 0; k < ntaps; k++) {
+                const float t = taps[k];
+                const float* xk = x + (size_t)k * L;
+                for (unsigned int o = 0; o < block_floats; o++) {
+                    acc[o] += t * xk[o];
+                }
+            }
+        } else {
+            for (unsigned int k = 0; k < ntaps; k++) {
+                const float t = taps[k];
+                const float* xk = x + (size_t)k * L;
+                for (unsigned int o = 0; o < nf; o++) {
+                    acc[o] += t * xk[o];
+                }
+            }
+        }
+
+        float* y = out + i * L;
+        for (unsigned int o = 0; o < nf; o++) {
+            y[o] = accumulate ? y[o] + acc[o] : acc[o];
+        }
+    }
+}
+
+void fir_block(float* out,
+               const float* in,
+               const float* taps,
+               unsigned int ntaps,
+               unsigned long n,
+               bool accumulate)
+{
+    fir_block_real_taps<1>(out, in, taps, ntaps, n, accumulate);
+}
+
+void fir_block(gr_complex* out,
+               const gr_complex* in,
+               const float* taps,
+               unsigned int ntaps,
+               unsigned long n,
+               bool accumulate)
+{
+    fir_block_real_taps<2>(reinterpret_cast<float*>(out),
+                           reinterpret_cast<const float*>(in),
+                           taps,
+                           ntaps,
+                           n,
+                           accumulate);
+}
+
+// Complex taps are applied as two real products on the interleaved input, the
+// cross terms being combined once per block
+void fir_block(gr_complex* out,
+               const gr_complex* in,
+               const gr_complex* taps,
+               unsigned int ntaps,
+               unsigned long n,
+               bool accumulate)
+{
+    constexpr unsigned int B = block_floats / 2;
+    for (unsigned long i = 0; i < n; i += B) {
+        unsigned int nb = std::min(n - i, (unsigned long)B);
+        const float* x = reinterpret_cast<const float*>(in + i);
+        float acc_r[block_floats] = {}; // sum of taps.real() * (xr, xi)
+        float acc_i[block_floats] = {}; // sum of taps.imag() * (xr, xi)
+        for (unsigned int k = 0; k < ntaps; k++) {
+            const float tr = taps[k].real();
+            const float ti = taps[k].imag();
+            const float* xk = x + 2 * (size_t)k;
+            for (unsigned int o = 0; o < 2 * nb; o++) {
+                acc_r[o] += tr * xk[o];
+                acc_i[o] += ti * xk[o];
+            }
+        }
+
+        for (unsigned int o = 0; o < nb; o++) {
+            gr_complex y(acc_r[2 * o] - acc_i[2 * o + 1], acc_r[2 * o + 1] + acc_i[2 * o]);
+            out[i + o] = accumulate ? out[i + o] + y : y;
+        }
+    }
+}
+
+void fir_block(gr_complex* out,
+               const float* in,
+               const gr_complex* taps,
+               unsigned int ntaps,
+               unsigned long n,
+               bool accumulate)
+{
+    constexpr unsigned int B = block_floats;
+    for (unsigned long i = 0; i < n; i += B) {
+        unsigned int nb = std::min(n - i, (unsigned long)B);
+        const float* x = in + i;
+        float acc_r[B] = {};
+        float acc_i[B] = {};
+        for (unsigned int k = 0; k < ntaps; k++) {
+            const float tr = taps[k].real();
+            const float ti = taps[k].imag();
+            const float* xk = x + k;
+            for (unsigned int o = 0; o < nb; o++) {
+                acc_r[o] += tr * xk[o];
+                acc_i[o] += ti * xk[o];
+            }
+        }
+
+        for (unsigned int o = 0; o < nb; o++) {
+            gr_complex y(acc_r[o], acc_i[o]);
+            out[i + o] = accumulate ? out[i + o] + y : y;
+        }
+    }
+}
+
+} // namespace
+
 template <class IN_T, class OUT_T, class TAP_T>
 fir_filter<IN_T, OUT_T, TAP_T>::fir_filter(const std::vector<TAP_T>& taps) : d_output(1)
 {
@@ -32,6 +189,7 @@ void fir_filter<IN_T, OUT_T, TAP_T>::set_taps(const std::vector<TAP_T>& taps)
     d_ntaps = (int)taps.size();
     d_taps = taps;
     std::reverse(d_taps.begin(), d_taps.end());
+    d_phase_decim = 0;
 
     d_aligned_taps.clear();
     d_aligned_taps = std::vector<volk::vector<TAP_T>>(
@@ -46,6 +204,7 @@ template <class IN_T, class OUT_T, class TAP_T>
 void fir_filter<IN_T, OUT_T, TAP_T>::update_tap(TAP_T t, unsigned int index)
 {
     d_taps[index] = t;
+    d_phase_decim = 0;
     for (int i = 0; i < d_naligned; i++) {
         d_aligned_taps[i][i + index] = t;
     }
@@ -70,8 +229,12 @@ void fir_filter<IN_T, OUT_T, TAP_T>::filterN(OUT_T output[],
                                              const IN_T input[],
                                              unsigned long n)
 {
-    for (unsigned long i = 0; i < n; i++) {
-        output[i] = filter(&input[i]);
+    if constexpr (has_fir_block<IN_T, OUT_T, TAP_T>::value) {
+        fir_block(output, input, d_taps.data(), d_ntaps, n, false);
+    } else {
+        for (unsigned long i = 0; i < n; i++) {
+            output[i] = filter(&input[i]);
+        }
     }
 }
 
@@ -81,6 +244,51 @@ void fir_filter<IN_T, OUT_T, TAP_T>::filterNdec(OUT_T output[],
                                                 unsigned long n,
                                                 unsigned int decimate)
 {
+    if (decimate == 1) {
+        filterN(output, input, n);
+        return;
+    }
+
+    // With fewer taps than phases most of the input is never read, so it is not
+    // worth deinterleaving
+    if constexpr (has_fir_block<IN_T, OUT_T, TAP_T>::value) {
+        if (d_ntaps >= decimate) {
+            // output[i] = sum_k taps[k] * input[i * decimate + k], with k = m * decimate + p
+            // is the sum over phases p of the taps m * decimate + p run over the
+            // samples input[q * decimate + p]
+            if (d_phase_decim != decimate) {
+                d_phase_taps.assign(decimate, std::vector<TAP_T>());
+                for (unsigned int k = 0; k < d_ntaps; k++) {
+                    d_phase_taps[k % decimate].push_back(d_taps[k]);
+                }
+                d_phase_decim = decimate;
+            }
+
+            for (unsigned long done = 0; done < n;) {
+                unsigned long nchunk = std::min(phase_chunk, n - done);
+                for (unsigned int p = 0; p < decimate; p++) {
+                    const auto& taps = d_phase_taps[p];
+                    unsigned long nin = nchunk + taps.size() - 1;
+                    if (d_phase_input.size() < nin) {
+                        d_phase_input.resize(nin);
+                    }
+                    const IN_T* x = input + done * decimate + p;
+                    for (unsigned long q = 0; q < nin; q++) {
+                        d_phase_input[q] = x[q * decimate];
+                    }
+                    fir_block(output + done,
+                              d_phase_input.data(),
+                              taps.data(),
+                              taps.size(),
+                              nchunk,
+                              p > 0);
+                }
+                done += nchunk;
+            }
+            return;
+        }
+    }
+
     unsigned long j = 0;
     for (unsigned long i = 0; i < n; i++) {
         output[i] = filter(&input[j]);
@@ -19,17 +19,22 @@ namespace gr {
 namespace filter {
 namespace kernel {
 polyphase_filterbank::polyphase_filterbank(unsigned int nfilts,
-                                           const std::vector<float>& taps)
-    : d_nfilts(nfilts), d_fft(nfilts)
+                                           const std::vector<float>& taps,
+                                           bool use_fft_filters)
+    : d_nfilts(nfilts), d_use_fft_filters(use_fft_filters), d_fft(nfilts)
 {
     d_fir_filters.reserve(d_nfilts);
-    // d_fft_filters.reserve(d_nfilts);
+    if (d_use_fft_filters) {
+        d_fft_filters.reserve(d_nfilts);
+    }
 
     // Create an FIR filter for each channel and zero out the taps
     std::vector<float> vtaps(1, 0.0f);
     for (unsigned int i = 0; i < d_nfilts; i++) {
         d_fir_filters.emplace_back(vtaps);
-        // d_fft_filters.emplace_back(1, vtaps);
+        if (d_use_fft_filters) {
+            d_fft_filters.emplace_back(1, vtaps);
+        }
     }
 
     // Now, actually set the filters' taps
@@ -62,7 +67,9 @@ void polyphase_filterbank::set_taps(const std::vector<float>& taps)
 
         // Set the filter taps for each channel
         d_fir_filters[i].set_taps(d_taps[i]);
-        // d_fft_filters[i].set_taps(d_taps[i]);
+        if (d_use_fft_filters) {
+            d_fft_filters[i].set_taps(d_taps[i]);
+        }
     }
 }
 
@@ -23,12 +23,23 @@ moving_average_cpu<T>::moving_average_cpu(
       d_length(args.length),
       d_scale(args.scale),
       d_max_iter(args.max_iter),
-      d_vlen(args.vlen),
-      d_new_length(args.length),
-      d_new_scale(args.scale)
+      d_vlen(args.vlen)
 {
     d_sum = std::vector<T>(d_vlen);
-    d_history = std::vector<T>(d_vlen * (d_length - 1));
+    // The length can change while running, up to max_length
+    this->set_max_history(std::max(args.max_length, d_length));
+    this->set_history(d_length);
+}
+
+template <class T>
+void moving_average_cpu<T>::set_length(size_t length)
+{
+    // The readers only keep max_length items, older ones may be overwritten already
+    if (length > this->max_history()) {
+        throw std::invalid_argument("moving_average: length above max_length");
+    }
+
+    moving_average<T>::set_length(length);
 }
 
 template <class T>
@@ -36,54 +47,44 @@ work_return_code_t
 moving_average_cpu<T>::work(std::vector<block_work_input_sptr>& work_input,
                             std::vector<block_work_output_sptr>& work_output)
 {
-    if (work_input[0]->n_items < (int) d_length)
-    {
-        work_output[0]->n_produced = 0;
-        work_input[0]->n_consumed = 0;
-        return work_return_code_t::WORK_INSUFFICIENT_INPUT_ITEMS;
-    }
-
-    if (d_updated) {
-        d_length = d_new_length;
-        d_scale = d_new_scale;
-        d_updated = false;
+    auto length = this->param_length->value();
+    auto scale = this->param_scale->value();
+    if (length != d_length || scale != d_scale) {
+        // Take up the new history on the next call
+        d_length = length;
+        d_scale = scale;
+        this->set_history(d_length);
         work_output[0]->n_produced = 0;
         work_input[0]->n_consumed = 0;
         return work_return_code_t::WORK_OK;
     }
 
+    // The d_length - 1 items before the new input are readable through the history
     auto in = work_input[0]->items<T>();
     auto out = work_output[0]->items<T>();
 
-    size_t noutput_items = std::min( (int) ( work_input[0]->n_items - d_length ), work_output[0]->n_items);
-
+    size_t noutput_items =
+        std::min(work_input[0]->n_items, work_output[0]->n_items);
     auto num_iter = (noutput_items > d_max_iter) ? d_max_iter : noutput_items;
-    auto tr = work_input[0]->buffer->total_read();
 
-    if (tr == 0) { // for the first no history case
-        for (size_t i = 0; i < num_iter; i++) {
-            for (size_t elem = 0; elem < d_vlen; elem++) {
-                d_sum[elem] += in[i * d_vlen + elem];
-                out[i * d_vlen + elem] = d_sum[elem] * d_scale;
-                if (i >= (d_length-1)) {
-                    d_sum[elem] -= in[(i - (d_length - 1)) * d_vlen + elem];
-                }
-            }
+    // Start the sum over the history each call so rounding errors do not accumulate
+    for (size_t elem = 0; elem < d_vlen; elem++) {
+        d_sum[elem] = 0;
+        for (size_t k = 0; k < d_length - 1; k++) {
+            d_sum[elem] += in[k * d_vlen + elem];
         }
-    } else {
-        for (size_t i = 0; i < num_iter; i++) {
-            for (size_t elem = 0; elem < d_vlen; elem++) {
+    }
 
-                d_sum[elem] += in[(i+d_length-1) * d_vlen + elem];
-                out[i * d_vlen + elem] = d_sum[elem] * d_scale;
-                d_sum[elem] -= in[i * d_vlen + elem];
-            }
+    for (size_t i = 0; i < num_iter; i++) {
+        for (size_t elem = 0; elem < d_vlen; elem++) {
+            d_sum[elem] += in[(i + d_length - 1) * d_vlen + elem];
+            out[i * d_vlen + elem] = d_sum[elem] * d_scale;
+            d_sum[elem] -= in[i * d_vlen + elem];
         }
     }
 
-    // don't consume the last d_length-1 samples
     work_output[0]->n_produced = num_iter;
-    work_input[0]->n_consumed = tr == 0 ? num_iter - (d_length - 1) : num_iter;
+    work_input[0]->n_consumed = num_iter;
     return work_return_code_t::WORK_OK;
 } // namespace filter
 
@@ -12,7 +12,15 @@ class moving_average_cpu : public moving_average<T>
 {
 public:
     moving_average_cpu(const typename moving_average<T>::block_args& args);
-    
+
+    /**
+     * @brief Change the length while running
+     *
+     * The buffers keep max_length items of history, fixed when the flowgraph starts, so
+     * a longer length throws std::invalid_argument
+     */
+    void set_length(size_t length) override;
+
     virtual work_return_code_t work(std::vector<block_work_input_sptr>& work_input,
                                     std::vector<block_work_output_sptr>& work_output) override;
 
@@ -25,12 +33,6 @@ protected:
     size_t d_vlen;
     T d_scalar_sum;
     std::vector<T> d_sum;
-    
-    std::vector<T> d_history;
-
-    size_t d_new_length;
-    T d_new_scale;
-    bool d_updated = false;
 };
 
 
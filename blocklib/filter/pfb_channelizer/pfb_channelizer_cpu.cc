@@ -11,17 +11,27 @@
 #include "pfb_channelizer_cpu.hh"
 #include "pfb_channelizer_cpu_gen.hh"
 #include <volk/volk.h>
+#include <algorithm>
 
 namespace gr {
 namespace filter {
 
+namespace {
+// FFT input items done per batched execute, across as many frames as fit
+constexpr unsigned int fft_batch_items = 8192;
+
+// Channels moved per pass of the deinterleave, so each frame is read a cache line at
+// a time and written to a few rows
+constexpr size_t deinterleave_block = 16;
+} // namespace
+
 template <class T>
 pfb_channelizer_cpu<T>::pfb_channelizer_cpu(
     const typename pfb_channelizer<T>::block_args& args)
     : block("pfb_channelizer"), 
       pfb_channelizer<T>(args),
 
-      polyphase_filterbank(args.numchans, args.taps),
+      polyphase_filterbank(args.numchans, args.taps, args.use_fft_filters),
       d_oversample_rate(args.oversample_rate),
       d_nchans(args.numchans)
 {
@@ -61,12 +71,16 @@ pfb_channelizer_cpu<T>::pfb_channelizer_cpu(
         d_idxlut[i] = d_nfilts - ((i + d_rate_ratio) % d_nfilts) - 1;
     }
 
-    // // Calculate the number of filtering rounds to do to evenly
-    // // align the input vectors with the output channels
-    // d_output_multiple = 1;
-    // while ((d_output_multiple * d_rate_ratio) % d_nfilts != 0)
-    //     d_output_multiple++;
-    // this->set_output_multiple(d_output_multiple);
+    // Calculate the number of filtering rounds to do to evenly
+    // align the input vectors with the output channels
+    d_output_multiple = 1;
+    while ((d_output_multiple * d_rate_ratio) % d_nfilts != 0)
+        d_output_multiple++;
+    this->set_output_multiple(d_output_multiple);
+    build_schedule();
+
+    d_batch_fft = std::make_unique<fft::fft_complex_rev>(
+        d_nfilts, 1, std::max(1u, fft_batch_items / d_nfilts));
 
     // Use set_taps to also set the history requirement
     set_taps(args.taps);
@@ -82,51 +96,14 @@ void pfb_channelizer_cpu<T>::set_taps(const std::vector<float>& taps)
     // std::scoped_lock guard(d_mutex);
 
     polyphase_filterbank::set_taps(taps);
-    // set_history(d_taps_per_filter + 1);
-    d_history = d_nchans * (d_taps_per_filter + 1);
+    // d_taps_per_filter previous frames of d_nchans interleaved samples
+    this->set_history(d_nchans * d_taps_per_filter + 1);
     d_updated = true;
 }
 
-
 template <class T>
-work_return_code_t
-pfb_channelizer_cpu<T>::work(std::vector<block_work_input_sptr>& work_input,
-                             std::vector<block_work_output_sptr>& work_output)
+void pfb_channelizer_cpu<T>::build_schedule()
 {
-    // std::scoped_lock guard(d_mutex);
-
-    auto in = work_input[0]->items<T>();
-    auto out = work_output[0]->items<T>();
-    auto noutput_items = work_output[0]->n_items;
-    auto ninput_items = work_input[0]->n_items;
-
-    if ((size_t)ninput_items < (noutput_items * d_nchans + d_history) )
-    {
-        return work_return_code_t::WORK_INSUFFICIENT_INPUT_ITEMS;
-    }
-
-    if (d_updated) {
-        d_updated = false;
-        this->consume_each(0, work_input);
-        this->produce_each(0, work_output);
-        return work_return_code_t::WORK_OK; // history requirements may have changed.
-    }
-
-    std::vector<std::vector<T>> deinterleaved(d_nchans);
-
-    auto total_items = std::min(ninput_items / d_nchans, (size_t)noutput_items);
-
-    for (size_t j = 0; j < d_nchans; j++) {
-        if (deinterleaved[j].size() < total_items) {
-            deinterleaved[j].resize(total_items);
-        }
-        for (size_t i = 0; i < total_items; i++) {
-            deinterleaved[j][i] = in[i * d_nchans + j];
-        }
-    }
-
-    size_t noutputs = work_output.size();
-
     // The following algorithm looks more complex in order to handle
     // the cases where we want more that 1 sps for each
     // channel. Otherwise, this would boil down into a single loop
@@ -139,44 +116,137 @@ pfb_channelizer_cpu<T>::work(std::vector<block_work_input_sptr>& work_input,
     // fred harris, Multirate Signal Processing For Communication
     // Systems. Upper Saddle River, NJ: Prentice Hall, 2004.
 
-    int n = 1, i = -1, j = 0, oo = 0, last;
-    int toconsume = (int)rintf((noutput_items * d_nchans) / d_oversample_rate) - (d_history - 1);
-    while (n <= toconsume) {
+    // Walked once for a cycle of d_output_multiple outputs, recording which arm
+    // filters each FFT input from which frame rather than filtering as it goes
+    d_schedule.resize(d_output_multiple * d_nfilts);
+    int n = 1, i = -1, j, last;
+    for (int q = 0; q < d_output_multiple; q++) {
         j = 0;
         i = (i + d_rate_ratio) % d_nfilts;
         last = i;
         while (i >= 0) {
-            // in = (gr_complex*)work_input[j].items();
-            d_fft.get_inbuf()[d_idxlut[j]] =
-                d_fir_filters[i].filter(&deinterleaved[j][n]);
+            d_schedule[q * d_nfilts + j] = { (unsigned int)i, (unsigned int)n };
             j++;
             i--;
         }
 
         i = d_nfilts - 1;
         while (i > last) {
-            // in = (gr_complex*)work_input[j].items();
-            d_fft.get_inbuf()[d_idxlut[j]] =
-                d_fir_filters[i].filter(&deinterleaved[j][n - 1]);
+            d_schedule[q * d_nfilts + j] = { (unsigned int)i, (unsigned int)(n - 1) };
             j++;
             i--;
         }
 
         n += (i + d_rate_ratio) >= (int)d_nfilts;
+    }
+    d_frames_per_cycle = n - 1;
+}
+
+template <class T>
+void pfb_channelizer_cpu<T>::deinterleave(const T* in, size_t nframes)
+{
+    // Row j holds channel j, in[f * d_nchans + j] landing at column f
+    if (d_channels.size() < d_nchans * nframes) {
+        d_channels.resize(d_nchans * nframes);
+    }
+
+    for (size_t j0 = 0; j0 < d_nchans; j0 += deinterleave_block) {
+        size_t nj = std::min(deinterleave_block, d_nchans - j0);
+        gr_complex* rows = &d_channels[j0 * nframes];
+        for (size_t f = 0; f < nframes; f++) {
+            const T* frame = in + f * d_nchans + j0;
+            for (size_t j = 0; j < nj; j++) {
+                rows[j * nframes + f] = frame[j];
+            }
+        }
+    }
+}
+
+template <class T>
+work_return_code_t
+pfb_channelizer_cpu<T>::work(std::vector<block_work_input_sptr>& work_input,
+                             std::vector<block_work_output_sptr>& work_output)
+{
+    // std::scoped_lock guard(d_mutex);
+
+    if (d_updated) {
+        d_updated = false;
+        this->consume_each(0, work_input);
+        this->produce_each(0, work_output);
+        return work_return_code_t::WORK_OK; // history requirements may have changed.
+    }
+
+    // The input holds d_nchans interleaved channels, and the history makes the
+    // d_taps_per_filter previous frames readable before the new ones
+    auto in = work_input[0]->items<T>();
+    size_t nframes = work_input[0]->n_items / d_nchans;
+    size_t noutput_items = std::min((size_t)work_output[0]->n_items,
+                                    (size_t)(nframes * d_oversample_rate));
+    noutput_items = (noutput_items / d_output_multiple) * d_output_multiple;
+
+    if (noutput_items == 0) {
+        this->consume_each(0, work_input);
+        this->produce_each(0, work_output);
+        return work_output[0]->n_items < d_output_multiple
+                   ? work_return_code_t::WORK_INSUFFICIENT_OUTPUT_ITEMS
+                   : work_return_code_t::WORK_INSUFFICIENT_INPUT_ITEMS;
+    }
+
+    size_t noutputs = work_output.size();
+    size_t toconsume = (size_t)rintf(noutput_items / d_oversample_rate);
+    size_t ncycles = noutput_items / d_output_multiple;
+
+    // Every arm filters a whole row of the deinterleaved input in one call, the
+    // steps of one cycle being a fixed arm and starting frame, and the following
+    // cycles d_frames_per_cycle frames further on
+    size_t nwindow = toconsume + d_taps_per_filter;
+    deinterleave(in, nwindow);
+
+    size_t nrows = d_output_multiple * d_nfilts;
+    if (d_arm_output.size() < nrows * ncycles) {
+        d_arm_output.resize(nrows * ncycles);
+    }
+    for (size_t r = 0; r < nrows; r++) {
+        auto& step = d_schedule[r];
+        const gr_complex* x = &d_channels[(r % d_nfilts) * nwindow + step.frame];
+        gr_complex* y = &d_arm_output[r * ncycles];
+        if (d_use_fft_filters && d_frames_per_cycle == 1) {
+            d_fft_filters[step.arm].filter(ncycles, x, y);
+        } else {
+            d_fir_filters[step.arm].filterNdec(y, x, ncycles, d_frames_per_cycle);
+        }
+    }
+
+    // despin through FFT, a batch of outputs at a time
+    auto fft_in = d_batch_fft->get_inbuf();
+    auto fft_out = d_batch_fft->get_outbuf();
+    size_t batch = d_batch_fft->batch();
+    for (size_t o0 = 0; o0 < noutput_items; o0 += batch) {
+        size_t nb = std::min(batch, noutput_items - o0);
+        for (size_t r = 0; r < nrows; r++) {
+            size_t q = r / d_nfilts;
+            size_t first = o0 + (q + d_output_multiple - o0 % d_output_multiple) %
+                                    d_output_multiple;
+            const gr_complex* arm = &d_arm_output[r * ncycles];
+            gr_complex* dst = fft_in + d_idxlut[r % d_nfilts];
+            for (size_t oo = first; oo < o0 + nb; oo += d_output_multiple) {
+                dst[(oo - o0) * d_nfilts] = arm[oo / d_output_multiple];
+            }
+        }
 
-        // despin through FFT
-        d_fft.execute();
+        d_batch_fft->execute();
 
         // Send to output channels
-        for (unsigned int nn = 0; nn < noutputs; nn++) {
-            out = work_output[nn]->items<gr_complex>();
-            out[oo] = d_fft.get_outbuf()[d_channel_map[nn]];
+        for (size_t nn = 0; nn < noutputs; nn++) {
+            auto out = work_output[nn]->items<gr_complex>() + o0;
+            const gr_complex* src = fft_out + d_channel_map[nn];
+            for (size_t b = 0; b < nb; b++) {
+                out[b] = src[b * d_nfilts];
+            }
         }
-        oo++;
     }
 
-    this->consume_each(toconsume, work_input);
-    // this->produce_each(noutput_items - (d_history / d_nchans - 1), work_output);
+    this->consume_each(toconsume * d_nchans, work_input);
     this->produce_each(noutput_items, work_output);
     return work_return_code_t::WORK_OK;
 }
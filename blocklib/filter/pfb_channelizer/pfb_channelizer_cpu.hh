@@ -3,6 +3,7 @@
 #include <gnuradio/filter/pfb_channelizer.hh>
 #include <gnuradio/filter/polyphase_filterbank.h>
 
+#include <memory>
 #include <mutex>
 
 namespace gr {
@@ -22,6 +23,16 @@ public:
     void set_taps(const std::vector<float>& taps) override;
 
 private:
+    void build_schedule();
+    void deinterleave(const T* in, size_t nframes);
+
+    // Arm filtering FFT input j for the q-th output of a cycle, and the frame its
+    // filter starts at
+    struct arm_step {
+        unsigned int arm;
+        unsigned int frame;
+    };
+
     bool d_updated = false;
     float d_oversample_rate;
     std::vector<int> d_idxlut;
@@ -30,7 +41,15 @@ private:
     std::vector<int> d_channel_map;
     std::mutex d_mutex; // mutex to protect set/work access
 
-    size_t d_history = 1;
+    // The arm steps repeat every d_output_multiple outputs, which consume
+    // d_frames_per_cycle frames
+    std::vector<arm_step> d_schedule;
+    unsigned int d_frames_per_cycle;
+
+    // Kept across calls so work() does not allocate once they have grown
+    std::vector<gr_complex> d_channels;   // deinterleaved input, one row per channel
+    std::vector<gr_complex> d_arm_output; // arm outputs, one row per (q, j)
+    std::unique_ptr<fft::fft_complex_rev> d_batch_fft;
 
     size_t d_nchans;
 };
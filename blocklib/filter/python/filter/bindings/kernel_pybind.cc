@@ -0,0 +1,105 @@
+/*
+ * Copyright 2020 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#include <pybind11/complex.h>
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+#include <gnuradio/filter/fft_filter.h>
+#include <gnuradio/filter/fir_filter.hh>
+
+#include <stdexcept>
+
+namespace {
+
+constexpr int array_flags = py::array::c_style | py::array::forcecast;
+
+// Number of decimated outputs the input covers, the first ntaps - 1 samples being
+// the history
+size_t num_outputs(size_t ninput, unsigned int ntaps, unsigned int decimation)
+{
+    if (ninput < ntaps) {
+        return 0;
+    }
+    return (ninput - ntaps) / decimation + 1;
+}
+
+template <class IN_T, class OUT_T, class TAP_T>
+void bind_fir_kernel(py::module& m, const char* name)
+{
+    using filt = gr::filter::kernel::fir_filter<IN_T, OUT_T, TAP_T>;
+
+    py::class_<filt, std::shared_ptr<filt>>(m, name)
+        .def(py::init<const std::vector<TAP_T>&>(), py::arg("taps"))
+        .def("set_taps", &filt::set_taps, py::arg("taps"))
+        .def("taps", &filt::taps)
+        .def("ntaps", &filt::ntaps)
+        .def(
+            "filter",
+            [](filt& self, py::array_t<IN_T, array_flags> input, unsigned int decimation) {
+                if (decimation < 1) {
+                    throw std::invalid_argument("fir_filter: decimation must be at least 1");
+                }
+                auto n = num_outputs(input.size(), self.ntaps(), decimation);
+                py::array_t<OUT_T> output(n);
+                self.filterNdec(output.mutable_data(), input.data(), n, decimation);
+                return output;
+            },
+            py::arg("input"),
+            py::arg("decimation") = 1);
+}
+
+template <class IN_T, class OUT_T, class TAP_T>
+void bind_fft_kernel(py::module& m, const char* name)
+{
+    using filt = gr::filter::kernel::fft_filter<IN_T, OUT_T, TAP_T>;
+
+    py::class_<filt, std::shared_ptr<filt>>(m, name)
+        .def(py::init<int, const std::vector<TAP_T>&, int>(),
+             py::arg("decimation"),
+             py::arg("taps"),
+             py::arg("nthreads") = 1)
+        .def("set_taps", &filt::set_taps, py::arg("taps"))
+        .def("taps", &filt::taps)
+        .def("ntaps", &filt::ntaps)
+        .def("fftsize", &filt::fftsize)
+        .def("decimation", &filt::decimation)
+        .def("set_nthreads", &filt::set_nthreads, py::arg("n"))
+        .def("nthreads", &filt::nthreads)
+        .def(
+            "filter",
+            [](filt& self, py::array_t<IN_T, array_flags> input) {
+                auto n = num_outputs(input.size(), self.ntaps(), self.decimation());
+                py::array_t<OUT_T> output(n);
+                self.filter(n, input.data(), output.mutable_data());
+                return output;
+            },
+            py::arg("input"));
+}
+
+} // namespace
+
+// The filter kernels on their own, outside of any block.  Both take the input with
+// ntaps - 1 samples of history in front, like the blocks see it
+void bind_kernel(py::module& m)
+{
+    auto k = m.def_submodule("kernel", "Filter kernels");
+
+    bind_fir_kernel<float, float, float>(k, "fir_filter_fff");
+    bind_fir_kernel<gr_complex, gr_complex, float>(k, "fir_filter_ccf");
+    bind_fir_kernel<gr_complex, gr_complex, gr_complex>(k, "fir_filter_ccc");
+    bind_fir_kernel<float, gr_complex, gr_complex>(k, "fir_filter_fcc");
+
+    bind_fft_kernel<float, float, float>(k, "fft_filter_fff");
+    bind_fft_kernel<gr_complex, gr_complex, float>(k, "fft_filter_ccf");
+    bind_fft_kernel<gr_complex, gr_complex, gr_complex>(k, "fft_filter_ccc");
+}
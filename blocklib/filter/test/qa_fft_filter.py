@@ -0,0 +1,91 @@
+#!/usr/bin/env python3
+#
+# Copyright 2004,2005,2007,2010,2012 Free Software Foundation, Inc.
+#
+# This file is part of GNU Radio
+#
+# SPDX-License-Identifier: GPL-3.0-or-later
+#
+#
+
+
+from newsched import gr, gr_unittest, filter, blocks
+import random
+
+
+def reference_filter(x, taps, decim=1):
+    y = []
+    x2 = (len(taps) - 1) * [0, ] + list(x)
+    for i in range(0, len(x), decim):
+        yi = 0
+        for j in range(len(taps)):
+            yi += taps[len(taps) - 1 - j] * x2[i + j]
+        y.append(yi)
+    return y
+
+
+def random_floats(n):
+    return [random.uniform(-1.0, 1.0) for _ in range(n)]
+
+
+def random_complex(n):
+    return [complex(random.uniform(-1.0, 1.0), random.uniform(-1.0, 1.0))
+            for _ in range(n)]
+
+
+class test_fft_filter(gr_unittest.TestCase):
+
+    def setUp(self):
+        random.seed(0)
+        self.tb = gr.flowgraph()
+
+    def tearDown(self):
+        self.tb = None
+
+    def run_block(self, src, op, dst):
+        self.tb.connect(src, 0, op, 0)
+        self.tb.connect(op, 0, dst, 0)
+        self.tb.run()
+        return dst.data()
+
+    def test_fff_001(self):
+        taps = random_floats(101)
+        src_data = random_floats(10000)
+        for decim in (1, 3):
+            self.setUp()
+            expected_data = reference_filter(src_data, taps, decim)
+            result_data = self.run_block(blocks.vector_source_f(src_data),
+                                         filter.fft_filter_fff(decim, taps),
+                                         blocks.vector_sink_f())
+            self.assertFloatTuplesAlmostEqual(expected_data, result_data, 4)
+
+    def test_ccf_001(self):
+        taps = random_floats(257)
+        src_data = random_complex(10000)
+        for decim in (1, 4):
+            self.setUp()
+            expected_data = reference_filter(src_data, taps, decim)
+            result_data = self.run_block(blocks.vector_source_c(src_data),
+                                         filter.fft_filter_ccf(decim, taps),
+                                         blocks.vector_sink_c())
+            self.assertComplexTuplesAlmostEqual(expected_data, result_data, 4)
+
+    def test_kernel_matches_direct(self):
+        # The kernels take the history in front of the input, as the blocks do
+        for ntaps in (1, 16, 100):
+            taps = random_floats(ntaps)
+            src_data = random_complex(1000 + ntaps - 1)
+            for decim in (1, 5):
+                direct = filter.kernel.fir_filter_ccf(taps).filter(src_data, decim)
+                fast = filter.kernel.fft_filter_ccf(decim, taps).filter(src_data)
+                self.assertComplexTuplesAlmostEqual(direct, fast, 4)
+
+    def test_max_ntaps(self):
+        # The history is reserved for max_ntaps, set_taps may not go past it
+        op = filter.fft_filter_fff(1, random_floats(11), 1, 21)
+        op.set_taps(random_floats(21))
+        self.assertRaises(ValueError, op.set_taps, random_floats(22))
+
+
+if __name__ == '__main__':
+    gr_unittest.run(test_fft_filter)
@@ -10,6 +10,7 @@
 
 
 from newsched import gr, gr_unittest, filter, blocks
+import random
 
 
 def fir_filter(x, taps, decim=1):
@@ -188,5 +189,50 @@ class test_filter(gr_unittest.TestCase):
         self.assertComplexTuplesAlmostEqual(expected_data, result_data, 5)
 
 
+def random_floats(n):
+    return [random.uniform(-1.0, 1.0) for _ in range(n)]
+
+
+def random_complex(n):
+    return [complex(random.uniform(-1.0, 1.0), random.uniform(-1.0, 1.0))
+            for _ in range(n)]
+
+
+class test_fir_kernel(gr_unittest.TestCase):
+
+    def setUp(self):
+        random.seed(0)
+
+    def check_kernel(self, kernel, make_input, make_taps, assert_equal):
+        # The block kernels compute 16 or 32 outputs at a time and filterNdec works
+        # in chunks of 2048 outputs per phase, none of these lengths is a multiple
+        for ntaps in (1, 5, 33):
+            taps = make_taps(ntaps)
+            for noutputs in (1, 15, 17, 33, 1001, 2049):
+                for decim in (1, 2, 3, 8):
+                    src_data = make_input(noutputs * decim)
+                    padded = (ntaps - 1) * [0, ] + src_data
+                    expected_data = fir_filter(src_data, taps, decim)
+                    result_data = kernel(taps).filter(padded, decim)
+                    self.assertEqual(len(result_data), noutputs)
+                    assert_equal(expected_data, result_data, 4)
+
+    def test_fff(self):
+        self.check_kernel(filter.kernel.fir_filter_fff, random_floats,
+                          random_floats, self.assertFloatTuplesAlmostEqual)
+
+    def test_ccf(self):
+        self.check_kernel(filter.kernel.fir_filter_ccf, random_complex,
+                          random_floats, self.assertComplexTuplesAlmostEqual)
+
+    def test_ccc(self):
+        self.check_kernel(filter.kernel.fir_filter_ccc, random_complex,
+                          random_complex, self.assertComplexTuplesAlmostEqual)
+
+    def test_fcc(self):
+        self.check_kernel(filter.kernel.fir_filter_fcc, random_floats,
+                          random_complex, self.assertComplexTuplesAlmostEqual)
+
+
 if __name__ == '__main__':
     gr_unittest.run(test_filter)
@@ -24,7 +24,7 @@
 from newsched import gr, gr_unittest, blocks, filter
 import numpy as np
 
-import math, random
+import math, random, time
 
 def make_random_complex_tuple(L, scale=1):
     result = []
@@ -165,6 +165,40 @@ class test_moving_average(gr_unittest.TestCase):
 
         self.assertFloatTuplesAlmostEqual(expected_result, dst_data, 7)
 
+    def test_max_length(self):
+        # The history is reserved for max_length, set_length may not go past it
+        op = filter.moving_average_ff(100, 1.0, 4000, 1, 200)
+        op.set_length(200)
+        self.assertRaises(ValueError, op.set_length, 201)
+
+    def test_length_change(self):
+        # A longer length and a new scale while running, taken up through the
+        # history that already holds max_length items of the input
+        src = blocks.vector_source_f([1.0], True)
+        throttle = blocks.throttle(100000, True, gr.sizeof_float)
+        op = filter.moving_average_ff(10, 1.0, 4000, 1, 50)
+        head = blocks.head(50000, gr.sizeof_float)
+        dst = blocks.vector_sink_f()
+
+        self.tb.connect([src, throttle, op, head, dst])
+        self.tb.start()
+        time.sleep(0.1)
+        op.set_length(40)
+        op.set_scale(0.5)
+        self.tb.wait()
+
+        dst_data = dst.data()
+        self.assertEqual(len(dst_data), 50000)
+        self.assertFloatTuplesAlmostEqual(list(range(1, 10)), dst_data[:9], 4)
+
+        # The old sum, then the new length at the old scale if a call came
+        # between the two changes, then the new sum
+        stages = {10: 0, 40: 1, 20: 2}
+        seen = [stages[round(x)] for x in dst_data[9:]]
+        self.assertEqual(seen[0], 0)
+        self.assertEqual(seen[-1], 2)
+        self.assertEqual(seen, sorted(seen))
+
     # This tests implement own moving average to verify correct behaviour of the block
 
     # def test_03(self):
@@ -9,7 +9,7 @@
 #
 
 
-from newsched import gr, gr_unittest, fft, filter, blocks, streamops, math as grmath
+from newsched import gr, gr_unittest, fft, filter, blocks
 import math
 import cmath
 
@@ -28,8 +28,8 @@ class test_pfb_channelizer(gr_unittest.TestCase):
         self.freqs = [110., -513., 203., -230, 121]
         # Number of channels to channelize.
         self.M = len(self.freqs)
-        # Number of samples to use.
-        self.N = 1000
+        # Number of samples to use, per channel.
+        self.N = 8000
         # Baseband sampling rate.
         self.fs = 5000
         # Input samp rate to channelizer.
@@ -40,7 +40,8 @@ class test_pfb_channelizer(gr_unittest.TestCase):
             attenuation_dB=80,
             window=fft.window.WIN_BLACKMAN_hARRIS)
 
-        self.Ntest = 50
+        # Buffer size in bytes, for 32768 items per work call
+        self.bufsize = 1 << 18
 
     def tearDown(self):
         self.tb = None
@@ -49,6 +50,18 @@ class test_pfb_channelizer(gr_unittest.TestCase):
         self.check_channelizer(filter.pfb_channelizer_cc(
             self.M, taps=self.taps, oversample_rate=1))
 
+    def test_0000_fft_filters(self):
+        self.check_channelizer(filter.pfb_channelizer_cc(
+            self.M, taps=self.taps, oversample_rate=1, use_fft_filters=True))
+
+    def test_oversampled(self):
+        """Oversample by M/2, and by M, where every arm filters every frame."""
+        for oversample_rate in (self.M / 2, self.M):
+            for use_fft_filters in (False, True):
+                self.tb = gr.flowgraph()
+                self.check_channelizer(filter.pfb_channelizer_cc(
+                    self.M, taps=self.taps, oversample_rate=oversample_rate,
+                    use_fft_filters=use_fft_filters), oversample_rate)
 
     # def test_0001(self):
     #     self.check_channelizer(filter.pfb.channelizer_hier_ccf(
@@ -68,40 +81,41 @@ class test_pfb_channelizer(gr_unittest.TestCase):
                           36, taps=self.taps, oversample_rate=10.1334)
 
 
-    def check_channelizer(self, channelizer_block):
-        signals = list()
-        add = grmath.add_cc(len(self.freqs))
+    def check_channelizer(self, channelizer_block, oversample_rate=1):
+        # The channelizer takes the channels interleaved on its one input
+        data = [0j] * (self.M * self.N)
         for i in range(len(self.freqs)):
             f = self.freqs[i] + i * self.fs
-            data = sig_source_c(self.ifs, f, 1, self.N)
-            signals.append(blocks.vector_source_c(data))
-            self.tb.connect(signals[i],0 , add, i)
+            for n, x in enumerate(sig_source_c(self.ifs, f, 1, self.M * self.N)):
+                data[n] += x
+        src = blocks.vector_source_c(data)
 
-        s2ss = streamops.stream_to_streams(gr.sizeof_gr_complex, self.M)
-
-        self.tb.connect(add, 0, s2ss, 0)
-        # self.tb.connect(add, channelizer_block)
+        # Buffers large enough for a work call to span several of the batched
+        # FFTs, which take about 8192 items' worth of frames each
+        self.tb.connect(src, 0, channelizer_block, 0).set_custom_buffer(
+            gr.buffer_cpu_vmcirc_properties.make().set_buffer_size(self.bufsize))
 
         snks = list()
         for i in range(self.M):
             snks.append(blocks.vector_sink_c())
-            self.tb.connect(s2ss,i, channelizer_block,i)
-            self.tb.connect(channelizer_block, i, snks[i],0)
+            self.tb.connect(channelizer_block, i, snks[i], 0).set_custom_buffer(
+                gr.buffer_cpu_vmcirc_properties.make().set_buffer_size(self.bufsize))
 
         self.tb.run()
 
         L = len(snks[0].data())
+        self.assertEqual(L, int(self.N * oversample_rate))
 
-        expected_data = self.get_expected_data(L)
+        expected_data = self.get_expected_data(L, oversample_rate)
         received_data = [snk.data() for snk in snks]
 
+        # Past the first taps_per_filter frames, which filter the zero history
+        tpf = math.ceil(len(self.taps) / float(self.M))
+        start = int(math.ceil((tpf + 1) * oversample_rate))
         for expected, received in zip(expected_data, received_data):
-            self.compare_data(expected, received)
+            self.compare_data(expected[start:], received[start:])
 
     def compare_data(self, expected, received):
-        Ntest = 50
-        expected = expected[-Ntest:]
-        received = received[-Ntest:]
         expected = [x / expected[0] for x in expected]
         received = [x / received[0] for x in received]
         self.assertComplexTuplesAlmostEqual(expected, received, 3)
@@ -119,7 +133,7 @@ class test_pfb_channelizer(gr_unittest.TestCase):
         freq /= 2 * math.pi
         return freq
 
-    def get_expected_data(self, L):
+    def get_expected_data(self, L, oversample_rate=1):
 
         # Filter delay is the normal delay of each arm
         tpf = math.ceil(len(self.taps) / float(self.M))
@@ -127,7 +141,9 @@ class test_pfb_channelizer(gr_unittest.TestCase):
         delay = int(delay)
 
         # Create a time scale that's delayed to match the filter delay
-        t = [float(x) / self.fs for x in range(delay, L + delay)]
+        # The outputs come oversample_rate times faster than the channel rate
+        t = [float(x) / (self.fs * oversample_rate)
+             for x in range(delay, L + delay)]
 
         # Create known data as complex sinusoids at the different baseband freqs
         # the different channel numbering is due to channelizer output order.
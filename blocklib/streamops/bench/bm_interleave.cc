@@ -0,0 +1,96 @@
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include <gnuradio/streamops/interleave.hh>
+
+#include "bench_utils.hh"
+
+#include "CLI/App.hpp"
+#include "CLI/Config.hpp"
+#include "CLI/Formatter.hpp"
+
+using namespace gr::streamops::kernel;
+using namespace gr::bench;
+
+namespace {
+
+void bm_interleave(size_t itemsize, size_t nstreams, size_t nitems, double min_time)
+{
+    std::vector<uint8_t> interleaved(nitems * nstreams * itemsize);
+    for (size_t i = 0; i < interleaved.size(); i++) {
+        interleaved[i] = i;
+    }
+    std::vector<std::vector<uint8_t>> streams(nstreams, std::vector<uint8_t>(nitems * itemsize));
+    std::vector<uint8_t*> out;
+    std::vector<const uint8_t*> in;
+    for (auto& s : streams) {
+        out.push_back(s.data());
+        in.push_back(s.data());
+    }
+
+    // One memcpy per item per stream, what stream_to_streams used to do
+    auto per_item = time_per_call(
+        [&] {
+            const uint8_t* p = interleaved.data();
+            for (size_t i = 0; i < nitems; i++) {
+                for (size_t j = 0; j < nstreams; j++) {
+                    memcpy(out[j] + i * itemsize, p, itemsize);
+                    p += itemsize;
+                }
+            }
+        },
+        min_time);
+    auto kernel = time_per_call(
+        [&] { deinterleave(interleaved.data(), out.data(), nstreams, itemsize, nitems); },
+        min_time);
+
+    char label[64];
+    snprintf(label, sizeof(label), "deinterleave/%zu/%zu", itemsize, nstreams);
+    print_row(label, per_item, kernel, interleaved.size());
+
+    per_item = time_per_call(
+        [&] {
+            uint8_t* p = interleaved.data();
+            for (size_t i = 0; i < nitems; i++) {
+                for (size_t j = 0; j < nstreams; j++) {
+                    memcpy(p, in[j] + i * itemsize, itemsize);
+                    p += itemsize;
+                }
+            }
+        },
+        min_time);
+    kernel = time_per_call(
+        [&] { interleave(in.data(), interleaved.data(), nstreams, itemsize, nitems); },
+        min_time);
+
+    snprintf(label, sizeof(label), "interleave/%zu/%zu", itemsize, nstreams);
+    print_row(label, per_item, kernel, interleaved.size());
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    std::vector<size_t> itemsizes = { 1, 2, 4, 8, 16 };
+    std::vector<size_t> nstreams = { 2, 4, 8 };
+    size_t nitems = 8192;
+    double min_time = 0.5;
+
+    CLI::App app{ "Stream (de)interleave benchmark, per item memcpy vs kernel" };
+
+    app.add_option("--itemsize", itemsizes, "Item sizes to run");
+    app.add_option("--nstreams", nstreams, "Stream counts to run");
+    app.add_option("--nitems", nitems, "Items of each stream per call");
+    app.add_option("--min_time", min_time, "Minimum seconds per measurement");
+
+    CLI11_PARSE(app, argc, argv);
+
+    print_header("per-item ns", "kernel ns", "MB/s");
+    for (auto s : itemsizes) {
+        for (auto n : nstreams) {
+            bm_interleave(s, n, nitems, min_time);
+        }
+    }
+}
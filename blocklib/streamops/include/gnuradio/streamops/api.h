@@ -0,0 +1,18 @@
+/*
+ * Copyright 2021 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#pragma once
+
+#include <gnuradio/attributes.h>
+
+#ifdef gnuradio_streamops_EXPORTS
+#define STREAMOPS_API __GR_ATTR_EXPORT
+#else
+#define STREAMOPS_API __GR_ATTR_IMPORT
+#endif
@@ -0,0 +1,56 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2021 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#pragma once
+
+#include <gnuradio/streamops/api.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace gr {
+namespace streamops {
+namespace kernel {
+
+/*!
+ * \brief Splits \p nitems items of each of \p nstreams streams, interleaved item by
+ * item in \p in, out to one buffer per stream.
+ *
+ * Items of 1, 2, 4 or 8 bytes over 2, 4 or 8 streams are split a vector register
+ * at a time, by unzipping pairs of registers into their even and odd items once
+ * per power of two streams; 16 byte items are copied an item at a time, with the
+ * size known at compile time.  Other item sizes and stream counts copy an item at
+ * a time.
+ */
+STREAMOPS_API void deinterleave(const uint8_t* in,
+                                uint8_t* const* out,
+                                size_t nstreams,
+                                size_t itemsize,
+                                size_t nitems);
+
+/*!
+ * \brief The inverse of deinterleave(), merging \p nitems items of each of the
+ * \p nstreams buffers in \p in into \p out, one item of each stream in turn.
+ */
+STREAMOPS_API void interleave(const uint8_t* const* in,
+                              uint8_t* out,
+                              size_t nstreams,
+                              size_t itemsize,
+                              size_t nitems);
+
+/*!
+ * \brief Swaps the two shorts of each of the \p npairs pairs from \p in into \p out,
+ * which may be the same buffer.
+ */
+STREAMOPS_API void swap_pairs(const int16_t* in, int16_t* out, size_t npairs);
+
+} // namespace kernel
+} // namespace streamops
+} // namespace gr
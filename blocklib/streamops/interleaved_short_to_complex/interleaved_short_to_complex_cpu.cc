@@ -10,6 +10,7 @@
 
 #include "interleaved_short_to_complex_cpu.hh"
 #include "interleaved_short_to_complex_cpu_gen.hh"
+#include <gnuradio/streamops/interleave.hh>
 #include <volk/volk.h>
 
 namespace gr {
@@ -35,17 +36,18 @@ interleaved_short_to_complex_cpu::work(std::vector<block_work_input_sptr>& work_
 
     auto noutput_items = work_output[0]->n_items;
 
-    // This calculates in[] * 1.0 / d_scalar
-    volk_16i_s32f_convert_32f(out, in, d_scalar, 2 * noutput_items);
-
+    // Swapped on the shorts, half the bytes of the floats
     if (d_swap) {
-        for (int i = 0; i < noutput_items; ++i) {
-            float f = out[2 * i + 1];
-            out[2 * i + 1] = out[2 * i];
-            out[2 * i] = f;
+        if (d_swapped.size() < 2 * (size_t)noutput_items) {
+            d_swapped.resize(2 * noutput_items);
         }
+        kernel::swap_pairs(in, d_swapped.data(), noutput_items);
+        in = d_swapped.data();
     }
 
+    // This calculates in[] * 1.0 / d_scalar
+    volk_16i_s32f_convert_32f(out, in, d_scalar, 2 * noutput_items);
+
     work_output[0]->n_produced = noutput_items;
     return work_return_code_t::WORK_OK;
 }
@@ -20,6 +20,7 @@ public:
 private:
     float d_scalar;
     bool d_swap;
+    std::vector<int16_t> d_swapped;
 };
 
 
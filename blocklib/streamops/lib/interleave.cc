@@ -0,0 +1,345 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2021 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#include <gnuradio/streamops/interleave.hh>
+
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define STREAMOPS_VECTOR
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define STREAMOPS_VECTOR
+#endif
+
+namespace gr {
+namespace streamops {
+namespace kernel {
+
+namespace {
+
+// An item at a time, for any number of streams
+template <size_t S>
+void deinterleave_items(const uint8_t* in,
+                        uint8_t* const* out,
+                        size_t nstreams,
+                        size_t itemsize,
+                        size_t begin,
+                        size_t end)
+{
+    // S is 0 when the item size is only known at run time
+    const size_t size = S ? S : itemsize;
+    for (size_t i = begin; i < end; i++) {
+        const uint8_t* src = in + i * nstreams * size;
+        for (size_t j = 0; j < nstreams; j++) {
+            memcpy(out[j] + i * size, src + j * size, S ? S : size);
+        }
+    }
+}
+
+template <size_t S>
+void interleave_items(const uint8_t* const* in,
+                      uint8_t* out,
+                      size_t nstreams,
+                      size_t itemsize,
+                      size_t begin,
+                      size_t end)
+{
+    const size_t size = S ? S : itemsize;
+    for (size_t i = begin; i < end; i++) {
+        uint8_t* dst = out + i * nstreams * size;
+        for (size_t j = 0; j < nstreams; j++) {
+            memcpy(dst + j * size, in[j] + i * size, S ? S : size);
+        }
+    }
+}
+
+#ifdef STREAMOPS_VECTOR
+
+#if defined(__SSE2__)
+using vec = __m128i;
+
+inline vec load(const uint8_t* p) { return _mm_loadu_si128(reinterpret_cast<const vec*>(p)); }
+inline void store(uint8_t* p, vec v) { _mm_storeu_si128(reinterpret_cast<vec*>(p), v); }
+
+// The even and the odd items of the 32 bytes in a then b
+template <size_t S>
+void unzip(vec a, vec b, vec& even, vec& odd)
+{
+    if constexpr (S == 1) {
+        const vec mask = _mm_set1_epi16(0x00ff);
+        even = _mm_packus_epi16(_mm_and_si128(a, mask), _mm_and_si128(b, mask));
+        odd = _mm_packus_epi16(_mm_srli_epi16(a, 8), _mm_srli_epi16(b, 8));
+    } else if constexpr (S == 2) {
+        // Sign extended, so the saturating pack keeps them as they are
+        even = _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(a, 16), 16),
+                               _mm_srai_epi32(_mm_slli_epi32(b, 16), 16));
+        odd = _mm_packs_epi32(_mm_srai_epi32(a, 16), _mm_srai_epi32(b, 16));
+    } else if constexpr (S == 4) {
+        auto fa = _mm_castsi128_ps(a);
+        auto fb = _mm_castsi128_ps(b);
+        even = _mm_castps_si128(_mm_shuffle_ps(fa, fb, _MM_SHUFFLE(2, 0, 2, 0)));
+        odd = _mm_castps_si128(_mm_shuffle_ps(fa, fb, _MM_SHUFFLE(3, 1, 3, 1)));
+    } else if constexpr (S == 8) {
+        even = _mm_unpacklo_epi64(a, b);
+        odd = _mm_unpackhi_epi64(a, b);
+    } else {
+        even = a;
+        odd = b;
+    }
+}
+
+// The items of a and b taken in turn, the first 16 bytes of them in lo
+template <size_t S>
+void zip(vec a, vec b, vec& lo, vec& hi)
+{
+    if constexpr (S == 1) {
+        lo = _mm_unpacklo_epi8(a, b);
+        hi = _mm_unpackhi_epi8(a, b);
+    } else if constexpr (S == 2) {
+        lo = _mm_unpacklo_epi16(a, b);
+        hi = _mm_unpackhi_epi16(a, b);
+    } else if constexpr (S == 4) {
+        lo = _mm_unpacklo_epi32(a, b);
+        hi = _mm_unpackhi_epi32(a, b);
+    } else if constexpr (S == 8) {
+        lo = _mm_unpacklo_epi64(a, b);
+        hi = _mm_unpackhi_epi64(a, b);
+    } else {
+        lo = a;
+        hi = b;
+    }
+}
+
+#else
+using vec = uint8x16_t;
+
+inline vec load(const uint8_t* p) { return vld1q_u8(p); }
+inline void store(uint8_t* p, vec v) { vst1q_u8(p, v); }
+
+template <size_t S>
+void unzip(vec a, vec b, vec& even, vec& odd)
+{
+    if constexpr (S == 1) {
+        even = vuzp1q_u8(a, b);
+        odd = vuzp2q_u8(a, b);
+    } else if constexpr (S == 2) {
+        even = vreinterpretq_u8_u16(vuzp1q_u16(vreinterpretq_u16_u8(a), vreinterpretq_u16_u8(b)));
+        odd = vreinterpretq_u8_u16(vuzp2q_u16(vreinterpretq_u16_u8(a), vreinterpretq_u16_u8(b)));
+    } else if constexpr (S == 4) {
+        even = vreinterpretq_u8_u32(vuzp1q_u32(vreinterpretq_u32_u8(a), vreinterpretq_u32_u8(b)));
+        odd = vreinterpretq_u8_u32(vuzp2q_u32(vreinterpretq_u32_u8(a), vreinterpretq_u32_u8(b)));
+    } else if constexpr (S == 8) {
+        even = vreinterpretq_u8_u64(vuzp1q_u64(vreinterpretq_u64_u8(a), vreinterpretq_u64_u8(b)));
+        odd = vreinterpretq_u8_u64(vuzp2q_u64(vreinterpretq_u64_u8(a), vreinterpretq_u64_u8(b)));
+    } else {
+        even = a;
+        odd = b;
+    }
+}
+
+template <size_t S>
+void zip(vec a, vec b, vec& lo, vec& hi)
+{
+    if constexpr (S == 1) {
+        lo = vzip1q_u8(a, b);
+        hi = vzip2q_u8(a, b);
+    } else if constexpr (S == 2) {
+        lo = vreinterpretq_u8_u16(vzip1q_u16(vreinterpretq_u16_u8(a), vreinterpretq_u16_u8(b)));
+        hi = vreinterpretq_u8_u16(vzip2q_u16(vreinterpretq_u16_u8(a), vreinterpretq_u16_u8(b)));
+    } else if constexpr (S == 4) {
+        lo = vreinterpretq_u8_u32(vzip1q_u32(vreinterpretq_u32_u8(a), vreinterpretq_u32_u8(b)));
+        hi = vreinterpretq_u8_u32(vzip2q_u32(vreinterpretq_u32_u8(a), vreinterpretq_u32_u8(b)));
+    } else if constexpr (S == 8) {
+        lo = vreinterpretq_u8_u64(vzip1q_u64(vreinterpretq_u64_u8(a), vreinterpretq_u64_u8(b)));
+        hi = vreinterpretq_u8_u64(vzip2q_u64(vreinterpretq_u64_u8(a), vreinterpretq_u64_u8(b)));
+    } else {
+        lo = a;
+        hi = b;
+    }
+}
+#endif
+
+// Each unzip leaves the even items in the first half and the odd ones in the
+// second, so stream j ends up in register j with its log2(N) bits reversed
+template <size_t N>
+constexpr size_t bit_reverse(size_t j)
+{
+    size_t r = 0;
+    for (size_t b = 1; b < N; b <<= 1) {
+        r = (r << 1) | (j & 1);
+        j >>= 1;
+    }
+    return r;
+}
+
+template <size_t S, size_t N>
+void deinterleave_vector(const uint8_t* in, uint8_t* const* out, size_t nitems)
+{
+    // Items of each stream in one register
+    constexpr size_t per_vector = 16 / S;
+
+    size_t i = 0;
+    for (; i + per_vector <= nitems; i += per_vector) {
+        vec v[N], t[N];
+        for (size_t j = 0; j < N; j++) {
+            v[j] = load(in + i * N * S + j * 16);
+        }
+        // Unrolled, so the registers stay registers
+#pragma GCC unroll 8
+        for (size_t w = N; w > 1; w /= 2) {
+#pragma GCC unroll 8
+            for (size_t g = 0; g < N; g += w) {
+                for (size_t j = 0; j < w / 2; j++) {
+                    unzip<S>(v[g + 2 * j], v[g + 2 * j + 1], t[g + j], t[g + w / 2 + j]);
+                }
+            }
+            for (size_t j = 0; j < N; j++) {
+                v[j] = t[j];
+            }
+        }
+        for (size_t j = 0; j < N; j++) {
+            store(out[j] + i * S, v[bit_reverse<N>(j)]);
+        }
+    }
+    deinterleave_items<S>(in, out, N, S, i, nitems);
+}
+
+template <size_t S, size_t N>
+void interleave_vector(const uint8_t* const* in, uint8_t* out, size_t nitems)
+{
+    constexpr size_t per_vector = 16 / S;
+
+    size_t i = 0;
+    for (; i + per_vector <= nitems; i += per_vector) {
+        vec v[N], t[N];
+        for (size_t j = 0; j < N; j++) {
+            v[bit_reverse<N>(j)] = load(in[j] + i * S);
+        }
+#pragma GCC unroll 8
+        for (size_t w = 2; w <= N; w *= 2) {
+#pragma GCC unroll 8
+            for (size_t g = 0; g < N; g += w) {
+                for (size_t j = 0; j < w / 2; j++) {
+                    zip<S>(v[g + j], v[g + w / 2 + j], t[g + 2 * j], t[g + 2 * j + 1]);
+                }
+            }
+            for (size_t j = 0; j < N; j++) {
+                v[j] = t[j];
+            }
+        }
+        for (size_t j = 0; j < N; j++) {
+            store(out + i * N * S + j * 16, v[j]);
+        }
+    }
+    interleave_items<S>(in, out, N, S, i, nitems);
+}
+
+#endif
+
+// 16 byte items are whole registers, nothing to shuffle
+template <size_t S>
+void deinterleave_sized(const uint8_t* in, uint8_t* const* out, size_t nstreams, size_t nitems)
+{
+#ifdef STREAMOPS_VECTOR
+    switch (S < 16 ? nstreams : 0) {
+    case 2:
+        return deinterleave_vector<S, 2>(in, out, nitems);
+    case 4:
+        return deinterleave_vector<S, 4>(in, out, nitems);
+    case 8:
+        return deinterleave_vector<S, 8>(in, out, nitems);
+    }
+#endif
+    deinterleave_items<S>(in, out, nstreams, S, 0, nitems);
+}
+
+template <size_t S>
+void interleave_sized(const uint8_t* const* in, uint8_t* out, size_t nstreams, size_t nitems)
+{
+#ifdef STREAMOPS_VECTOR
+    switch (S < 16 ? nstreams : 0) {
+    case 2:
+        return interleave_vector<S, 2>(in, out, nitems);
+    case 4:
+        return interleave_vector<S, 4>(in, out, nitems);
+    case 8:
+        return interleave_vector<S, 8>(in, out, nitems);
+    }
+#endif
+    interleave_items<S>(in, out, nstreams, S, 0, nitems);
+}
+
+} // namespace
+
+void deinterleave(
+    const uint8_t* in, uint8_t* const* out, size_t nstreams, size_t itemsize, size_t nitems)
+{
+    switch (itemsize) {
+    case 1:
+        return deinterleave_sized<1>(in, out, nstreams, nitems);
+    case 2:
+        return deinterleave_sized<2>(in, out, nstreams, nitems);
+    case 4:
+        return deinterleave_sized<4>(in, out, nstreams, nitems);
+    case 8:
+        return deinterleave_sized<8>(in, out, nstreams, nitems);
+    case 16:
+        return deinterleave_sized<16>(in, out, nstreams, nitems);
+    default:
+        return deinterleave_items<0>(in, out, nstreams, itemsize, 0, nitems);
+    }
+}
+
+void interleave(
+    const uint8_t* const* in, uint8_t* out, size_t nstreams, size_t itemsize, size_t nitems)
+{
+    switch (itemsize) {
+    case 1:
+        return interleave_sized<1>(in, out, nstreams, nitems);
+    case 2:
+        return interleave_sized<2>(in, out, nstreams, nitems);
+    case 4:
+        return interleave_sized<4>(in, out, nstreams, nitems);
+    case 8:
+        return interleave_sized<8>(in, out, nstreams, nitems);
+    case 16:
+        return interleave_sized<16>(in, out, nstreams, nitems);
+    default:
+        return interleave_items<0>(in, out, nstreams, itemsize, 0, nitems);
+    }
+}
+
+void swap_pairs(const int16_t* in, int16_t* out, size_t npairs)
+{
+    size_t i = 0;
+#if defined(__SSE2__)
+    for (; i + 4 <= npairs; i += 4) {
+        auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 2 * i));
+        v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+        v = _mm_shufflehi_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2 * i), v);
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    for (; i + 4 <= npairs; i += 4) {
+        vst1q_s16(out + 2 * i, vrev32q_s16(vld1q_s16(in + 2 * i)));
+    }
+#endif
+    for (; i < npairs; i++) {
+        int16_t t = in[2 * i];
+        out[2 * i] = in[2 * i + 1];
+        out[2 * i + 1] = t;
+    }
+}
+
+} // namespace kernel
+} // namespace streamops
+} // namespace gr
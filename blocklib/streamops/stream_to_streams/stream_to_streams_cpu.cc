@@ -10,13 +10,16 @@
 
 #include "stream_to_streams_cpu.hh"
 #include "stream_to_streams_cpu_gen.hh"
-#include <volk/volk.h>
+#include <gnuradio/streamops/interleave.hh>
 
 namespace gr {
 namespace streamops {
 
 stream_to_streams_cpu::stream_to_streams_cpu(const block_args& args)
-    : block("stream_to_streams"), stream_to_streams(args), d_itemsize(args.itemsize)
+    : block("stream_to_streams"),
+      stream_to_streams(args),
+      d_itemsize(args.itemsize),
+      d_out_items(args.nstreams)
 {
 }
 
@@ -25,20 +28,16 @@ stream_to_streams_cpu::work(std::vector<block_work_input_sptr>& work_input,
                                        std::vector<block_work_output_sptr>& work_output)
 {
     auto in = work_input[0]->items<uint8_t>();
-
-    uint8_t * in_ptr = const_cast<uint8_t*>(in);
     auto noutput_items = work_output[0]->n_items;
     auto ninput_items = work_input[0]->n_items;
     size_t nstreams = work_output.size();
 
     auto total_items = std::min(ninput_items / nstreams, (size_t)noutput_items);
 
-    for (size_t i = 0; i < total_items; i++) {
-        for (size_t j = 0; j < nstreams; j++) {
-            memcpy(work_output[j]->items<uint8_t>()+i*d_itemsize, in_ptr, d_itemsize);
-            in_ptr += d_itemsize;
-        }
+    for (size_t j = 0; j < nstreams; j++) {
+        d_out_items[j] = work_output[j]->items<uint8_t>();
     }
+    kernel::deinterleave(in, d_out_items.data(), nstreams, d_itemsize, total_items);
 
     produce_each(total_items, work_output);
     consume_each(total_items*nstreams, work_input);
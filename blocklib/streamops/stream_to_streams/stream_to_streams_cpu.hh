@@ -15,6 +15,7 @@ public:
 
 private:
     size_t d_itemsize;
+    std::vector<uint8_t*> d_out_items;
 
 };
 
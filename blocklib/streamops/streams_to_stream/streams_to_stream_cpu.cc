@@ -0,0 +1,60 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2004,2009,2010,2012,2018 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#include "streams_to_stream_cpu.hh"
+#include "streams_to_stream_cpu_gen.hh"
+#include <gnuradio/streamops/interleave.hh>
+
+namespace gr {
+namespace streamops {
+
+streams_to_stream_cpu::streams_to_stream_cpu(const block_args& args)
+    : block("streams_to_stream"),
+      streams_to_stream(args),
+      d_itemsize(args.itemsize),
+      d_in_items(args.nstreams)
+{
+    set_relative_rate(args.nstreams);
+    set_output_multiple(args.nstreams);
+}
+
+work_return_code_t
+streams_to_stream_cpu::work(std::vector<block_work_input_sptr>& work_input,
+                            std::vector<block_work_output_sptr>& work_output)
+{
+    auto out = work_output[0]->items<uint8_t>();
+    size_t nstreams = work_input.size();
+
+    // One item of each input stream per nstreams output items
+    size_t total_items = work_output[0]->n_items / nstreams;
+    for (auto& w : work_input) {
+        total_items = std::min(total_items, (size_t)w->n_items);
+    }
+    if (total_items == 0) {
+        consume_each(0, work_input);
+        produce_each(0, work_output);
+        return (size_t)work_output[0]->n_items < nstreams
+                   ? work_return_code_t::WORK_INSUFFICIENT_OUTPUT_ITEMS
+                   : work_return_code_t::WORK_INSUFFICIENT_INPUT_ITEMS;
+    }
+
+    for (size_t j = 0; j < nstreams; j++) {
+        d_in_items[j] = work_input[j]->items<uint8_t>();
+    }
+    kernel::interleave(d_in_items.data(), out, nstreams, d_itemsize, total_items);
+
+    consume_each(total_items, work_input);
+    produce_each(total_items * nstreams, work_output);
+    return work_return_code_t::WORK_OK;
+}
+
+
+} /* namespace streamops */
+} /* namespace gr */
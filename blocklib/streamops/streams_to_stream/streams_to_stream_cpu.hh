@@ -0,0 +1,23 @@
+#pragma once
+
+#include <gnuradio/streamops/streams_to_stream.hh>
+
+namespace gr {
+namespace streamops {
+
+class streams_to_stream_cpu : public streams_to_stream
+{
+public:
+    streams_to_stream_cpu(const block_args& args);
+
+    virtual work_return_code_t work(std::vector<block_work_input_sptr>& work_input,
+                                    std::vector<block_work_output_sptr>& work_output) override;
+
+private:
+    size_t d_itemsize;
+    std::vector<const uint8_t*> d_in_items;
+};
+
+
+} // namespace streamops
+} // namespace gr
@@ -0,0 +1,67 @@
+#!/usr/bin/env python3
+#
+# Copyright 2021 Free Software Foundation, Inc.
+#
+# This file is part of GNU Radio
+#
+# SPDX-License-Identifier: GPL-3.0-or-later
+#
+#
+
+
+from newsched import gr, gr_unittest, blocks, streamops
+import random
+
+
+class test_interleave(gr_unittest.TestCase):
+
+    def setUp(self):
+        random.seed(0)
+
+    def deinterleave(self, src_data, nstreams, itemsize):
+        tb = gr.flowgraph()
+        src = blocks.vector_source_b(src_data, False, itemsize)
+        op = streamops.stream_to_streams(nstreams, itemsize)
+        dsts = [blocks.vector_sink_b(itemsize) for _ in range(nstreams)]
+        tb.connect(src, 0, op, 0)
+        for j in range(nstreams):
+            tb.connect(op, j, dsts[j], 0)
+        tb.run()
+        return [list(d.data()) for d in dsts]
+
+    def interleave(self, streams, itemsize):
+        tb = gr.flowgraph()
+        srcs = [blocks.vector_source_b(s, False, itemsize) for s in streams]
+        op = streamops.streams_to_stream(len(streams), itemsize)
+        dst = blocks.vector_sink_b(itemsize)
+        for j in range(len(streams)):
+            tb.connect(srcs[j], 0, op, j)
+        tb.connect(op, 0, dst, 0)
+        tb.run()
+        return list(dst.data())
+
+    def check(self, nstreams, itemsize, nitems):
+        src_data = [random.randint(0, 255) for _ in range(nstreams * nitems * itemsize)]
+        expected = [[] for _ in range(nstreams)]
+        for i in range(nitems):
+            for j in range(nstreams):
+                k = (i * nstreams + j) * itemsize
+                expected[j] += src_data[k:k + itemsize]
+
+        streams = self.deinterleave(src_data, nstreams, itemsize)
+        self.assertEqual(streams, expected)
+        self.assertEqual(self.interleave(streams, itemsize), src_data)
+
+    def test_vector_sizes(self):
+        # The item sizes and stream counts with their own shuffles
+        for itemsize in (1, 2, 4, 8, 16):
+            for nstreams in (2, 4, 8):
+                self.check(nstreams, itemsize, 1001)
+
+    def test_other_sizes(self):
+        for itemsize, nstreams in ((3, 2), (4, 3), (12, 5)):
+            self.check(nstreams, itemsize, 1001)
+
+
+if __name__ == '__main__':
+    gr_unittest.run(test_interleave)
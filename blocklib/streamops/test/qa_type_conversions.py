@@ -273,6 +273,18 @@ class test_type_conversions(gr_unittest.TestCase):
         self.tb.run()
         self.assertEqual(expected_data, dst.data())
 
+    def test_interleaved_short_to_complex_swap_scale(self):
+        src_data = list(range(-50, 50))
+        expected_data = [complex(src_data[i + 1] / 4.0, src_data[i] / 4.0)
+                         for i in range(0, len(src_data), 2)]
+        src = blocks.vector_source_s(src_data, vlen=2)
+        op = streamops.interleaved_short_to_complex(swap=True, scale_factor=4.0)
+        dst = blocks.vector_sink_c()
+        self.tb.connect(src, op)
+        self.tb.connect(op, dst)
+        self.tb.run()
+        self.assertEqual(expected_data, dst.data())
+
     # def test_short_to_char(self):
     #     src_data = (256, 512, 768, 1024, 1280)
     #     expected_data = [1, 2, 3, 4, 5]
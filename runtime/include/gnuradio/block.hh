@@ -1,5 +1,7 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
 #include <cstdint>
 #include <memory>
 #include <string>
@@ -11,6 +13,8 @@
 #include <gnuradio/neighbor_interface.hh>
 #include <gnuradio/node.hh>
 #include <gnuradio/parameter.hh>
+#include <gnuradio/perf_counters.hh>
+#include <gnuradio/timer_service.hh>
 
 #include <pmtf/map.hpp>
 #include <pmtf/string.hpp>
@@ -37,6 +41,11 @@ private:
     int d_output_multiple = 1;
     bool d_output_multiple_set = false;
     double d_relative_rate = 1.0;
+    std::atomic<unsigned int> d_history = 1;
+    unsigned int d_max_history = 1;
+    bool d_max_history_frozen = false;
+    perf_counters d_perf_counters;
+    std::atomic<int> d_pending_wakeups = 0;
 
 protected:
     neighbor_interface_sptr p_scheduler = nullptr;
@@ -95,6 +104,25 @@ public:
     };
 
     void set_parent_intf(neighbor_interface_sptr sched) { p_scheduler = sched; }
+
+    /**
+     * @brief Have the scheduler call work again at the given time
+     *
+     * The wake-up comes from the runtime timer service, so waiting costs no thread.
+     * For blocks that have nothing to do until some time has passed, e.g. a throttle,
+     * or that returned WORK_CALLBACK_INITIATED.
+     */
+    void notify_scheduler_at(timer_service::clock::time_point when);
+    /**
+     * @brief Whether a wake-up from notify_scheduler_at has yet to fire
+     *
+     * A block waiting on a timer is not blocked, and must not be taken as flushed
+     */
+    bool wakeup_pending() const
+    {
+        return d_pending_wakeups.load(std::memory_order_acquire) > 0;
+    }
+
     parameter_config d_parameters;
     void add_param(param_sptr p) { d_parameters.add(p); }
     pmtf::wrap request_parameter_query(int param_id);
@@ -109,8 +137,62 @@ public:
     void set_relative_rate(double relative_rate) { d_relative_rate = relative_rate; }
     double relative_rate() const { return d_relative_rate; }
 
+    /**
+     * @brief Number of input items work needs to see for each output item
+     *
+     * With a history of N, the input pointers given to work start N-1 items before the
+     * first unconsumed item, directly in the buffer memory.  The number of input items
+     * still counts only the unconsumed items.  Once the flowgraph is running the
+     * history may change, but not grow past max_history()
+     */
+    void set_history(unsigned int history);
+    unsigned int history() const { return d_history; }
+
+    /**
+     * @brief Largest history the block will ever ask for
+     *
+     * Buffers are sized for it and the readers keep that many items behind the read
+     * pointer from the start, so that raising the history while running exposes items
+     * that are still there.  Blocks whose history follows a setting (taps, length) have
+     * to declare it before the flowgraph starts, otherwise it is the history at that time
+     */
+    void set_max_history(unsigned int max_history);
+    unsigned int max_history() const { return std::max(d_max_history, d_history.load()); }
+
+    /**
+     * @brief Fix max_history() to its current value, done by the executor when it sets
+     * up the input readers
+     */
+    void freeze_max_history()
+    {
+        d_max_history = max_history();
+        d_max_history_frozen = true;
+    }
+
+    /**
+     * @brief Declare that an output stream port carries the items of an input stream
+     * port unchanged, one for one
+     *
+     * Where the buffers allow it, the output buffer is then a view of the input buffer
+     * and work gets the same pointer for both, so that passing the items costs nothing.
+     * Otherwise the output has a buffer of its own, so work still has to copy when the
+     * pointers differ.  Only for blocks with a history of 1 that consume exactly what
+     * they produce on the two ports.
+     */
+    void set_pass_through(size_t input, size_t output);
+
     virtual int get_param_id(const std::string& id) { return d_param_str_map[id]; }
 
+    /**
+     * @brief Counters for work calls, items, time in work and time blocked
+     *
+     * Updated by the scheduler executing this block, safe to read while running
+     */
+    perf_counters& pc() { return d_perf_counters; }
+    perf_counters_snapshot pc_snapshot() const { return d_perf_counters.snapshot(); }
+    void reset_perf_counters() { d_perf_counters.reset(); }
+    void set_perf_counters_enabled(bool enabled) { d_perf_counters.set_enabled(enabled); }
+
     /**
      * Every Block should have a param update message handler
      */
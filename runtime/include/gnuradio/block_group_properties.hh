@@ -27,12 +27,20 @@ public:
      *
      * \param mask a vector of ints of the core numbers available to this block.
      */
-    void set_processor_affinity(const std::vector<unsigned int>& mask);
+    void set_processor_affinity(const std::vector<unsigned int>& mask)
+    {
+        _affinity_mask = mask;
+        _affinity_set = !mask.empty();
+    }
 
     /*!
      * \brief Remove processor affinity to a specific core.
      */
-    void unset_processor_affinity();
+    void unset_processor_affinity()
+    {
+        _affinity_mask.clear();
+        _affinity_set = false;
+    }
 
     /*!
      * \brief Get the current processor affinity.
@@ -1,7 +1,8 @@
 #pragma once
 
 #include <gnuradio/api.h>
-#include <gnuradio/tag.hh>
+#include <gnuradio/tag_store.hh>
+#include <atomic>
 #include <functional>
 #include <memory>
 #include <mutex>
@@ -9,6 +10,15 @@
 #include <gnuradio/logging.hh>
 namespace gr {
 
+/**
+ * @brief Size used to pad the buffer indices onto their own cache lines
+ *
+ * The write index is only modified by the producer thread and each read index only by
+ * its consumer thread, so keeping them on separate cache lines avoids false sharing
+ * between adjacent block threads
+ */
+static constexpr size_t s_cacheline_size = 64;
+
 /**
  * @brief Information about the current state of the buffer
  *
@@ -112,22 +122,36 @@ protected:
     std::string _name;
     std::string _type;
 
-    size_t _write_index = 0;
     size_t _num_items;
     size_t _item_size;
     size_t _buf_size;
 
-    uint64_t _total_written = 0;
+    // Only the writer modifies these.  The write index is published with release
+    // semantics after the data has been written so that readers can acquire it
+    // without taking the buffer mutex
+    alignas(s_cacheline_size) std::atomic<size_t> _write_index = 0;
+    std::atomic<uint64_t> _total_written = 0;
 
     std::shared_ptr<buffer_properties> _buf_properties;
 
     void set_type(const std::string& type) { _type = type; }
 
-    std::mutex _buf_mutex;
-    std::vector<tag_t> _tags;
+    // Protects the tags - the stream indices do not need the mutex
+    alignas(s_cacheline_size) std::mutex _buf_mutex;
+    tag_store _tags;
+    // Number of tags in _tags, readable without the mutex
+    std::atomic<size_t> _num_tags = 0;
 
     std::vector<buffer_reader*> _readers;
 
+    // Runtime limit on the items the writer may have outstanding (0 for none), and the
+    // number of times the writer found no room, used to tune the buffer while running
+    std::atomic<size_t> _fill_limit = 0;
+    std::atomic<uint64_t> _output_blocked_count = 0;
+
+    // NUMA node the memory was placed on, -1 if left to the kernel
+    int _numa_node = -1;
+
     logger_sptr _logger;
     logger_sptr _debug_logger;
 
@@ -145,9 +169,8 @@ public:
     size_t item_size() { return _item_size; }
     size_t num_items() { return _num_items; }
     size_t buf_size() { return _buf_size; }
-    size_t write_index() { return _write_index; }
-    uint64_t total_written() const { return _total_written; }
-    const std::vector<tag_t>& tags() { return _tags; }
+    size_t write_index() { return _write_index.load(std::memory_order_acquire); }
+    uint64_t total_written() const { return _total_written.load(std::memory_order_acquire); }
     std::mutex* mutex() { return &_buf_mutex; }
 
     // std::shared_ptr<buffer_properties>& buf_properties() { return _buf_properties; }
@@ -158,6 +181,26 @@ public:
 
     std::vector<buffer_reader*>& readers() { return _readers; }
 
+    /**
+     * @brief Limit how much of the buffer the writer may fill
+     *
+     * Shrinks the working set of the buffer without reallocating it.  Only honored by
+     * buffers that use the base space_available(), not buffer_sm.
+     *
+     * @param num_items maximum number of unread items, 0 to use the whole buffer
+     */
+    void set_fill_limit(size_t num_items) { _fill_limit.store(num_items); }
+    size_t fill_limit() { return _fill_limit.load(); }
+
+    void count_output_blocked()
+    {
+        _output_blocked_count.fetch_add(1, std::memory_order_relaxed);
+    }
+    uint64_t output_blocked_count()
+    {
+        return _output_blocked_count.load(std::memory_order_relaxed);
+    }
+
 
     /**
      * @brief Return the pointer into the buffer at the given index
@@ -177,6 +220,8 @@ public:
     /**
      * @brief Return current buffer state for writing
      *
+     * Does not lock - only the thread that owns the writer should call this
+     *
      * @param info Reference to \buffer_info_t struct
      * @return true if info is valid
      * @return false if info is not valid (e.g. could not acquire mutex)
@@ -184,6 +229,14 @@ public:
     virtual bool write_info(buffer_info_t& info);
     virtual size_t space_available();
 
+    /**
+     * @brief Bytes written and still needed by the slowest reader, history included
+     *
+     * The fill of the buffer as seen by the writer, whatever limits space_available()
+     * puts on top of it
+     */
+    size_t bytes_in_use();
+
 
     /**
      * @brief Add Tags onto the tag queue
@@ -193,7 +246,11 @@ public:
      */
     void add_tags(size_t num_items, std::vector<tag_t>& tags);
 
-    const std::vector<tag_t>& tags() const { return _tags; }
+    /**
+     * @brief The tags of this buffer, hold mutex() while using them
+     */
+    const tag_store& tags() const { return _tags; }
+    size_t num_tags() const { return _num_tags.load(std::memory_order_acquire); }
 
     void add_tag(tag_t tag);
     void add_tag(uint64_t offset,
@@ -201,7 +258,13 @@ public:
                  pmtf::wrap value,
                  pmtf::wrap srcid = nullptr);
 
-    void propagate_tags(std::shared_ptr<buffer_reader> p_in_buf, int n_consumed);
+    /**
+     * @brief Add the tags a block read from its inputs over one work call
+     *
+     * @param tags Tags with offsets in items of the upstream reader
+     * @param relative_rate Output items produced per input item consumed
+     */
+    void propagate_tags(const std::vector<tag_t>& tags, double relative_rate = 1.0);
 
     void prune_tags();
 
@@ -212,6 +275,26 @@ public:
      */
     virtual void post_write(int num_items) = 0;
 
+    /**
+     * @brief Publish a new write index to the readers without locking
+     *
+     * Must be called after the written items (and any mirrored copy of them) are in
+     * place, since the release store is what makes them visible to the readers
+     *
+     * @param bytes_written Number of bytes that were written to the buffer
+     * @param num_items Number of items that were written to the buffer
+     */
+    void advance_write_index(size_t bytes_written, int num_items)
+    {
+        auto write_index = _write_index.load(std::memory_order_relaxed) + bytes_written;
+        if (write_index >= _buf_size) {
+            write_index -= _buf_size;
+        }
+        _total_written.store(_total_written.load(std::memory_order_relaxed) + num_items,
+                             std::memory_order_relaxed);
+        _write_index.store(write_index, std::memory_order_release);
+    }
+
     /**
      * @brief Set the name of the buffer
      *
@@ -249,6 +332,26 @@ public:
         // Only singly mapped buffers need to do anything with this callback
         return true;
     }
+
+    /**
+     * @brief Whether a buffer_passthrough may alias the memory of this buffer
+     *
+     * True for host buffers where every window a reader can see is contiguous in
+     * read_ptr(), so that a view of the buffer can hand out the same pointers
+     */
+    virtual bool supports_pass_through() { return false; }
+
+    /**
+     * @brief Keep the memory of the buffer on a NUMA node
+     *
+     * Meant to be called from the thread of the writer before it starts producing.
+     * Pages already touched are moved and the rest are allocated on the node.  Buffers
+     * that do not own host memory only record the node.
+     *
+     * @param node NUMA node of the writer
+     */
+    virtual void set_numa_node(int node) { _numa_node = node; }
+    int numa_node() const { return _numa_node; }
 };
 
 typedef std::shared_ptr<buffer> buffer_sptr;
@@ -259,11 +362,26 @@ class GR_RUNTIME_API buffer_reader
 protected:
     buffer_sptr _buffer; // the buffer that owns this reader
     std::shared_ptr<buffer_properties> _buf_properties;
-    uint64_t _total_read = 0;
     size_t _itemsize;
-    size_t _read_index = 0;
-    std::mutex _rdr_mutex;
 
+    // Only the owning reader modifies these, the writer acquires them to compute the
+    // space available
+    alignas(s_cacheline_size) std::atomic<size_t> _read_index = 0;
+    std::atomic<uint64_t> _total_read = 0;
+    alignas(s_cacheline_size) std::mutex _rdr_mutex;
+
+    // Number of times the reader found too few items, used to tune the buffer
+    std::atomic<uint64_t> _input_blocked_count = 0;
+
+    // Bytes before the read index kept readable for the block history, read by the
+    // writer when computing the space available
+    std::atomic<size_t> _history_bytes = 0;
+    // Bytes before the read index the writer leaves alone even when the history is
+    // smaller, so that the history can grow into them
+    std::atomic<size_t> _reserved_history_bytes = 0;
+
+    // Buffer of a pass-through output that aliases the memory behind this reader
+    gr::buffer* _pass_through = nullptr;
 
 public:
     buffer_reader(buffer_sptr buffer,
@@ -274,16 +392,83 @@ public:
     {
     }
     virtual ~buffer_reader() {}
-    size_t read_index() { return _read_index; }
-    void set_read_index(size_t r) { _read_index = r; }
-    void* read_ptr() { return _buffer->read_ptr(_read_index); }
+    size_t read_index() { return _read_index.load(std::memory_order_acquire); }
+    void set_read_index(size_t r) { _read_index.store(r, std::memory_order_release); }
+    /**
+     * @brief Pointer to the oldest item of the history, the next unread item when the
+     * history is 1
+     *
+     * The history sits right before the read index in the mirrored memory of the
+     * buffer, so the window is contiguous without copying
+     */
+    void* read_ptr()
+    {
+        auto r = _read_index.load(std::memory_order_relaxed);
+        auto h = _history_bytes.load(std::memory_order_relaxed);
+        if (h) {
+            r = r >= h ? r - h : r + _buffer->buf_size() - h;
+        }
+        return _buffer->read_ptr(r);
+    }
+
+    /**
+     * @brief Keep history - 1 items before the read pointer readable
+     *
+     * Before anything has been read, the history items are zero
+     */
+    virtual void set_history(size_t history)
+    {
+        size_t bytes = history > 1 ? (history - 1) * _itemsize : 0;
+        if (bytes >= _buffer->buf_size()) {
+            throw std::runtime_error("buffer_reader: history does not fit in the buffer");
+        }
+        _history_bytes.store(bytes);
+    }
+    size_t history() { return _history_bytes.load(std::memory_order_relaxed) / _itemsize + 1; }
+    size_t history_bytes() { return _history_bytes.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Keep max_history - 1 items before the read pointer from being overwritten
+     *
+     * Set before the writer runs, so that set_history can later grow the history up to
+     * max_history while the items it exposes are still in the buffer
+     */
+    virtual void reserve_history(size_t max_history)
+    {
+        size_t bytes = max_history > 1 ? (max_history - 1) * _itemsize : 0;
+        if (bytes >= _buffer->buf_size()) {
+            throw std::runtime_error("buffer_reader: history does not fit in the buffer");
+        }
+        _reserved_history_bytes.store(bytes);
+    }
+    size_t reserved_history_bytes()
+    {
+        return std::max(_history_bytes.load(std::memory_order_relaxed),
+                        _reserved_history_bytes.load(std::memory_order_relaxed));
+    }
+
+    /**
+     * @brief Mark the items behind this reader as still in use by the readers of a
+     * pass-through buffer that aliases them
+     */
+    void set_pass_through(gr::buffer* pass_through) { _pass_through = pass_through; }
+
+    /**
+     * @brief Bytes from the oldest byte still needed, by this reader or any reader
+     * behind a pass-through of it, up to the write index w
+     *
+     * The writer must not overwrite them
+     */
+    size_t bytes_in_use(size_t w);
     virtual void post_read(int num_items) = 0;
-    uint64_t total_read() const { return _total_read; }
+    uint64_t total_read() const { return _total_read.load(std::memory_order_acquire); }
     // std::shared_ptr<buffer_properties>& buf_properties() { return _buf_properties; }
     size_t max_buffer_read() { return _buf_properties ? _buf_properties->max_buffer_read() : 0; }
     size_t min_buffer_read() { return _buf_properties ? _buf_properties->min_buffer_read() : 0; }
     size_t item_size() { return _itemsize; }
     size_t buffer_item_size() { return _buffer->item_size(); }
+    size_t buffer_num_items() { return _buffer->num_items(); }
+    size_t buffer_buf_size() { return _buffer->buf_size(); }
 
     std::mutex* mutex() { return &_rdr_mutex; }
 
@@ -310,14 +495,63 @@ public:
      */
     virtual bool read_info(buffer_info_t& info);
 
+    /**
+     * @brief Publish a new read index to the writer without locking
+     *
+     * @param bytes_read Number of bytes that were consumed from the buffer
+     * @param num_items Number of items that were consumed from the buffer
+     */
+    void advance_read_index(size_t bytes_read, int num_items)
+    {
+        auto read_index = _read_index.load(std::memory_order_relaxed) + bytes_read;
+        if (read_index >= _buffer->buf_size()) {
+            read_index -= _buffer->buf_size();
+        }
+        _total_read.store(_total_read.load(std::memory_order_relaxed) + num_items,
+                          std::memory_order_relaxed);
+        _read_index.store(read_index, std::memory_order_release);
+    }
+
     virtual bool input_blocked_callback(size_t items_required)
     {
         // Only singly mapped buffers need to do anything with this callback
         return true;
     }
 
+    void count_input_blocked()
+    {
+        _input_blocked_count.fetch_add(1, std::memory_order_relaxed);
+    }
+    uint64_t input_blocked_count()
+    {
+        return _input_blocked_count.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Return the tags in [item_start, item_end) relative to the read pointer
+     */
     std::vector<tag_t> tags_in_window(const uint64_t item_start, const uint64_t item_end);
 
+    /**
+     * @brief Append the tags at absolute offsets [abs_start, abs_end) of this reader
+     *
+     * Offsets are in items of this reader, and are converted when the reader and the
+     * buffer have different item sizes
+     */
+    void tags_in_range(uint64_t abs_start, uint64_t abs_end, std::vector<tag_t>& ret);
+
+    /**
+     * @brief Append the tags in the next n_consumed items, the window of a work call
+     */
+    void consumed_tags(int n_consumed, std::vector<tag_t>& ret)
+    {
+        if (n_consumed > 0 && has_tags()) {
+            tags_in_range(total_read(), total_read() + n_consumed, ret);
+        }
+    }
+
+    bool has_tags() const { return _buffer->num_tags() > 0; }
+
     /**
      * @brief Return the tags associated with this buffer
      *
@@ -327,8 +561,6 @@ public:
      * @return std::vector<tag_t> Returns the vector of tags
      */
     std::vector<tag_t> get_tags(size_t num_items);
-
-    const std::vector<tag_t>& tags() const;
 };
 
 } // namespace gr
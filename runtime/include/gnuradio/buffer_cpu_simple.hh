@@ -3,6 +3,7 @@
 #include <string.h>
 #include <algorithm>
 #include <cstdint>
+#include <cstdlib>
 #include <memory>
 #include <vector>
 
@@ -14,7 +15,9 @@ class buffer_cpu_simple_reader;
 class buffer_cpu_simple : public buffer
 {
 private:
-    std::vector<uint8_t> _buffer;
+    // Whole pages, so that all of it can be bound to a NUMA node
+    std::unique_ptr<uint8_t[], void (*)(void*)> _buffer{ nullptr, std::free };
+    size_t _alloc_size = 0;
 
 public:
     typedef std::shared_ptr<buffer_cpu_simple> sptr;
@@ -33,6 +36,9 @@ public:
 
     virtual std::shared_ptr<buffer_reader>
     add_reader(std::shared_ptr<buffer_properties> buf_props, size_t itemsize);
+
+    bool supports_pass_through() override { return true; }
+    void set_numa_node(int node) override;
 };
 
 class buffer_cpu_simple_reader : public buffer_reader
@@ -49,4 +55,20 @@ public:
     virtual void post_read(int num_items);
 };
 
+class buffer_cpu_simple_properties : public buffer_properties
+{
+public:
+    buffer_cpu_simple_properties() : buffer_properties()
+    {
+        _bff = buffer_cpu_simple::make;
+    }
+    static std::shared_ptr<buffer_properties> make()
+    {
+        return std::static_pointer_cast<buffer_properties>(
+            std::make_shared<buffer_cpu_simple_properties>());
+    }
+};
+
 } // namespace gr
+
+#define BUFFER_CPU_SIMPLE_ARGS buffer_cpu_simple_properties::make()
@@ -46,6 +46,9 @@ public:
     // virtual void copy_items(std::shared_ptr<buffer> from, int nitems);
 
     virtual std::shared_ptr<buffer_reader> add_reader(std::shared_ptr<buffer_properties> buf_props, size_t itemsize);
+
+    bool supports_pass_through() override { return true; }
+    void set_numa_node(int node) override;
 };
 
 class buffer_cpu_vmcirc_reader : public buffer_reader
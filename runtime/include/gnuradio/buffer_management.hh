@@ -4,8 +4,23 @@
 #include <gnuradio/flat_graph.hh>
 #include <gnuradio/logging.hh>
 
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <thread>
+
 namespace gr {
 
+/**
+ * @brief How the buffer_manager picks the size of buffers without a requested size
+ *
+ * FIXED: the default buffer size of the manager for every edge
+ * CACHE_AWARE: edges between blocks of the same thread share the L2 cache of that core,
+ * all other edges share the last level cache, each in proportion to its byte rate
+ */
+enum class buffer_size_policy_t { FIXED, CACHE_AWARE };
+
 class GR_RUNTIME_API buffer_manager
 {
 private:
@@ -13,6 +28,32 @@ private:
     static const int s_min_items_to_process = 1;
     const size_t s_min_buf_items = 1;
 
+    // Fraction of a cache given to the buffers, the rest is left for everything else
+    static constexpr double s_cache_fraction = 0.5;
+    static const size_t s_min_auto_buf_size = 8192;
+    static const size_t s_max_auto_buf_size = 4 * 1024 * 1024;
+    // With runtime tuning, buffers are allocated this much larger than their initial
+    // fill limit so that they have room to grow
+    static const size_t s_adaptive_headroom = 4;
+
+    buffer_size_policy_t d_policy = buffer_size_policy_t::FIXED;
+    bool d_adaptive = false;
+    size_t d_max_items_per_call = 0;
+    std::map<nodeid_t, int> d_thread_group;
+    std::map<port_sptr, size_t> d_auto_buf_size;
+
+    struct tuned_buffer {
+        buffer_sptr buf;
+        size_t min_items;
+        uint64_t last_output_blocked;
+        uint64_t last_input_blocked;
+    };
+    std::vector<tuned_buffer> d_tuned_buffers;
+    std::thread d_adapt_thread;
+    std::mutex d_adapt_mutex;
+    std::condition_variable d_adapt_cv;
+    bool d_adapt_running = false;
+
     std::string _name = "buffer_manager";
     logger_sptr _logger;
     logger_sptr _debug_logger;
@@ -25,13 +66,69 @@ public:
         _logger = logging::get_logger(_name, "default");
         _debug_logger = logging::get_logger(_name + "_dbg", "debug");
     }
-    ~buffer_manager() {}
+    ~buffer_manager() { stop_adaptation(); }
+
+    /**
+     * @brief Select how buffer sizes are picked, call before initialize_buffers
+     *
+     * @param policy sizing policy for buffers that do not request a size
+     * @param adaptive allocate with headroom and let adapt() grow or shrink the part of
+     * each buffer in use
+     */
+    void set_size_policy(buffer_size_policy_t policy, bool adaptive = false)
+    {
+        d_policy = policy;
+        d_adaptive = adaptive;
+    }
+
+    /**
+     * @brief Hold the unread items of each buffer to a couple of work calls, call
+     * before initialize_buffers
+     *
+     * For latency mode, where each work call is capped to max_items.  A writer can get
+     * at most one call ahead of its slowest reader, so items queue up nowhere along the
+     * graph and the blocks downstream drain what is in flight before more is produced.
+     * Takes the place of the adaptive tuning of fill limits.
+     *
+     * @param max_items items per work call, 0 to leave the buffers unlimited
+     */
+    void set_max_items_per_call(size_t max_items) { d_max_items_per_call = max_items; }
+
+    /**
+     * @brief Tell the manager which blocks will share a thread
+     *
+     * Blocks not in any group are assumed to have a thread of their own
+     */
+    void set_thread_groups(const std::vector<std::vector<block_sptr>>& groups);
 
     void initialize_buffers(flat_graph_sptr fg,
                             std::shared_ptr<buffer_properties> buf_props);
 
+    /**
+     * @brief Tune the fill limits of the buffers from what was observed since last call
+     *
+     * A buffer whose writer and readers both had to wait is too small, and is allowed
+     * to fill further.  A buffer whose writer waited while the readers always had data
+     * only adds latency and cache footprint, and is held to less.
+     */
+    void adapt();
+
+    /**
+     * @brief Call adapt() periodically from a background thread
+     *
+     */
+    void start_adaptation(std::chrono::milliseconds period = std::chrono::milliseconds(100));
+    void stop_adaptation();
+
 private:
+    void create_buffer(edge_sptr e,
+                       flat_graph_sptr fg,
+                       std::shared_ptr<buffer_properties> buf_props);
+    bool is_pass_through_candidate(port_sptr p, flat_graph_sptr fg);
     int get_buffer_num_items(edge_sptr e, flat_graph_sptr fg);
+    size_t get_min_buffer_num_items(edge_sptr e, flat_graph_sptr fg);
+    size_t latency_fill_limit(edge_sptr e, flat_graph_sptr fg);
+    void compute_cache_aware_sizes(flat_graph_sptr fg);
 };
 
-} // namespace gr
\ No newline at end of file
+} // namespace gr
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <gnuradio/buffer.hh>
+
+namespace gr {
+
+/**
+ * @brief Output buffer of a block that passes its input through unchanged
+ *
+ * Has no memory of its own but is a view of the buffer upstream of the block, at the
+ * same byte indices.  The block writes an item by consuming it, so the write pointer is
+ * the read pointer of the upstream reader and writing only advances the indices.
+ * Readers of this buffer read the upstream memory directly, and hold the upstream
+ * writer off it through the upstream reader until they are done with it.
+ *
+ * Tags are kept here as for any other buffer, so that tag propagation through the
+ * block is unchanged.
+ */
+class GR_RUNTIME_API buffer_passthrough : public buffer
+{
+private:
+    buffer_sptr _upstream;
+    buffer_reader_sptr _upstream_reader;
+
+public:
+    typedef std::shared_ptr<buffer_passthrough> sptr;
+
+    /**
+     * @param upstream buffer to alias
+     * @param upstream_reader reader of the pass-through block on upstream
+     * @param item_size item size of the output, which must divide the size of upstream
+     */
+    buffer_passthrough(buffer_sptr upstream,
+                       buffer_reader_sptr upstream_reader,
+                       size_t item_size);
+
+    static buffer_sptr
+    make(buffer_sptr upstream, buffer_reader_sptr upstream_reader, size_t item_size);
+
+    void* read_ptr(size_t index) override { return _upstream->read_ptr(index); }
+    void* write_ptr() override;
+
+    /**
+     * @brief The items the block can pass, all of those waiting on the upstream reader
+     * up to the fill limit
+     */
+    size_t space_available() override;
+    void post_write(int num_items) override;
+
+    std::shared_ptr<buffer_reader>
+    add_reader(std::shared_ptr<buffer_properties> buf_props, size_t itemsize) override;
+
+    bool supports_pass_through() override { return true; }
+};
+
+class GR_RUNTIME_API buffer_passthrough_reader : public buffer_reader
+{
+public:
+    buffer_passthrough_reader(buffer_sptr buffer,
+                              std::shared_ptr<buffer_properties> buf_props,
+                              size_t itemsize,
+                              size_t read_index = 0)
+        : buffer_reader(buffer, buf_props, itemsize, read_index)
+    {
+    }
+
+    void post_read(int num_items) override;
+};
+
+} // namespace gr
@@ -72,6 +72,21 @@ public:
 
     virtual bool input_blocked_callback(size_t items_required);
     virtual size_t bytes_available() override;
+
+    // Data is moved back to the start of a single mapped buffer, so the items before
+    // the read pointer are not kept
+    virtual void set_history(size_t history) override
+    {
+        if (history > 1) {
+            throw std::runtime_error("buffer_sm: history is not supported");
+        }
+    }
+    virtual void reserve_history(size_t max_history) override
+    {
+        if (max_history > 1) {
+            throw std::runtime_error("buffer_sm: history is not supported");
+        }
+    }
 };
 
 
@@ -29,6 +29,11 @@ public:
         q.wait_dequeue(msg);
         return true;
     }
+    // Only exact when no other thread is pushing or popping
+    size_t size_approx() const
+    {
+        return q.size_approx();
+    }
     void clear()
     {
         T msg;
@@ -102,6 +102,21 @@ public:
 
     block_vector_t calc_downstream_blocks(block_sptr block, port_sptr port);
 
+    /**
+     * @brief Split the used blocks into connected subgraphs
+     *
+     * @return std::vector<block_vector_t> the blocks of each subgraph, topologically
+     * sorted
+     */
+    std::vector<block_vector_t> partition();
+
+    /**
+     * @brief Sort blocks so that every block comes after the blocks feeding it
+     *
+     * Only edges of this graph between the given blocks are considered
+     */
+    block_vector_t topological_sort(block_vector_t& blocks);
+
 protected:
     block_vector_t d_blocks;
 
@@ -119,9 +134,6 @@ private:
     block_vector_t sort_sources_first(block_vector_t& blocks);
     bool source_p(block_sptr block);
     void topological_dfs_visit(block_sptr blk, block_vector_t& output);
-
-    std::vector<block_vector_t> partition();
-    block_vector_t topological_sort(block_vector_t& blocks);
 };
 
 typedef std::shared_ptr<flat_graph> flat_graph_sptr;
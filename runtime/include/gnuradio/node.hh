@@ -85,8 +85,8 @@ public:
         return result;
     }
 
-    std::string name() const { return d_name; };
-    std::string alias() const { return d_alias; }
+    const std::string& name() const { return d_name; };
+    const std::string& alias() const { return d_alias; }
 
     logger_sptr logger() const { return _logger; }
     logger_sptr debug_logger() const { return _debug_logger; }
@@ -0,0 +1,49 @@
+/* -*- c++ -*- */
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#pragma once
+
+#include <gnuradio/api.h>
+#include <cstddef>
+#include <vector>
+
+namespace gr {
+namespace numa {
+
+/*! \brief Number of NUMA nodes, 1 on machines (or systems) without NUMA
+ */
+int GR_RUNTIME_API num_nodes();
+
+/*! \brief The CPUs of a NUMA node, in increasing order
+ */
+std::vector<unsigned int> GR_RUNTIME_API node_cpus(int node);
+
+/*! \brief The NUMA node a CPU belongs to, -1 if the CPU is unknown
+ */
+int GR_RUNTIME_API node_of_cpu(unsigned int cpu);
+
+/*! \brief The NUMA node all CPUs of a mask belong to
+ *
+ * Returns -1 when the mask is empty or spans several nodes.
+ */
+int GR_RUNTIME_API node_of_cpus(const std::vector<unsigned int>& cpus);
+
+/*! \brief The NUMA node the calling thread is running on right now
+ */
+int GR_RUNTIME_API current_node();
+
+/*! \brief Prefer a NUMA node for the pages of a range of memory
+ *
+ * Pages already touched are moved to the node, pages touched later are allocated
+ * there.  Only the pages entirely inside the range are affected, and nothing is done
+ * on machines with a single node.
+ *
+ * \return false if the kernel refused the policy
+ */
+bool GR_RUNTIME_API bind_memory(void* addr, size_t len, int node);
+
+} /* namespace numa */
+} /* namespace gr */
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <gnuradio/api.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace gr {
+
+/**
+ * @brief Values of the performance counters of a block at one point in time
+ *
+ * Times are in seconds, averages are exponential running averages over work calls
+ */
+struct perf_counters_snapshot {
+    uint64_t work_calls = 0;
+    uint64_t items_consumed = 0; // summed over all input ports
+    uint64_t items_produced = 0; // summed over all output ports
+    double work_time = 0.0;
+    double avg_work_time = 0.0;
+    double var_work_time = 0.0;
+    double avg_noutput_items = 0.0;
+    uint64_t input_blocked = 0;  // times the block was found without enough input
+    uint64_t output_blocked = 0; // times the block was found without enough output space
+    double input_blocked_time = 0.0;
+    double output_blocked_time = 0.0;
+    double avg_input_buffer_fill = 0.0;  // fraction of the input buffers holding data
+    double avg_output_buffer_fill = 0.0; // fraction of the output buffers holding data
+    // Bucket i counts the work calls that took [2^i, 2^(i+1)) ns
+    std::vector<uint64_t> work_time_histogram;
+};
+
+/**
+ * @brief Per block counters maintained by the executor around each call to work
+ *
+ * Only the thread executing the block updates the counters, so updates are plain relaxed
+ * stores and never allocate.  Any thread may take a snapshot while the flowgraph runs.
+ * Off by default, since each work call then costs two clock reads and the histogram
+ * update; turned on per block, by a perf_monitor or by the scheduler options.
+ */
+class GR_RUNTIME_API perf_counters
+{
+public:
+    typedef std::chrono::steady_clock clock;
+    static const size_t s_histogram_buckets = 32;
+    // Weight of the newest work call in the running averages
+    static constexpr double s_alpha = 0.01;
+
+    bool enabled() const { return d_enabled.load(std::memory_order_relaxed); }
+    void set_enabled(bool enabled) { d_enabled.store(enabled); }
+
+    void record_input_blocked() { record_blocked(blocked_state_t::INPUT); }
+    void record_output_blocked() { record_blocked(blocked_state_t::OUTPUT); }
+
+    /**
+     * @brief Account for one call to work
+     *
+     * @param start time work was called
+     * @param end time work returned
+     * @param noutput_items number of items the block was allowed to produce
+     * @param nconsumed items consumed over all inputs
+     * @param nproduced items produced over all outputs
+     * @param input_fill fraction of the fullest input buffer holding data
+     * @param output_fill fraction of the fullest output buffer holding data
+     */
+    void record_work(clock::time_point start,
+                     clock::time_point end,
+                     size_t noutput_items,
+                     uint64_t nconsumed,
+                     uint64_t nproduced,
+                     double input_fill,
+                     double output_fill);
+
+    perf_counters_snapshot snapshot() const;
+    void reset();
+
+private:
+    enum class blocked_state_t { NONE, INPUT, OUTPUT };
+
+    void record_blocked(blocked_state_t state);
+
+    std::atomic<bool> d_enabled = false;
+
+    std::atomic<uint64_t> d_work_calls = 0;
+    std::atomic<uint64_t> d_items_consumed = 0;
+    std::atomic<uint64_t> d_items_produced = 0;
+    std::atomic<uint64_t> d_work_time_ns = 0;
+    std::atomic<double> d_avg_work_time = 0.0;
+    std::atomic<double> d_var_work_time = 0.0;
+    std::atomic<double> d_avg_noutput_items = 0.0;
+    std::atomic<uint64_t> d_input_blocked = 0;
+    std::atomic<uint64_t> d_output_blocked = 0;
+    std::atomic<uint64_t> d_input_blocked_ns = 0;
+    std::atomic<uint64_t> d_output_blocked_ns = 0;
+    std::atomic<double> d_avg_input_fill = 0.0;
+    std::atomic<double> d_avg_output_fill = 0.0;
+    std::array<std::atomic<uint64_t>, s_histogram_buckets> d_histogram = {};
+
+    // Start of the current streak of blocked checks, only touched by the executor
+    blocked_state_t d_blocked_state = blocked_state_t::NONE;
+    clock::time_point d_blocked_since;
+};
+
+} // namespace gr
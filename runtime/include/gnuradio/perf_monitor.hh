@@ -0,0 +1,71 @@
+#pragma once
+
+#include <gnuradio/block.hh>
+#include <gnuradio/graph.hh>
+#include <gnuradio/logging.hh>
+
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+namespace gr {
+
+/**
+ * @brief Periodically dump the performance counters of a set of blocks
+ *
+ * Each period, one line per block is appended to a CSV file, or logged when no file is
+ * given.  Creating the monitor turns on the counters of its blocks.
+ */
+class GR_RUNTIME_API perf_monitor
+{
+private:
+    std::vector<block_sptr> d_blocks;
+    std::chrono::milliseconds d_period;
+    std::string d_filename;
+    std::ofstream d_file;
+    std::chrono::steady_clock::time_point d_t0;
+
+    std::thread d_thread;
+    std::mutex d_mutex;
+    std::condition_variable d_cv;
+    bool d_running = false;
+
+    logger_sptr _logger;
+
+    void dump();
+
+public:
+    typedef std::shared_ptr<perf_monitor> sptr;
+    static sptr make(const std::vector<block_sptr>& blocks,
+                     std::chrono::milliseconds period = std::chrono::milliseconds(1000),
+                     const std::string& filename = "")
+    {
+        return std::make_shared<perf_monitor>(blocks, period, filename);
+    }
+    /**
+     * @brief Monitor all the blocks of a graph
+     */
+    static sptr make(graph_sptr g,
+                     std::chrono::milliseconds period = std::chrono::milliseconds(1000),
+                     const std::string& filename = "");
+
+    perf_monitor(const std::vector<block_sptr>& blocks,
+                 std::chrono::milliseconds period,
+                 const std::string& filename);
+    ~perf_monitor() { stop(); }
+
+    void start();
+    void stop();
+
+    /**
+     * @brief The counters of every block, one CSV line each
+     */
+    std::string report();
+    static std::string csv_header();
+};
+
+typedef perf_monitor::sptr perf_monitor_sptr;
+
+} // namespace gr
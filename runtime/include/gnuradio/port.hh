@@ -2,6 +2,7 @@
 
 #include <gnuradio/api.h>
 #include <gnuradio/buffer.hh>
+#include <gnuradio/buffer_passthrough.hh>
 #include <gnuradio/neighbor_interface.hh>
 #include <gnuradio/scheduler_message.hh>
 #include <gnuradio/parameter_types.hh>
@@ -123,10 +124,27 @@ public:
     void set_buffer_reader(buffer_reader_sptr rdr) { _buffer_reader = rdr; }
     buffer_reader_sptr buffer_reader() { return _buffer_reader; }
 
+    /**
+     * @brief Pass the items of the given input port out of this output port unchanged
+     *
+     * The buffer manager then makes the buffer of this port a view of the buffer of
+     * the input, when the two buffers allow it, so that work is handed the same
+     * pointer for both and has nothing to copy
+     */
+    void set_pass_through(sptr input) { _pass_through = input; }
+    sptr pass_through() { return _pass_through; }
+
     void notify_connected_ports(scheduler_message_sptr msg)
     {
         for (auto& p : _connected_ports) {
-            p->push_message(msg);
+            // Reading from a view of an upstream buffer frees space upstream, the block
+            // passing the items through has no space of its own to wait on
+            if (p->pass_through() &&
+                std::dynamic_pointer_cast<buffer_passthrough>(p->buffer())) {
+                p->pass_through()->notify_connected_ports(msg);
+            } else {
+                p->push_message(msg);
+            }
         }
 
         // FIXME: To achieve maximum performance, we need to stimulate our own
@@ -179,6 +197,7 @@ protected:
     neighbor_interface_sptr _parent_intf = nullptr;
     buffer_sptr _buffer = nullptr;
     buffer_reader_sptr _buffer_reader = nullptr;
+    sptr _pass_through = nullptr;
 
     block* _parent_block = nullptr;
 };
@@ -2,6 +2,9 @@
 
 #include <pmtf/wrap.hpp>
 
+#include <functional>
+#include <memory>
+
 namespace gr {
 
 enum class scheduler_action_t { DONE, NOTIFY_OUTPUT, NOTIFY_INPUT, NOTIFY_ALL, EXIT };
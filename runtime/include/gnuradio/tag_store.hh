@@ -0,0 +1,82 @@
+#pragma once
+
+#include <gnuradio/tag.hh>
+
+#include <algorithm>
+#include <deque>
+#include <vector>
+
+namespace gr {
+
+/**
+ * @brief Tags of a buffer, kept ordered by absolute offset
+ *
+ * Tags are nearly always added in offset order, so insertion is an append, and they are
+ * always removed from the front as readers move on, so pruning only touches the tags
+ * that go away.  Window lookups are a binary search plus the tags in the window.  Tags
+ * with equal offsets keep the order they were added in.
+ *
+ * Not thread safe, the owning buffer protects it with its mutex
+ */
+class tag_store
+{
+public:
+    typedef std::deque<tag_t>::const_iterator const_iterator;
+
+    void insert(const tag_t& tag)
+    {
+        if (d_tags.empty() || d_tags.back().offset <= tag.offset) {
+            d_tags.push_back(tag);
+        } else {
+            d_tags.insert(std::upper_bound(d_tags.begin(),
+                                           d_tags.end(),
+                                           tag.offset,
+                                           [](uint64_t offset, const tag_t& t) {
+                                               return offset < t.offset;
+                                           }),
+                          tag);
+        }
+    }
+
+    /**
+     * @brief First tag at or after offset
+     */
+    const_iterator lower_bound(uint64_t offset) const
+    {
+        return std::lower_bound(
+            d_tags.begin(), d_tags.end(), offset, [](const tag_t& t, uint64_t offset) {
+                return t.offset < offset;
+            });
+    }
+
+    /**
+     * @brief Append the tags with offsets in [start, end) to ret
+     */
+    void in_window(uint64_t start, uint64_t end, std::vector<tag_t>& ret) const
+    {
+        for (auto it = lower_bound(start); it != d_tags.end() && it->offset < end; ++it) {
+            ret.push_back(*it);
+        }
+    }
+
+    /**
+     * @brief Remove all the tags with offsets before offset
+     */
+    void prune(uint64_t offset)
+    {
+        while (!d_tags.empty() && d_tags.front().offset < offset) {
+            d_tags.pop_front();
+        }
+    }
+
+    bool empty() const { return d_tags.empty(); }
+    size_t size() const { return d_tags.size(); }
+    const_iterator begin() const { return d_tags.begin(); }
+    const_iterator end() const { return d_tags.end(); }
+    void clear() { d_tags.clear(); }
+
+private:
+    std::deque<tag_t> d_tags;
+};
+
+} // namespace gr
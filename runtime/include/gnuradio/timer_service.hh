@@ -0,0 +1,77 @@
+#pragma once
+
+#include <gnuradio/api.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+namespace gr {
+
+/**
+ * @brief Runs callbacks at requested times from a single thread
+ *
+ * For blocks and schedulers that need to be woken up later, e.g. a throttle waiting for
+ * its next samples to be due, without a thread of their own per wait.  Timers are kept
+ * ordered by deadline, and the thread sleeps until the earliest one.
+ *
+ * Callbacks run on the timer thread with no lock held, in deadline order, and should
+ * be short - typically pushing a message to a scheduler.
+ */
+class GR_RUNTIME_API timer_service
+{
+public:
+    typedef std::chrono::steady_clock clock;
+    typedef uint64_t timer_id;
+    typedef std::function<void()> callback_t;
+
+    /**
+     * @brief The timer service shared by the whole runtime
+     */
+    static timer_service& instance();
+
+    timer_service();
+    ~timer_service();
+    timer_service(const timer_service&) = delete;
+    timer_service& operator=(const timer_service&) = delete;
+
+    /**
+     * @brief Call fn at when, or as soon as possible if when has passed
+     *
+     * @return timer_id id for cancel(), never 0
+     */
+    timer_id schedule_at(clock::time_point when, callback_t fn);
+    timer_id schedule_after(clock::duration delay, callback_t fn)
+    {
+        return schedule_at(clock::now() + delay, std::move(fn));
+    }
+
+    /**
+     * @brief Drop a timer that has not fired yet
+     *
+     * @return true if the timer was pending, false if it already ran or was cancelled
+     */
+    bool cancel(timer_id id);
+
+    size_t pending();
+
+private:
+    typedef std::pair<clock::time_point, timer_id> key_t;
+
+    std::mutex d_mutex;
+    std::condition_variable d_cv;
+    std::map<key_t, callback_t> d_timers;
+    std::unordered_map<timer_id, clock::time_point> d_deadlines;
+    timer_id d_next_id = 1;
+    bool d_stop = false;
+    std::thread d_thread;
+
+    void run();
+};
+
+} // namespace gr
@@ -87,6 +87,37 @@ void block::set_output_multiple(int multiple)
     d_output_multiple = multiple;
 }
 
+void block::set_history(unsigned int history)
+{
+    if (history < 1)
+        throw std::invalid_argument("block::set_history");
+
+    // The readers only kept max_history items, older ones may be overwritten already
+    if (d_max_history_frozen && history > d_max_history)
+        throw std::invalid_argument(
+            "block::set_history: history above max_history while running");
+
+    d_history = history;
+}
+
+void block::set_max_history(unsigned int max_history)
+{
+    if (d_max_history_frozen && max_history > d_max_history)
+        throw std::invalid_argument("block::set_max_history: buffers already set up");
+
+    d_max_history = max_history;
+}
+
+void block::set_pass_through(size_t input, size_t output)
+{
+    auto input_ports = input_stream_ports();
+    auto output_ports = output_stream_ports();
+    if (input >= input_ports.size() || output >= output_ports.size())
+        throw std::invalid_argument("block::set_pass_through");
+
+    output_ports[output]->set_pass_through(input_ports[input]);
+}
+
 void block::handle_msg_param_update(pmtf::wrap msg)
 {
     // Update messages are a pmtf::map with the name of
@@ -178,5 +209,28 @@ void block::notify_scheduler_output()
     }
 }
 
+void block::notify_scheduler_at(timer_service::clock::time_point when)
+{
+    if (!p_scheduler) {
+        return;
+    }
+
+    // The block or the scheduler may be gone by the time the timer fires
+    std::weak_ptr<block> self = weak_from_this();
+    std::weak_ptr<neighbor_interface> sched = p_scheduler;
+    d_pending_wakeups.fetch_add(1, std::memory_order_relaxed);
+    timer_service::instance().schedule_at(when, [self, sched]() {
+        // No longer pending by the time the scheduler handles the notification, or
+        // a flush would wait on this wake-up with nothing left to wake it
+        if (auto b = self.lock()) {
+            b->d_pending_wakeups.fetch_sub(1, std::memory_order_release);
+        }
+        if (auto s = sched.lock()) {
+            s->push_message(
+                std::make_shared<scheduler_action>(scheduler_action_t::NOTIFY_INPUT));
+        }
+    });
+}
+
 
 } // namespace gr
\ No newline at end of file
@@ -1,20 +1,36 @@
 #include <gnuradio/buffer.hh>
 
+#include <algorithm>
+#include <cmath>
+
 namespace gr {
 
-size_t buffer::space_available()
+size_t buffer::bytes_in_use()
 {
     // Find the max number of bytes available across readers
-    uint64_t n_available = 0;
+    size_t n_available = 0;
+    auto w = write_index();
     for (auto& r : _readers) {
-        auto n = r->bytes_available();
+        auto n = r->bytes_in_use(w);
         if (n > n_available) {
             n_available = n;
         }
     }
+    return n_available;
+}
+
+size_t buffer::space_available()
+{
+    auto n_available = bytes_in_use();
 
     int space_in_items = (_num_items * _item_size - n_available) / _item_size - 1;
 
+    auto fill_limit = _fill_limit.load(std::memory_order_relaxed);
+    if (fill_limit > 0) {
+        space_in_items =
+            std::min(space_in_items, (int)fill_limit - (int)(n_available / _item_size));
+    }
+
     if (space_in_items < 0)
         space_in_items = 0;
     space_in_items =
@@ -24,14 +40,11 @@ size_t buffer::space_available()
 }
 bool buffer::write_info(buffer_info_t& info)
 {
-    std::scoped_lock guard(_buf_mutex);
-
-
     auto space = space_available();
     info.ptr = write_ptr();
     info.n_items = space;
     info.item_size = _item_size;
-    info.total_items = _total_written;
+    info.total_items = total_written();
 
     return true;
 }
@@ -43,16 +56,18 @@ void buffer::add_tags(size_t num_items, std::vector<tag_t>& tags)
         if (tag.offset < _total_written - num_items || tag.offset >= _total_written) {
 
         } else {
-            _tags.push_back(tag);
+            _tags.insert(tag);
         }
     }
+    _num_tags.store(_tags.size(), std::memory_order_release);
 }
 
 
 void buffer::add_tag(tag_t tag)
 {
     std::scoped_lock guard(_buf_mutex);
-    _tags.push_back(tag);
+    _tags.insert(tag);
+    _num_tags.store(_tags.size(), std::memory_order_release);
 }
 void buffer::add_tag(uint64_t offset,
                      pmtf::wrap key,
@@ -60,53 +75,49 @@ void buffer::add_tag(uint64_t offset,
                      pmtf::wrap srcid)
 {
     std::scoped_lock guard(_buf_mutex);
-    _tags.emplace_back(offset, key, value, srcid);
+    _tags.insert(tag_t(offset, key, value, srcid));
+    _num_tags.store(_tags.size(), std::memory_order_release);
 }
 
-void buffer::propagate_tags(std::shared_ptr<buffer_reader> p_in_buf, int n_consumed)
+void buffer::propagate_tags(const std::vector<tag_t>& tags, double relative_rate)
 {
-    double relative_rate = (double)p_in_buf->item_size() / (double)p_in_buf->buffer_item_size();
+    if (tags.empty()) {
+        return;
+    }
+
     std::scoped_lock guard(_buf_mutex);
-    for (auto& t : p_in_buf->tags()) {
-        uint64_t new_offset = t.offset;
-        if (relative_rate != 1.0) {
-            new_offset = t.offset / relative_rate;
-        }
-        // Propagate the tags that occurred in the processed window
-        if (new_offset >= total_written() && new_offset < total_written() + n_consumed) {
-            // std::cout << "adding tag" << std::endl;
-            _tags.push_back(t);
-
-            if (relative_rate != 1.0) {
-                _tags[_tags.size() - 1].offset = new_offset;
-            }
+    for (auto& t : tags) {
+        if (relative_rate == 1.0) {
+            _tags.insert(t);
+        } else {
+            tag_t new_tag = t;
+            new_tag.offset = (uint64_t)std::llround(t.offset * relative_rate);
+            _tags.insert(new_tag);
         }
     }
+    _num_tags.store(_tags.size(), std::memory_order_release);
 }
 
 void buffer::prune_tags()
 {
+    if (num_tags() == 0) {
+        return;
+    }
+
     std::scoped_lock guard(_buf_mutex);
 
     // Find the min number of items available across readers
     auto n_read = total_written();
     for (auto& r : _readers) {
-        auto n = r->total_read();
+        // in items of this buffer
+        auto n = r->total_read() * r->item_size() / _item_size;
         if (n < n_read) {
             n_read = n;
         }
     }
 
-    auto t = std::begin(_tags);
-    while (t != std::end(_tags)) {
-        // Do some stuff
-        if (t->offset < n_read) {
-            t = _tags.erase(t);
-            // std::cout << "removing tag" << std::endl;
-        } else {
-            ++t;
-        }
-    }
+    _tags.prune(n_read);
+    _num_tags.store(_tags.size(), std::memory_order_release);
 }
 
 size_t buffer_reader::items_available() { return bytes_available() / _itemsize; }
@@ -114,21 +125,36 @@ size_t buffer_reader::items_available() { return bytes_available() / _itemsize;
 size_t buffer_reader::bytes_available()
 {
     size_t w = _buffer->write_index();
-    size_t r = _read_index;
+    size_t r = _read_index.load(std::memory_order_relaxed);
 
     if (w < r)
         w += _buffer->buf_size();
     return (w - r);
 }
 
+size_t buffer_reader::bytes_in_use(size_t w)
+{
+    // The history behind the reader must not be overwritten either
+    auto r = _read_index.load(std::memory_order_acquire);
+    size_t n = (w < r ? w + _buffer->buf_size() : w) - r + reserved_history_bytes();
+
+    // Readers of a pass-through read the same memory, at the same byte indices
+    if (_pass_through) {
+        for (auto& pr : _pass_through->readers()) {
+            n = std::max(n, pr->bytes_in_use(w));
+        }
+    }
+    return n;
+}
+
 bool buffer_reader::read_info(buffer_info_t& info)
 {
     // std::scoped_lock guard(_rdr_mutex);
 
-    info.ptr = _buffer->read_ptr(_read_index);
+    info.ptr = read_ptr();
     info.n_items = items_available();
     info.item_size = _itemsize; //  _buffer->item_size();
-    info.total_items = _total_read;
+    info.total_items = total_read();
 
     return true;
 }
@@ -143,25 +169,9 @@ bool buffer_reader::read_info(buffer_info_t& info)
  */
 std::vector<tag_t> buffer_reader::get_tags(size_t num_items)
 {
-    std::scoped_lock guard(*(_buffer->mutex()));
-    double relative_rate = (double)_itemsize / (double)_buffer->item_size();
-
     // Find all the tags from total_read to total_read+offset
     std::vector<tag_t> ret;
-    for (auto& t : _buffer->tags()) {
-        uint64_t new_offset = t.offset;
-        if (relative_rate != 1.0) {
-            new_offset = t.offset / relative_rate;
-        }
-        if (new_offset >= total_read() && new_offset < total_read() + num_items) {
-            ret.push_back(t);
-
-            if (relative_rate != 1.0) {
-                ret[ret.size() - 1].offset = new_offset;
-            }
-        }
-    }
-
+    tags_in_range(total_read(), total_read() + num_items, ret);
     return ret;
 }
 
@@ -169,33 +179,31 @@ std::vector<tag_t> buffer_reader::get_tags(size_t num_items)
 std::vector<tag_t> buffer_reader::tags_in_window(const uint64_t item_start,
                                                  const uint64_t item_end)
 {
-    std::scoped_lock guard(*(_buffer->mutex()));
-
-    double relative_rate = (double)_itemsize / (double)_buffer->item_size();
-
     std::vector<tag_t> ret;
-    for (auto& t : _buffer->tags()) {
-        uint64_t new_offset = t.offset;
-        if (relative_rate != 1.0) {
-            new_offset = t.offset / relative_rate;
-        }
-        if (new_offset >= total_read() + item_start &&
-            new_offset < total_read() + item_end) {
-            ret.push_back(t);
-
-            if (relative_rate != 1.0) {
-                ret[ret.size() - 1].offset = new_offset;
-            }
-        }
-    }
+    tags_in_range(total_read() + item_start, total_read() + item_end, ret);
     return ret;
 }
 
-const std::vector<tag_t>& buffer_reader::tags() const
+void buffer_reader::tags_in_range(uint64_t abs_start,
+                                  uint64_t abs_end,
+                                  std::vector<tag_t>& ret)
 {
+    uint64_t r = _itemsize;
+    uint64_t b = _buffer->item_size();
+
     std::scoped_lock guard(*(_buffer->mutex()));
-    return _buffer->tags();
-}
+    if (r == b) {
+        _buffer->tags().in_window(abs_start, abs_end, ret);
+        return;
+    }
 
+    // A tag at buffer offset o is at offset floor(o * b / r) for this reader, so the
+    // window maps to buffer offsets [ceil(start * r / b), ceil(end * r / b))
+    auto first = ret.size();
+    _buffer->tags().in_window((abs_start * r + b - 1) / b, (abs_end * r + b - 1) / b, ret);
+    for (auto it = ret.begin() + first; it != ret.end(); ++it) {
+        it->offset = it->offset * b / r;
+    }
+}
 
 } // namespace gr
@@ -1,4 +1,8 @@
+#include "pagesize.hh"
 #include <gnuradio/buffer_cpu_simple.hh>
+#include <gnuradio/numa.hh>
+
+#include <new>
 
 namespace gr {
 
@@ -7,7 +11,15 @@ buffer_cpu_simple::buffer_cpu_simple(size_t num_items,
                                      std::shared_ptr<buffer_properties> buf_properties)
     : buffer(num_items, item_size, buf_properties)
 {
-    _buffer.resize(_buf_size * 2); // double circular buffer
+    // double circular buffer, zeroed
+    size_t page = gr::pagesize();
+    _alloc_size = (_buf_size * 2 + page - 1) / page * page;
+    void* p = nullptr;
+    if (posix_memalign(&p, page, _alloc_size) != 0) {
+        throw std::bad_alloc();
+    }
+    memset(p, 0, _alloc_size);
+    _buffer.reset(static_cast<uint8_t*>(p));
     _write_index = 0;
 
     set_type("buffer_cpu_simple");
@@ -21,15 +33,16 @@ buffer_sptr buffer_cpu_simple::make(size_t num_items,
 }
 
 void* buffer_cpu_simple::read_ptr(size_t index) { return (void*)&_buffer[index]; }
-void* buffer_cpu_simple::write_ptr() { return (void*)&_buffer[_write_index]; }
+void* buffer_cpu_simple::write_ptr()
+{
+    return (void*)&_buffer[_write_index.load(std::memory_order_relaxed)];
+}
 
 void buffer_cpu_simple::post_write(int num_items)
 {
-    std::scoped_lock guard(_buf_mutex);
-
     size_t bytes_written = num_items * _item_size;
-    size_t wi1 = _write_index;
-    size_t wi2 = _write_index + _buf_size;
+    size_t wi1 = _write_index.load(std::memory_order_relaxed);
+    size_t wi2 = wi1 + _buf_size;
     // num_items were written to the buffer
     // copy the data to the second half of the buffer
 
@@ -40,14 +53,15 @@ void buffer_cpu_simple::post_write(int num_items)
     if (num_bytes_2)
         memcpy(&_buffer[0], &_buffer[_buf_size], num_bytes_2);
 
+    // advance the write pointer - the release store publishes both copies
+    advance_write_index(bytes_written, num_items);
+}
 
-    // advance the write pointer
-    _write_index += bytes_written;
-    if (_write_index >= _buf_size) {
-        _write_index -= _buf_size;
-    }
-
-    _total_written += num_items;
+void buffer_cpu_simple::set_numa_node(int node)
+{
+    // Both halves, the copy in post_write touches the second one too
+    numa::bind_memory(_buffer.get(), _alloc_size, node);
+    buffer::set_numa_node(node);
 }
 
 std::shared_ptr<buffer_reader>
@@ -63,14 +77,8 @@ buffer_cpu_simple::add_reader(std::shared_ptr<buffer_properties> buf_props,
 
 void buffer_cpu_simple_reader::post_read(int num_items)
 {
-    std::scoped_lock guard(_rdr_mutex);
-
     // advance the read pointer
-    _read_index += num_items * _itemsize; // _buffer->item_size();
-    if (_read_index >= _buffer->buf_size()) {
-        _read_index -= _buffer->buf_size();
-    }
-    _total_read += num_items;
+    advance_read_index(num_items * _itemsize, num_items);
 }
 
 } // namespace gr
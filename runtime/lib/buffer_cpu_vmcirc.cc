@@ -1,4 +1,5 @@
 #include <gnuradio/buffer_cpu_vmcirc.hh>
+#include <gnuradio/numa.hh>
 
 #include "buffer_cpu_vmcirc_mmap_shm_open.hh"
 #include "buffer_cpu_vmcirc_sysv_shm.hh"
@@ -63,32 +64,27 @@ buffer_cpu_vmcirc::buffer_cpu_vmcirc(size_t num_items,
     _write_index = 0;
 }
 
-void* buffer_cpu_vmcirc::write_ptr() { return (void*)&_buffer[_write_index]; }
+void* buffer_cpu_vmcirc::write_ptr()
+{
+    return (void*)&_buffer[_write_index.load(std::memory_order_relaxed)];
+}
 
 void buffer_cpu_vmcirc_reader::post_read(int num_items)
 {
-    std::scoped_lock guard(_rdr_mutex);
-
     // advance the read pointer
-    _read_index += num_items * _itemsize;
-    if (_read_index >= _buffer->buf_size()) {
-        _read_index -= _buffer->buf_size();
-    }
-    _total_read += num_items;
+    advance_read_index(num_items * _itemsize, num_items);
 }
 void buffer_cpu_vmcirc::post_write(int num_items)
 {
-    std::scoped_lock guard(_buf_mutex);
-
-    unsigned int bytes_written = num_items * _item_size;
-
     // advance the write pointer
-    _write_index += bytes_written;
-    if (_write_index >= _buf_size) {
-        _write_index -= _buf_size;
-    }
+    advance_write_index(num_items * _item_size, num_items);
+}
 
-    _total_written += num_items;
+void buffer_cpu_vmcirc::set_numa_node(int node)
+{
+    // The second mapping shares the pages of the first
+    numa::bind_memory(_buffer, _buf_size, node);
+    buffer::set_numa_node(node);
 }
 
 std::shared_ptr<buffer_reader> buffer_cpu_vmcirc::add_reader(std::shared_ptr<buffer_properties> buf_props, size_t itemsize)
@@ -1,14 +1,177 @@
 #include <gnuradio/buffer_management.hh>
+#include <gnuradio/buffer_passthrough.hh>
+
+#include "cachesize.hh"
+
+#include <algorithm>
 
 namespace gr {
 
+void buffer_manager::set_thread_groups(const std::vector<std::vector<block_sptr>>& groups)
+{
+    d_thread_group.clear();
+    for (size_t i = 0; i < groups.size(); i++) {
+        for (auto& b : groups[i]) {
+            d_thread_group[b->id()] = i;
+        }
+    }
+}
+
+void buffer_manager::compute_cache_aware_sizes(flat_graph_sptr fg)
+{
+    d_auto_buf_size.clear();
+
+    // Rate of the output of each block relative to the rate of the sources
+    std::map<nodeid_t, double> out_rate;
+    for (auto& subgraph : fg->partition()) {
+        for (auto& b : subgraph) {
+            double in_rate = 0.0;
+            for (auto& e : fg->stream_edges()) {
+                if (e->dst().node() == b) {
+                    auto it = out_rate.find(e->src().node()->id());
+                    if (it != out_rate.end()) {
+                        in_rate = std::max(in_rate, it->second);
+                    }
+                }
+            }
+            out_rate[b->id()] = (in_rate > 0.0 ? in_rate : 1.0) * b->relative_rate();
+        }
+    }
+
+    auto group_of = [this](node_sptr n) -> int64_t {
+        auto it = d_thread_group.find(n->id());
+        // Blocks without a group have a thread of their own
+        return it != d_thread_group.end() ? it->second : (int64_t{ 1 } << 32) + n->id();
+    };
+    const int64_t shared_domain = -1;
+
+    // Each buffer belongs to the L2 of its thread, or to the shared cache if any reader
+    // is on another thread, and is weighted by the bytes per source sample through it
+    std::map<port_sptr, std::pair<double, int64_t>> buffers;
+    for (auto& e : fg->stream_edges()) {
+        if (std::find(fg->nodes().begin(), fg->nodes().end(), e->src().node()) ==
+            fg->nodes().end()) {
+            continue;
+        }
+        auto it = out_rate.find(e->src().node()->id());
+        double weight = (it != out_rate.end() ? it->second : 1.0) * e->itemsize();
+        auto domain = group_of(e->src().node());
+        if (group_of(e->dst().node()) != domain) {
+            domain = shared_domain;
+        }
+
+        auto bit = buffers.find(e->src().port());
+        if (bit == buffers.end()) {
+            buffers[e->src().port()] = { weight, domain };
+        } else if (bit->second.second != domain) {
+            bit->second.second = shared_domain;
+        }
+    }
+
+    std::map<int64_t, double> domain_weight;
+    for (auto& b : buffers) {
+        domain_weight[b.second.second] += b.second.first;
+    }
+
+    for (auto& b : buffers) {
+        auto domain = b.second.second;
+        double budget = s_cache_fraction *
+                        (domain == shared_domain ? llc_cache_size() : l2_cache_size());
+        double share = domain_weight[domain] > 0.0 ? b.second.first / domain_weight[domain]
+                                                   : 1.0;
+        size_t size = std::clamp(
+            (size_t)(budget * share), s_min_auto_buf_size, s_max_auto_buf_size);
+        d_auto_buf_size[b.first] = size;
+
+        GR_LOG_DEBUG(_debug_logger,
+                     "cache aware size for {}: {} bytes ({})",
+                     b.first->alias(),
+                     size,
+                     domain == shared_domain ? "shared" : "same thread");
+    }
+}
+
+void buffer_manager::create_buffer(edge_sptr e,
+                                   flat_graph_sptr fg,
+                                   std::shared_ptr<buffer_properties> buf_props)
+{
+    size_t num_items = get_buffer_num_items(e, fg);
+    size_t alloc_items = num_items;
+    bool adaptive = d_adaptive && d_max_items_per_call == 0;
+    if (adaptive) {
+        alloc_items *= s_adaptive_headroom;
+    }
+
+    buffer_sptr buf;
+    if (e->has_custom_buffer()) {
+        buf = e->buffer_factory()(alloc_items, e->itemsize(), e->buf_properties());
+    } else {
+        buf = buf_props->factory()(alloc_items, e->itemsize(), buf_props);
+    }
+    e->src().port()->set_buffer(buf);
+
+    if (d_max_items_per_call > 0) {
+        buf->set_fill_limit(latency_fill_limit(e, fg));
+    } else if (adaptive) {
+        buf->set_fill_limit(num_items);
+        size_t min_items = get_min_buffer_num_items(e, fg);
+        if (e->itemsize() > 0) {
+            min_items = std::max(min_items, s_min_auto_buf_size / e->itemsize());
+        }
+        d_tuned_buffers.push_back({ buf, std::min(min_items, num_items), 0, 0 });
+    }
+
+    GR_LOG_INFO(_logger,
+                "Edge: {}, Buf: {}, {} bytes, {} items of size {}",
+                e->identifier(),
+                buf->type(),
+                buf->buf_size(),
+                buf->num_items(),
+                buf->item_size());
+}
+
+bool buffer_manager::is_pass_through_candidate(port_sptr p, flat_graph_sptr fg)
+{
+    auto input = p->pass_through();
+    if (!input || p->itemsize() == 0 || input->itemsize() != p->itemsize()) {
+        return false;
+    }
+
+    // Items are passed with the read pointer of the block, which the history would move
+    auto grblock = std::dynamic_pointer_cast<block>(fg->find_edge(p)[0]->src().node());
+    if (!grblock || grblock->max_history() > 1) {
+        return false;
+    }
+
+    auto in_edges = fg->find_edge(input);
+    if (in_edges.size() != 1 || in_edges[0]->has_custom_buffer() ||
+        std::find(fg->nodes().begin(), fg->nodes().end(), in_edges[0]->src().node()) ==
+            fg->nodes().end()) {
+        return false;
+    }
+
+    // Readers on the other side of a custom buffer expect it, not a host view
+    for (auto& e : fg->find_edge(p)) {
+        if (e->has_custom_buffer()) {
+            return false;
+        }
+    }
+    return true;
+}
+
 void buffer_manager::initialize_buffers(flat_graph_sptr fg,
                                         std::shared_ptr<buffer_properties> buf_props)
 {
+    if (d_policy == buffer_size_policy_t::CACHE_AWARE) {
+        compute_cache_aware_sizes(fg);
+    }
+
+    // Pass-through outputs wait for the buffer upstream of them
+    std::vector<edge_sptr> pass_through_edges;
+
     // not all edges may be used
     for (auto e : fg->stream_edges()) {
         // every edge needs a buffer
-        auto num_items = get_buffer_num_items(e, fg);
 
         // If buffer has not yet been created, e.g. 1:N block connection
         if (!e->src().port()->buffer()) {
@@ -17,22 +180,18 @@ void buffer_manager::initialize_buffers(flat_graph_sptr fg,
             if (std::find(fg->nodes().begin(), fg->nodes().end(), e->src().node()) !=
                 fg->nodes().end()) {
 
-                buffer_sptr buf;
-                if (e->has_custom_buffer()) {
-                    buf = e->buffer_factory()(
-                        num_items, e->itemsize(), e->buf_properties());
-                } else {
-                    buf = buf_props->factory()(num_items, e->itemsize(), buf_props);
+                if (is_pass_through_candidate(e->src().port(), fg)) {
+                    if (std::find_if(pass_through_edges.begin(),
+                                     pass_through_edges.end(),
+                                     [&e](edge_sptr pe) {
+                                         return pe->src().port() == e->src().port();
+                                     }) == pass_through_edges.end()) {
+                        pass_through_edges.push_back(e);
+                    }
+                    continue;
                 }
-                e->src().port()->set_buffer(buf);
 
-                GR_LOG_INFO(_logger,
-                            "Edge: {}, Buf: {}, {} bytes, {} items of size {}",
-                            e->identifier(),
-                            buf->type(),
-                            buf->buf_size(),
-                            buf->num_items(),
-                            buf->item_size());
+                create_buffer(e, fg, buf_props);
             }
         } else {
             auto buf = e->src().port()->buffer();
@@ -46,6 +205,56 @@ void buffer_manager::initialize_buffers(flat_graph_sptr fg,
         }
     }
 
+    // A pass-through can be downstream of another, so alias each one once the buffer
+    // above it exists, and give it a buffer of its own if that buffer cannot be aliased
+    std::vector<port_sptr> pass_through_inputs;
+    bool progress = true;
+    while (!pass_through_edges.empty()) {
+        if (!progress) {
+            // Only left in a loop of pass-throughs, break it with a real buffer
+            create_buffer(pass_through_edges.front(), fg, buf_props);
+            pass_through_edges.erase(pass_through_edges.begin());
+        }
+        progress = false;
+        for (auto it = pass_through_edges.begin(); it != pass_through_edges.end();) {
+            auto e = *it;
+            auto input = e->src().port()->pass_through();
+            auto in_edge = fg->find_edge(input)[0];
+            auto upstream = in_edge->src().port()->buffer();
+            if (!upstream) {
+                it++;
+                continue;
+            }
+
+            // The readers of the view read the upstream memory, which was only sized
+            // for the pass-through block and may be too small for them
+            if (upstream->supports_pass_through() &&
+                upstream->buf_size() % e->itemsize() == 0 &&
+                upstream->num_items() >= get_min_buffer_num_items(e, fg)) {
+                auto rdr = upstream->add_reader(in_edge->buf_properties(), input->itemsize());
+                input->set_buffer_reader(rdr);
+                pass_through_inputs.push_back(input);
+
+                auto buf = buffer_passthrough::make(upstream, rdr, e->itemsize());
+                if (d_max_items_per_call > 0) {
+                    buf->set_fill_limit(latency_fill_limit(e, fg));
+                }
+                e->src().port()->set_buffer(buf);
+                GR_LOG_INFO(_logger,
+                            "Edge: {}, Buf: {}, {} bytes, {} items of size {}",
+                            e->identifier(),
+                            buf->type(),
+                            buf->buf_size(),
+                            buf->num_items(),
+                            buf->item_size());
+            } else {
+                create_buffer(e, fg, buf_props);
+            }
+            it = pass_through_edges.erase(it);
+            progress = true;
+        }
+    }
+
     // Assuming all the buffers that the readers will be attaching to have been created at
     // this point.  Will need to handle crossings separately if doing something complex
     for (auto& b : fg->calc_used_blocks()) {
@@ -58,6 +267,12 @@ void buffer_manager::initialize_buffers(flat_graph_sptr fg,
                 throw std::runtime_error("Edge associated with input port not found");
             }
 
+            // The reader of a pass-through is already attached
+            if (std::find(pass_through_inputs.begin(), pass_through_inputs.end(), p) !=
+                pass_through_inputs.end()) {
+                continue;
+            }
+
             // TODO: more robust way of ensuring readers don't get double-added
             // If dst block is in this domain, then add the reader to the source port
             if (std::find(fg->nodes().begin(), fg->nodes().end(), ed[0]->dst().node()) !=
@@ -73,6 +288,13 @@ void buffer_manager::initialize_buffers(flat_graph_sptr fg,
     }
 }
 
+size_t buffer_manager::latency_fill_limit(edge_sptr e, flat_graph_sptr fg)
+{
+    // One call being read and one being written, but never less than the readers
+    // need for a single call of their own
+    return std::max(2 * d_max_items_per_call, get_min_buffer_num_items(e, fg));
+}
+
 int buffer_manager::get_buffer_num_items(edge_sptr e, flat_graph_sptr fg)
 {
     size_t item_size = e->itemsize();
@@ -82,6 +304,13 @@ int buffer_manager::get_buffer_num_items(edge_sptr e, flat_graph_sptr fg)
     // (We're double buffering, where we used to single buffer)
 
     size_t buf_size = s_fixed_buf_size;
+    auto auto_size = d_auto_buf_size.find(e->src().port());
+    if (d_policy == buffer_size_policy_t::CACHE_AWARE &&
+        auto_size != d_auto_buf_size.end()) {
+        // The cache aware size is the whole buffer, already double buffered
+        buf_size = auto_size->second / 2;
+    }
+
     if (e->has_custom_buffer()) {
 
         auto req_buf_size = e->buf_properties()->buffer_size();
@@ -102,6 +331,13 @@ int buffer_manager::get_buffer_num_items(edge_sptr e, flat_graph_sptr fg)
 
     size_t nitems = item_size == 0 ?  0 : (buf_size * 2) / item_size;
 
+    return std::max(nitems, get_min_buffer_num_items(e, fg));
+}
+
+size_t buffer_manager::get_min_buffer_num_items(edge_sptr e, flat_graph_sptr fg)
+{
+    size_t nitems = 0;
+
     auto grblock = std::dynamic_pointer_cast<block>(e->src().node());
     if (grblock == nullptr) // might be a domain adapter, not a block
     {
@@ -126,11 +362,76 @@ int buffer_manager::get_buffer_num_items(edge_sptr e, flat_graph_sptr fg)
         // double decimation = (1.0 / dgrblock->relative_rate());
         double decimation = (1.0 / p->relative_rate());
         int multiple = p->output_multiple();
-        nitems = std::max(nitems, static_cast<size_t>(2 * (decimation * multiple)));
+        // the history stays in the buffer behind the reader, as much as it may grow to
+        nitems = std::max(
+            nitems, static_cast<size_t>(2 * (decimation * multiple + p->max_history())));
         // std::max(nitems, static_cast<int>(2 * (decimation * multiple)));
     }
 
     return nitems;
 }
 
+void buffer_manager::adapt()
+{
+    for (auto& t : d_tuned_buffers) {
+        auto output_blocked = t.buf->output_blocked_count();
+        uint64_t input_blocked = 0;
+        for (auto& r : t.buf->readers()) {
+            input_blocked += r->input_blocked_count();
+        }
+
+        auto d_out = output_blocked - t.last_output_blocked;
+        auto d_in = input_blocked - t.last_input_blocked;
+        t.last_output_blocked = output_blocked;
+        t.last_input_blocked = input_blocked;
+
+        auto limit = t.buf->fill_limit();
+        // the writer never gets more than half of the buffer
+        size_t max_limit = t.buf->num_items() / 2;
+        size_t new_limit = limit;
+        if (d_out > 0 && d_in > 0) {
+            new_limit = std::min(limit * 2, max_limit);
+        } else if (d_out > 0 && d_in == 0) {
+            new_limit = std::max(limit / 2, t.min_items);
+        }
+
+        if (new_limit != limit) {
+            GR_LOG_DEBUG(_debug_logger,
+                         "fill limit {} -> {} items, blocked out {} in {}",
+                         limit,
+                         new_limit,
+                         d_out,
+                         d_in);
+            t.buf->set_fill_limit(new_limit);
+        }
+    }
+}
+
+void buffer_manager::start_adaptation(std::chrono::milliseconds period)
+{
+    std::unique_lock<std::mutex> lk(d_adapt_mutex);
+    if (!d_adaptive || d_adapt_running) {
+        return;
+    }
+    d_adapt_running = true;
+    d_adapt_thread = std::thread([this, period]() {
+        std::unique_lock<std::mutex> lk(d_adapt_mutex);
+        while (!d_adapt_cv.wait_for(lk, period, [this] { return !d_adapt_running; })) {
+            adapt();
+        }
+    });
+}
+
+void buffer_manager::stop_adaptation()
+{
+    {
+        std::lock_guard<std::mutex> lk(d_adapt_mutex);
+        d_adapt_running = false;
+    }
+    d_adapt_cv.notify_all();
+    if (d_adapt_thread.joinable()) {
+        d_adapt_thread.join();
+    }
+}
+
 } // namespace gr
@@ -0,0 +1,82 @@
+#include <gnuradio/buffer_passthrough.hh>
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace gr {
+
+buffer_passthrough::buffer_passthrough(buffer_sptr upstream,
+                                       buffer_reader_sptr upstream_reader,
+                                       size_t item_size)
+    : buffer(item_size ? upstream->buf_size() / item_size : 0, item_size, nullptr),
+      _upstream(upstream),
+      _upstream_reader(upstream_reader)
+{
+    if (item_size == 0 || upstream->buf_size() % item_size != 0) {
+        throw std::invalid_argument(
+            "buffer_passthrough: item size must divide the upstream buffer size");
+    }
+    if (!upstream->supports_pass_through()) {
+        throw std::invalid_argument(
+            "buffer_passthrough: upstream buffer of type " + upstream->type() +
+            " cannot be aliased");
+    }
+
+    // Writing starts where the block starts reading
+    _write_index = upstream_reader->read_index();
+    upstream_reader->set_pass_through(this);
+
+    set_type("buffer_passthrough(" + upstream->type() + ")");
+}
+
+buffer_sptr buffer_passthrough::make(buffer_sptr upstream,
+                                     buffer_reader_sptr upstream_reader,
+                                     size_t item_size)
+{
+    return buffer_sptr(new buffer_passthrough(upstream, upstream_reader, item_size));
+}
+
+void* buffer_passthrough::write_ptr()
+{
+    return _upstream->read_ptr(_write_index.load(std::memory_order_relaxed));
+}
+
+size_t buffer_passthrough::space_available()
+{
+    int space_in_items = _upstream_reader->bytes_available() / _item_size;
+
+    // Held to the fill limit as the buffers with memory of their own are
+    auto fill_limit = _fill_limit.load(std::memory_order_relaxed);
+    if (fill_limit > 0) {
+        space_in_items = std::min(space_in_items,
+                                  (int)fill_limit - (int)(bytes_in_use() / _item_size));
+    }
+
+    if (space_in_items < 0)
+        space_in_items = 0;
+
+    return space_in_items;
+}
+
+void buffer_passthrough::post_write(int num_items)
+{
+    // The items are already in place, publishing them is all there is to do
+    advance_write_index(num_items * _item_size, num_items);
+}
+
+std::shared_ptr<buffer_reader>
+buffer_passthrough::add_reader(std::shared_ptr<buffer_properties> buf_props,
+                               size_t itemsize)
+{
+    std::shared_ptr<buffer_passthrough_reader> r(new buffer_passthrough_reader(
+        shared_from_this(), buf_props, itemsize, _write_index));
+    _readers.push_back(r.get());
+    return r;
+}
+
+void buffer_passthrough_reader::post_read(int num_items)
+{
+    advance_read_index(num_items * _itemsize, num_items);
+}
+
+} // namespace gr
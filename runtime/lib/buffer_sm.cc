@@ -208,7 +208,7 @@ bool buffer_sm::adjust_buffer_data(memcpy_func_t memcpy_func, memmove_func_t mem
 
 
     // Shift existing data down to make room for blocked data at end of buffer
-    auto move_data_size = _write_index;
+    size_t move_data_size = _write_index;
     auto dest = _buffer.data() + max_bytes_avail;
     memmove_func(dest, _buffer.data(), move_data_size);
 
@@ -0,0 +1,108 @@
+/* -*- c++ -*- */
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#include "cachesize.hh"
+#include <gnuradio/logging.hh>
+#include <unistd.h>
+#include <algorithm>
+#include <fstream>
+#include <string>
+
+namespace gr {
+
+namespace {
+
+const size_t s_default_l2_size = 1024 * 1024;
+const size_t s_default_llc_size = 8 * 1024 * 1024;
+
+// Read "index*/size" of the given cache level for cpu0 from sysfs, 0 if not found
+size_t sysfs_cache_size(int level)
+{
+    size_t result = 0;
+    for (int idx = 0; idx < 16; idx++) {
+        std::string dir = "/sys/devices/system/cpu/cpu0/cache/index" +
+                          std::to_string(idx) + "/";
+        std::ifstream level_file(dir + "level");
+        if (!level_file) {
+            break;
+        }
+        int l = 0;
+        level_file >> l;
+
+        std::ifstream type_file(dir + "type");
+        std::string type;
+        type_file >> type;
+        if (type == "Instruction") {
+            continue;
+        }
+
+        std::ifstream size_file(dir + "size");
+        std::string size;
+        size_file >> size;
+        if (size.empty()) {
+            continue;
+        }
+        size_t bytes = std::stoul(size);
+        if (size.back() == 'K') {
+            bytes *= 1024;
+        } else if (size.back() == 'M') {
+            bytes *= 1024 * 1024;
+        }
+
+        if (level < 0 ? l >= 2 : l == level) {
+            // For the last level take the largest cache found
+            result = std::max(result, bytes);
+        }
+    }
+    return result;
+}
+
+size_t lookup_cache_size(int sysconf_name, int level, size_t fallback)
+{
+    long size = -1;
+#if defined(_SC_LEVEL2_CACHE_SIZE)
+    if (sysconf_name >= 0) {
+        size = sysconf(sysconf_name);
+    }
+#endif
+    if (size > 0) {
+        return size;
+    }
+
+    size_t s = sysfs_cache_size(level);
+    if (s > 0) {
+        return s;
+    }
+
+    auto logger = logging::get_logger("cachesize", "default");
+    GR_LOG_INFO(logger, "cache size unknown, assuming {} bytes", fallback);
+    return fallback;
+}
+
+} // namespace
+
+size_t l2_cache_size()
+{
+#if defined(_SC_LEVEL2_CACHE_SIZE)
+    static size_t s_size = lookup_cache_size(_SC_LEVEL2_CACHE_SIZE, 2, s_default_l2_size);
+#else
+    static size_t s_size = lookup_cache_size(-1, 2, s_default_l2_size);
+#endif
+    return s_size;
+}
+
+size_t llc_cache_size()
+{
+#if defined(_SC_LEVEL3_CACHE_SIZE)
+    static size_t s_size = lookup_cache_size(_SC_LEVEL3_CACHE_SIZE, -1, s_default_llc_size);
+#else
+    static size_t s_size = lookup_cache_size(-1, -1, s_default_llc_size);
+#endif
+    // Without a third level, the L2 is the last level
+    return std::max(s_size, l2_cache_size());
+}
+
+} /* namespace gr */
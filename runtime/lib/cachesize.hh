@@ -0,0 +1,26 @@
+/* -*- c++ -*- */
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#ifndef GR_CACHESIZE_H_
+#define GR_CACHESIZE_H_
+
+#include <cstddef>
+
+namespace gr {
+
+/*!
+ * \brief return the size in bytes of the L2 cache of one core
+ */
+size_t l2_cache_size();
+
+/*!
+ * \brief return the size in bytes of the last level (shared) cache
+ */
+size_t llc_cache_size();
+
+} /* namespace gr */
+
+#endif /* GR_CACHESIZE_H_ */
@@ -165,6 +165,10 @@ block_vector_t flat_graph::topological_sort(block_vector_t& blocks)
     block_vector_t result;
     tmp = sort_sources_first(blocks);
 
+    // Blocks outside of the requested set are treated as already visited
+    for (auto& b : calc_used_blocks())
+        b->attributes.set_int_value(BLOCK_COLOR_KEY, BLACK);
+
     // Start 'em all white
     for (block_viter_t p = tmp.begin(); p != tmp.end(); p++)
         (*p)->attributes.set_int_value(BLOCK_COLOR_KEY,WHITE);
@@ -222,7 +226,7 @@ void flat_graph::topological_dfs_visit(block_sptr block, block_vector_t& output)
         }
     }
 
-
+    block->attributes.set_int_value(BLOCK_COLOR_KEY, BLACK);
     output.push_back(block);
 }
 
@@ -0,0 +1,179 @@
+/* -*- c++ -*- */
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#include <gnuradio/numa.hh>
+#include <gnuradio/logging.hh>
+
+#include "pagesize.hh"
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#if defined(__linux__)
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#endif
+
+namespace gr {
+namespace numa {
+
+namespace {
+
+// From linux/mempolicy.h, kept here so that libnuma is not needed
+const int s_mpol_preferred = 1;
+const unsigned int s_mpol_mf_move = 1 << 1;
+
+struct topology {
+    std::vector<std::vector<unsigned int>> node_cpus;
+    std::map<unsigned int, int> cpu_node;
+};
+
+// Parse a sysfs list such as "0-3,8-11"
+std::vector<unsigned int> parse_cpulist(const std::string& list)
+{
+    std::vector<unsigned int> cpus;
+    std::stringstream ss(list);
+    std::string range;
+    while (std::getline(ss, range, ',')) {
+        if (range.empty()) {
+            continue;
+        }
+        auto dash = range.find('-');
+        unsigned int first = std::stoul(range.substr(0, dash));
+        unsigned int last =
+            dash == std::string::npos ? first : std::stoul(range.substr(dash + 1));
+        for (unsigned int c = first; c <= last; c++) {
+            cpus.push_back(c);
+        }
+    }
+    return cpus;
+}
+
+topology read_topology()
+{
+    topology t;
+    std::ifstream online("/sys/devices/system/node/online");
+    std::string nodes;
+    std::getline(online, nodes);
+    for (auto node : parse_cpulist(nodes)) {
+        std::ifstream f("/sys/devices/system/node/node" + std::to_string(node) +
+                        "/cpulist");
+        std::string list;
+        std::getline(f, list);
+        t.node_cpus.resize(std::max((size_t)node + 1, t.node_cpus.size()));
+        t.node_cpus[node] = parse_cpulist(list);
+    }
+
+    if (t.node_cpus.empty()) {
+        // No NUMA information, everything is on node 0
+        t.node_cpus.resize(1);
+        for (unsigned int c = 0; c < std::max(1u, std::thread::hardware_concurrency());
+             c++) {
+            t.node_cpus[0].push_back(c);
+        }
+    }
+
+    for (size_t node = 0; node < t.node_cpus.size(); node++) {
+        for (auto c : t.node_cpus[node]) {
+            t.cpu_node[c] = node;
+        }
+    }
+    return t;
+}
+
+const topology& get_topology()
+{
+    static topology s_topology = read_topology();
+    return s_topology;
+}
+
+} // namespace
+
+int num_nodes() { return get_topology().node_cpus.size(); }
+
+std::vector<unsigned int> node_cpus(int node)
+{
+    auto& t = get_topology();
+    if (node < 0 || node >= (int)t.node_cpus.size()) {
+        return {};
+    }
+    return t.node_cpus[node];
+}
+
+int node_of_cpu(unsigned int cpu)
+{
+    auto& t = get_topology();
+    auto it = t.cpu_node.find(cpu);
+    return it == t.cpu_node.end() ? -1 : it->second;
+}
+
+int node_of_cpus(const std::vector<unsigned int>& cpus)
+{
+    int node = -1;
+    for (auto c : cpus) {
+        int n = node_of_cpu(c);
+        if (n < 0 || (node >= 0 && n != node)) {
+            return -1;
+        }
+        node = n;
+    }
+    return node;
+}
+
+int current_node()
+{
+#if defined(__linux__)
+    int cpu = sched_getcpu();
+    if (cpu >= 0) {
+        return std::max(node_of_cpu(cpu), 0);
+    }
+#endif
+    return 0;
+}
+
+bool bind_memory(void* addr, size_t len, int node)
+{
+    if (num_nodes() <= 1 || node < 0 || node >= num_nodes()) {
+        return true;
+    }
+
+#if defined(__linux__) && defined(SYS_mbind)
+    // mbind works on whole pages
+    size_t page = gr::pagesize();
+    auto start = ((uintptr_t)addr + page - 1) / page * page;
+    auto end = ((uintptr_t)addr + len) / page * page;
+    if (end <= start) {
+        return true;
+    }
+
+    const size_t bits = 8 * sizeof(unsigned long);
+    std::vector<unsigned long> nodemask(num_nodes() / bits + 1, 0);
+    nodemask[node / bits] |= 1UL << (node % bits);
+
+    if (syscall(SYS_mbind,
+                (void*)start,
+                end - start,
+                s_mpol_preferred,
+                nodemask.data(),
+                nodemask.size() * bits,
+                s_mpol_mf_move) != 0) {
+        auto logger = logging::get_logger("numa", "default");
+        GR_LOG_WARN(logger, "mbind to node {} failed: {}", node, strerror(errno));
+        return false;
+    }
+#endif
+    return true;
+}
+
+} /* namespace numa */
+} /* namespace gr */
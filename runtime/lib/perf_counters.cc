@@ -0,0 +1,125 @@
+#include <gnuradio/perf_counters.hh>
+
+namespace gr {
+
+namespace {
+// Update from the single writer, so load/store does not lose increments
+template <typename T>
+inline void add_relaxed(std::atomic<T>& a, T v)
+{
+    a.store(a.load(std::memory_order_relaxed) + v, std::memory_order_relaxed);
+}
+
+inline void average_relaxed(std::atomic<double>& a, double v, double alpha)
+{
+    auto avg = a.load(std::memory_order_relaxed);
+    a.store(avg + alpha * (v - avg), std::memory_order_relaxed);
+}
+} // namespace
+
+void perf_counters::record_blocked(blocked_state_t state)
+{
+    if (state == blocked_state_t::INPUT) {
+        add_relaxed<uint64_t>(d_input_blocked, 1);
+    } else {
+        add_relaxed<uint64_t>(d_output_blocked, 1);
+    }
+
+    // Only the first check of a streak needs the time, the streak ends at the next work
+    if (d_blocked_state != state) {
+        d_blocked_state = state;
+        d_blocked_since = clock::now();
+    }
+}
+
+void perf_counters::record_work(clock::time_point start,
+                                clock::time_point end,
+                                size_t noutput_items,
+                                uint64_t nconsumed,
+                                uint64_t nproduced,
+                                double input_fill,
+                                double output_fill)
+{
+    if (d_blocked_state != blocked_state_t::NONE) {
+        uint64_t blocked_ns =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(start - d_blocked_since)
+                .count();
+        add_relaxed(d_blocked_state == blocked_state_t::INPUT ? d_input_blocked_ns
+                                                              : d_output_blocked_ns,
+                    blocked_ns);
+        d_blocked_state = blocked_state_t::NONE;
+    }
+
+    uint64_t work_ns =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+    double work_time = work_ns * 1e-9;
+
+    add_relaxed<uint64_t>(d_work_calls, 1);
+    add_relaxed(d_items_consumed, nconsumed);
+    add_relaxed(d_items_produced, nproduced);
+    add_relaxed(d_work_time_ns, work_ns);
+
+    auto avg = d_avg_work_time.load(std::memory_order_relaxed);
+    auto var = d_var_work_time.load(std::memory_order_relaxed);
+    auto diff = work_time - avg;
+    d_avg_work_time.store(avg + s_alpha * diff, std::memory_order_relaxed);
+    d_var_work_time.store((1.0 - s_alpha) * (var + s_alpha * diff * diff),
+                          std::memory_order_relaxed);
+
+    average_relaxed(d_avg_noutput_items, (double)noutput_items, s_alpha);
+    average_relaxed(d_avg_input_fill, input_fill, s_alpha);
+    average_relaxed(d_avg_output_fill, output_fill, s_alpha);
+
+    size_t bucket = 0;
+    while (work_ns > 1 && bucket < s_histogram_buckets - 1) {
+        work_ns >>= 1;
+        bucket++;
+    }
+    add_relaxed<uint64_t>(d_histogram[bucket], 1);
+}
+
+perf_counters_snapshot perf_counters::snapshot() const
+{
+    perf_counters_snapshot s;
+    s.work_calls = d_work_calls.load(std::memory_order_relaxed);
+    s.items_consumed = d_items_consumed.load(std::memory_order_relaxed);
+    s.items_produced = d_items_produced.load(std::memory_order_relaxed);
+    s.work_time = d_work_time_ns.load(std::memory_order_relaxed) * 1e-9;
+    s.avg_work_time = d_avg_work_time.load(std::memory_order_relaxed);
+    s.var_work_time = d_var_work_time.load(std::memory_order_relaxed);
+    s.avg_noutput_items = d_avg_noutput_items.load(std::memory_order_relaxed);
+    s.input_blocked = d_input_blocked.load(std::memory_order_relaxed);
+    s.output_blocked = d_output_blocked.load(std::memory_order_relaxed);
+    s.input_blocked_time = d_input_blocked_ns.load(std::memory_order_relaxed) * 1e-9;
+    s.output_blocked_time = d_output_blocked_ns.load(std::memory_order_relaxed) * 1e-9;
+    s.avg_input_buffer_fill = d_avg_input_fill.load(std::memory_order_relaxed);
+    s.avg_output_buffer_fill = d_avg_output_fill.load(std::memory_order_relaxed);
+    s.work_time_histogram.reserve(s_histogram_buckets);
+    for (auto& h : d_histogram) {
+        s.work_time_histogram.push_back(h.load(std::memory_order_relaxed));
+    }
+    return s;
+}
+
+void perf_counters::reset()
+{
+    // Not synchronized with the executor, an update racing with the reset may survive it
+    d_work_calls = 0;
+    d_items_consumed = 0;
+    d_items_produced = 0;
+    d_work_time_ns = 0;
+    d_avg_work_time = 0.0;
+    d_var_work_time = 0.0;
+    d_avg_noutput_items = 0.0;
+    d_input_blocked = 0;
+    d_output_blocked = 0;
+    d_input_blocked_ns = 0;
+    d_output_blocked_ns = 0;
+    d_avg_input_fill = 0.0;
+    d_avg_output_fill = 0.0;
+    for (auto& h : d_histogram) {
+        h = 0;
+    }
+}
+
+} // namespace gr
@@ -0,0 +1,115 @@
+#include <gnuradio/perf_monitor.hh>
+
+#include <sstream>
+#include <stdexcept>
+
+namespace gr {
+
+perf_monitor::sptr perf_monitor::make(graph_sptr g,
+                                      std::chrono::milliseconds period,
+                                      const std::string& filename)
+{
+    std::vector<block_sptr> blocks;
+    for (auto& n : g->calc_used_nodes()) {
+        auto b = std::dynamic_pointer_cast<block>(n);
+        if (b) {
+            blocks.push_back(b);
+        }
+    }
+    return make(blocks, period, filename);
+}
+
+perf_monitor::perf_monitor(const std::vector<block_sptr>& blocks,
+                           std::chrono::milliseconds period,
+                           const std::string& filename)
+    : d_blocks(blocks), d_period(period), d_filename(filename)
+{
+    _logger = logging::get_logger("perf_monitor", "default");
+    for (auto& b : d_blocks) {
+        b->set_perf_counters_enabled(true);
+    }
+}
+
+std::string perf_monitor::csv_header()
+{
+    return "time,block,work_calls,items_consumed,items_produced,work_time,"
+           "avg_work_time,var_work_time,avg_noutput_items,input_blocked,output_blocked,"
+           "input_blocked_time,output_blocked_time,avg_input_buffer_fill,"
+           "avg_output_buffer_fill";
+}
+
+std::string perf_monitor::report()
+{
+    auto t = std::chrono::duration<double>(std::chrono::steady_clock::now() - d_t0);
+    std::ostringstream os;
+    for (auto& b : d_blocks) {
+        auto s = b->pc_snapshot();
+        os << t.count() << "," << b->alias() << "," << s.work_calls << ","
+           << s.items_consumed << "," << s.items_produced << "," << s.work_time << ","
+           << s.avg_work_time << "," << s.var_work_time << "," << s.avg_noutput_items
+           << "," << s.input_blocked << "," << s.output_blocked << ","
+           << s.input_blocked_time << "," << s.output_blocked_time << ","
+           << s.avg_input_buffer_fill << "," << s.avg_output_buffer_fill << std::endl;
+    }
+    return os.str();
+}
+
+void perf_monitor::dump()
+{
+    auto r = report();
+    if (d_file.is_open()) {
+        d_file << r;
+        d_file.flush();
+    } else {
+        std::istringstream is(r);
+        std::string line;
+        while (std::getline(is, line)) {
+            GR_LOG_INFO(_logger, "{}", line);
+        }
+    }
+}
+
+void perf_monitor::start()
+{
+    std::lock_guard<std::mutex> lk(d_mutex);
+    if (d_running) {
+        return;
+    }
+
+    if (!d_filename.empty()) {
+        d_file.open(d_filename, std::ios::out | std::ios::trunc);
+        if (!d_file.is_open()) {
+            throw std::runtime_error("perf_monitor: could not open " + d_filename);
+        }
+        d_file << csv_header() << std::endl;
+    }
+
+    d_t0 = std::chrono::steady_clock::now();
+    d_running = true;
+    d_thread = std::thread([this]() {
+        std::unique_lock<std::mutex> lk(d_mutex);
+        while (!d_cv.wait_for(lk, d_period, [this] { return !d_running; })) {
+            dump();
+        }
+    });
+}
+
+void perf_monitor::stop()
+{
+    {
+        std::lock_guard<std::mutex> lk(d_mutex);
+        if (!d_running) {
+            return;
+        }
+        d_running = false;
+    }
+    d_cv.notify_all();
+    if (d_thread.joinable()) {
+        d_thread.join();
+    }
+    // Final values
+    dump();
+    d_file.close();
+}
+
+} // namespace gr
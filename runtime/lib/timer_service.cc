@@ -0,0 +1,89 @@
+#include <gnuradio/thread.hh>
+#include <gnuradio/timer_service.hh>
+
+namespace gr {
+
+timer_service& timer_service::instance()
+{
+    static timer_service s_instance;
+    return s_instance;
+}
+
+timer_service::timer_service()
+{
+    d_thread = std::thread(&timer_service::run, this);
+    thread::set_thread_name(d_thread.native_handle(), "timer_service");
+}
+
+timer_service::~timer_service()
+{
+    {
+        std::lock_guard<std::mutex> lock(d_mutex);
+        d_stop = true;
+    }
+    d_cv.notify_one();
+    d_thread.join();
+}
+
+timer_service::timer_id timer_service::schedule_at(clock::time_point when, callback_t fn)
+{
+    timer_id id;
+    bool earliest;
+    {
+        std::lock_guard<std::mutex> lock(d_mutex);
+        id = d_next_id++;
+        d_timers.emplace(key_t(when, id), std::move(fn));
+        d_deadlines.emplace(id, when);
+        earliest = d_timers.begin()->first.second == id;
+    }
+    // Only a new earliest deadline changes how long the thread sleeps
+    if (earliest) {
+        d_cv.notify_one();
+    }
+    return id;
+}
+
+bool timer_service::cancel(timer_id id)
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    auto it = d_deadlines.find(id);
+    if (it == d_deadlines.end()) {
+        return false;
+    }
+    d_timers.erase(key_t(it->second, id));
+    d_deadlines.erase(it);
+    return true;
+}
+
+size_t timer_service::pending()
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    return d_timers.size();
+}
+
+void timer_service::run()
+{
+    std::unique_lock<std::mutex> lock(d_mutex);
+    while (!d_stop) {
+        if (d_timers.empty()) {
+            d_cv.wait(lock);
+            continue;
+        }
+
+        auto it = d_timers.begin();
+        if (it->first.first > clock::now()) {
+            d_cv.wait_until(lock, it->first.first);
+            continue;
+        }
+
+        auto fn = std::move(it->second);
+        d_deadlines.erase(it->first.second);
+        d_timers.erase(it);
+
+        lock.unlock();
+        fn();
+        lock.lock();
+    }
+}
+
+} // namespace gr
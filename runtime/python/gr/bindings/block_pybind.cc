@@ -36,6 +36,12 @@ void bind_block(py::module& m)
             &block::produce_each)
         .def("consume_each",
             &block::consume_each)
+        .def("pc_snapshot",
+            &block::pc_snapshot)
+        .def("reset_perf_counters",
+            &block::reset_perf_counters)
+        .def("set_perf_counters_enabled",
+            &block::set_perf_counters_enabled)
         ;
 
 }
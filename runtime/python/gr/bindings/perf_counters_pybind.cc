@@ -0,0 +1,60 @@
+/*
+ * Copyright 2022 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#include <pybind11/chrono.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+#include <gnuradio/perf_counters.hh>
+#include <gnuradio/perf_monitor.hh>
+
+void bind_perf_counters(py::module& m)
+{
+    using perf_counters_snapshot = ::gr::perf_counters_snapshot;
+    using perf_monitor = ::gr::perf_monitor;
+
+    py::class_<perf_counters_snapshot>(m, "perf_counters_snapshot")
+        .def_readonly("work_calls", &perf_counters_snapshot::work_calls)
+        .def_readonly("items_consumed", &perf_counters_snapshot::items_consumed)
+        .def_readonly("items_produced", &perf_counters_snapshot::items_produced)
+        .def_readonly("work_time", &perf_counters_snapshot::work_time)
+        .def_readonly("avg_work_time", &perf_counters_snapshot::avg_work_time)
+        .def_readonly("var_work_time", &perf_counters_snapshot::var_work_time)
+        .def_readonly("avg_noutput_items", &perf_counters_snapshot::avg_noutput_items)
+        .def_readonly("input_blocked", &perf_counters_snapshot::input_blocked)
+        .def_readonly("output_blocked", &perf_counters_snapshot::output_blocked)
+        .def_readonly("input_blocked_time", &perf_counters_snapshot::input_blocked_time)
+        .def_readonly("output_blocked_time",
+                      &perf_counters_snapshot::output_blocked_time)
+        .def_readonly("avg_input_buffer_fill",
+                      &perf_counters_snapshot::avg_input_buffer_fill)
+        .def_readonly("avg_output_buffer_fill",
+                      &perf_counters_snapshot::avg_output_buffer_fill)
+        .def_readonly("work_time_histogram",
+                      &perf_counters_snapshot::work_time_histogram);
+
+    py::class_<perf_monitor, std::shared_ptr<perf_monitor>>(m, "perf_monitor")
+        .def(py::init(py::overload_cast<const std::vector<gr::block_sptr>&,
+                                        std::chrono::milliseconds,
+                                        const std::string&>(&perf_monitor::make)),
+             py::arg("blocks"),
+             py::arg("period") = std::chrono::milliseconds(1000),
+             py::arg("filename") = "")
+        .def(py::init(py::overload_cast<gr::graph_sptr,
+                                        std::chrono::milliseconds,
+                                        const std::string&>(&perf_monitor::make)),
+             py::arg("graph"),
+             py::arg("period") = std::chrono::milliseconds(1000),
+             py::arg("filename") = "")
+        .def("start", &perf_monitor::start)
+        .def("stop", &perf_monitor::stop)
+        .def("report", &perf_monitor::report);
+}
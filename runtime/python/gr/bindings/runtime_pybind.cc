@@ -35,6 +35,7 @@ void bind_vmcircbuf(py::module&);
 void bind_domain(py::module&);
 void bind_constants(py::module&);
 void bind_python_block(py::module&);
+void bind_perf_counters(py::module&);
 #ifdef HAVE_CUDA
 void bind_buffer_cuda(py::module&);
 void bind_buffer_cuda_pinned(py::module&);
@@ -76,6 +77,7 @@ PYBIND11_MODULE(runtime_python, m)
     bind_vmcircbuf(m);
     bind_constants(m);
     bind_python_block(m);
+    bind_perf_counters(m);
     
     #ifdef HAVE_CUDA
     bind_buffer_cuda(m);
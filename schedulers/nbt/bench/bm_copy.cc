@@ -81,7 +81,9 @@ int main(int argc, char* argv[])
         auto sched = schedulers::scheduler_nbt::make("nbt", buffer_size);
         fg->add_scheduler(sched);
 
-        if (buffer_type == 1) {
+        if (buffer_type == 0) {
+            sched->set_default_buffer_factory(BUFFER_CPU_SIMPLE_ARGS);
+        } else if (buffer_type == 1) {
             sched->set_default_buffer_factory(BUFFER_CPU_VMCIRC_ARGS);
         }
 
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <gnuradio/block.hh>
+#include <gnuradio/block_group_properties.hh>
+#include <gnuradio/buffer_management.hh>
+#include <gnuradio/flat_graph.hh>
+
+#include <string>
+#include <vector>
+
+namespace gr {
+namespace schedulers {
+
+/**
+ * @brief Options for automatically assigning blocks to threads
+ *
+ */
+struct auto_partition_properties {
+    unsigned int max_threads = 0;  // 0 uses the hardware concurrency
+    double warmup_seconds = 0.1;   // length of the profiling run
+    std::string profile_file = ""; // reused if it matches the graph, written otherwise
+    bool pin_heavy_blocks = true;  // give blocks that need a whole core their own CPU
+};
+
+/**
+ * @brief Groups blocks onto threads from their measured cost
+ *
+ * The cost of each block is the time spent in work during a short single threaded
+ * warm-up run of the graph, or is read back from a profile saved by a previous run.
+ * Walking the graph in topological order, adjacent cheap blocks are fused into the same
+ * thread until the group holds its share of the total cost, and blocks that need a
+ * whole core on their own get a dedicated thread.
+ *
+ */
+class auto_partitioner
+{
+private:
+    auto_partition_properties d_props;
+    logger_sptr _logger;
+    logger_sptr _debug_logger;
+    std::vector<uint64_t> d_items;
+
+public:
+    auto_partitioner(const auto_partition_properties& props);
+
+    /**
+     * @brief Order the blocks of the graph so that each block follows its upstream
+     * blocks
+     */
+    static block_vector_t order_blocks(flat_graph_sptr fg, block_vector_t blocks);
+
+    /**
+     * @brief Run the blocks on the calling thread and time each one
+     *
+     * Stops after the warm-up time, when a block reports DONE or when no block can make
+     * progress.  The data produced is kept in the buffers and flows on when the threads
+     * start.  Notifications and messages produced meanwhile are returned per block so
+     * they can be delivered to the real threads.  The blocks are started here and left
+     * running, the threads must not start them again.
+     *
+     * @param bufman buffers of the graph, already initialized
+     * @param blocks blocks in topological order
+     * @param pending_msgs messages sent to each block during the warm-up
+     * @return std::vector<double> seconds spent in work for each block
+     */
+    std::vector<double>
+    measure(buffer_manager::sptr bufman,
+            const block_vector_t& blocks,
+            std::vector<std::vector<scheduler_message_sptr>>& pending_msgs);
+
+    /**
+     * @brief Load a saved profile
+     *
+     * @return std::vector<double> costs in the order of blocks, or empty if there is no
+     * profile or it was made for a different graph
+     */
+    std::vector<double> load_profile(const block_vector_t& blocks);
+    void save_profile(const block_vector_t& blocks, const std::vector<double>& cost);
+
+    /**
+     * @brief Items each block produced (consumed for sinks) during the last measure()
+     */
+    const std::vector<uint64_t>& items() const { return d_items; }
+
+    /**
+     * @brief Form the block groups
+     *
+     * @param blocks blocks in topological order
+     * @param cost relative cost of each block
+     * @param nthreads number of threads to spread the cost over
+     * @param pin_heavy_blocks set the affinity of dedicated threads to separate CPUs
+     * @param reserved_cpus CPUs already in the affinity of other groups, never pinned to
+     */
+    static std::vector<block_group_properties>
+    partition(const block_vector_t& blocks,
+              const std::vector<double>& cost,
+              unsigned int nthreads,
+              bool pin_heavy_blocks = true,
+              const std::vector<unsigned int>& reserved_cpus = {});
+};
+
+} // namespace schedulers
+} // namespace gr
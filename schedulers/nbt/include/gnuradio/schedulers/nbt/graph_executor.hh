@@ -5,7 +5,9 @@
 #include <gnuradio/buffer_management.hh>
 #include <gnuradio/executor.hh>
 
-#include <map>
+#include <algorithm>
+#include <chrono>
+#include <vector>
 
 namespace gr {
 namespace schedulers {
@@ -22,25 +24,92 @@ class graph_executor : public executor
 private:
     std::vector<block_sptr> d_blocks;
 
+    // Persistent ports and work i/o descriptors for each block slot, created once in
+    // initialize() and reset on every call so that the steady state work path does not
+    // allocate
+    std::vector<port_vector_t> d_input_ports;
+    std::vector<port_vector_t> d_output_ports;
+    std::vector<std::vector<block_work_input_sptr>> d_work_inputs;
+    std::vector<std::vector<block_work_output_sptr>> d_work_outputs;
+    std::vector<executor_iteration_status> d_block_status;
+
+    // Notifications are immutable, so the same message can be pushed every time
+    scheduler_message_sptr d_notify_input_msg;
+    scheduler_message_sptr d_notify_output_msg;
+    // Tags in the consumed windows of one work call, reused to avoid allocating
+    std::vector<tag_t> d_tag_window;
+
+    // A block that returned WORK_CALLBACK_INITIATED is also retried from the timer
+    // service, in case its own call back never comes.  The delay doubles with every
+    // retry and is reset when work returns anything else
+    static constexpr std::chrono::microseconds s_min_callback_retry{ 100 };
+    static constexpr std::chrono::microseconds s_max_callback_retry{ 100000 };
+    std::vector<std::chrono::microseconds> d_callback_retry;
+    std::vector<timer_service::clock::time_point> d_callback_retry_at;
+
     // Move to buffer management
     const int s_fixed_buf_size;
     static const int s_min_items_to_process = 1;
+    static const unsigned int s_default_max_passes = 64;
     const size_t s_min_buf_items = 1;
 
     buffer_manager::sptr _bufman;
 
+    // Upper bound on the passes over the blocks made by one call to run_one_iteration
+    unsigned int d_max_passes = s_default_max_passes;
+    // Upper bound on the items of one work call, 0 for as many as the buffers allow
+    size_t d_max_items_per_call = 0;
+
+    void run_one_pass();
+
 public:
     graph_executor(const std::string& name) : executor(name), s_fixed_buf_size(32768){};
     ~graph_executor(){};
 
-    void initialize(buffer_manager::sptr bufman, std::vector<block_sptr> blocks)
-    {
-        _bufman = bufman;
-        d_blocks = blocks;
-    }
+    void initialize(buffer_manager::sptr bufman, std::vector<block_sptr> blocks);
+
+    /**
+     * @brief Call work on the blocks in topological order until they stop making progress
+     *
+     * Passes over the blocks are repeated while any block made progress, so that data
+     * travels from the sources to the sinks of the group within one call.  Stops early
+     * when a block reports DONE or after max_passes passes.  With a cap on the items per
+     * call, each pass goes in reverse topological order instead.
+     *
+     * @return const std::vector<executor_iteration_status>& Status of each block from
+     * the last pass, indexed in the same order as blocks()
+     */
+    const std::vector<executor_iteration_status>& run_one_iteration();
+
+    /**
+     * @brief Blocks of this executor, in the topological order they are executed in
+     *
+     */
+    const std::vector<block_sptr>& blocks() { return d_blocks; }
+
+    void set_max_passes(unsigned int max_passes) { d_max_passes = std::max(1u, max_passes); }
+    unsigned int max_passes() { return d_max_passes; }
+
+    /**
+     * @brief Cap the number of items each work call may produce
+     *
+     * Small calls let items reach the sinks as soon as they are produced, rather than
+     * once a large part of a buffer has filled, at the cost of more calls per item.
+     * Inputs are capped to match through the relative rate of the block, and the cap
+     * never goes below the output multiple of a block.  Each pass then runs the blocks
+     * nearest the sinks first.
+     *
+     * @param max_items items per call, 0 to not cap
+     */
+    void set_max_items_per_call(size_t max_items) { d_max_items_per_call = max_items; }
+    size_t max_items_per_call() { return d_max_items_per_call; }
 
-    std::map<nodeid_t, executor_iteration_status>
-    run_one_iteration(std::vector<block_sptr> blocks = std::vector<block_sptr>());
+    /**
+     * @brief Order blocks so that each one comes after the blocks connected to its inputs
+     *
+     * Blocks that are not ordered by a connection keep their relative order
+     */
+    static std::vector<block_sptr> topological_order(const std::vector<block_sptr>& blocks);
 };
 
 } // namespace schedulers
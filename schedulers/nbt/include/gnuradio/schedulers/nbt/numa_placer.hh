@@ -0,0 +1,50 @@
+#pragma once
+
+#include <gnuradio/block_group_properties.hh>
+#include <gnuradio/edge.hh>
+
+#include <vector>
+
+namespace gr {
+namespace schedulers {
+
+/**
+ * @brief Spreads block groups over the NUMA nodes of the machine
+ *
+ * Groups connected by a stream edge are kept on the same node as long as the node has
+ * a CPU left for each of them, so that the buffers between them, which live on the
+ * node of their writer, are read from the same socket.  Groups that already have a
+ * processor affinity stay where they are and count against their node.
+ *
+ */
+class numa_placer
+{
+public:
+    /**
+     * @brief Choose a node for each group
+     *
+     * Walks the groups connected to each other breadth first, putting each one on the
+     * node most of its placed neighbors are on, or on the node with the most free CPUs
+     * when that one is full
+     *
+     * @param groups block groups, in the order threads are created
+     * @param edges stream edges of the graph
+     * @param node_cpus CPUs of each node
+     * @return std::vector<int> node of each group, -1 for an affinity spanning nodes
+     */
+    static std::vector<int>
+    assign_nodes(std::vector<block_group_properties>& groups,
+                 const edge_vector_t& edges,
+                 const std::vector<std::vector<unsigned int>>& node_cpus);
+
+    /**
+     * @brief Bind the groups without an affinity to the CPUs of their node
+     *
+     * Does nothing on machines with a single node
+     */
+    static void place(std::vector<block_group_properties>& groups,
+                      const edge_vector_t& edges);
+};
+
+} // namespace schedulers
+} // namespace gr
@@ -4,7 +4,10 @@
 #include <gnuradio/scheduler.hh>
 #include <gnuradio/buffer_cpu_vmcirc.hh>
 
+#include "auto_partitioner.hh"
+#include "numa_placer.hh"
 #include "thread_wrapper.hh"
+#include "wait_strategy.hh"
 namespace gr {
 namespace schedulers {
 class scheduler_nbt : public scheduler
@@ -14,6 +17,21 @@ private:
     const int s_fixed_buf_size;
     std::map<nodeid_t, neighbor_interface_sptr> _block_thread_map;
     std::vector<block_group_properties> _block_groups;
+    bool d_auto_partition = false;
+    auto_partition_properties d_auto_partition_props;
+    bool d_blocks_started = false;
+    buffer_size_policy_t d_buffer_policy = buffer_size_policy_t::FIXED;
+    bool d_adaptive_buffers = false;
+    buffer_manager::sptr d_bufman;
+    size_t d_max_items_per_call = 0;
+    bool d_numa_placement = false;
+    bool d_perf_counters = false;
+    wait_strategy_properties d_wait_strategy;
+    std::map<std::string, wait_strategy_properties> d_group_wait_strategies;
+
+    void create_thread(block_group_properties& bg,
+                       buffer_manager::sptr bufman,
+                       flowgraph_monitor_sptr fgmon);
 
 public:
     typedef std::shared_ptr<scheduler_nbt> sptr;
@@ -32,10 +50,93 @@ public:
     ~scheduler_nbt(){};
 
     void push_message(scheduler_message_sptr msg);
+    const std::vector<thread_wrapper::sptr>& threads() const { return _threads; }
     void add_block_group(const std::vector<block_sptr>& blocks,
                          const std::string& name = "",
                          const std::vector<unsigned int>& affinity_mask = {});
 
+    /**
+     * @brief Assign the blocks that are not in a block group to threads automatically
+     *
+     * During initialize, the graph is run on the calling thread for a short warm-up (or
+     * the costs are read from a saved profile), then cheap adjacent blocks are fused
+     * into shared threads and heavy blocks get dedicated, optionally pinned, threads
+     *
+     * @param props number of threads, warm-up length, profile file and pinning
+     */
+    void set_auto_partition(
+        const auto_partition_properties& props = auto_partition_properties())
+    {
+        d_auto_partition = true;
+        d_auto_partition_props = props;
+    }
+
+    /**
+     * @brief Select how the buffers between blocks of this scheduler are sized
+     *
+     * With CACHE_AWARE, buffers between blocks of the same block group are sized to fit
+     * in the L2 cache together and the others to fit in the last level cache.  With
+     * adaptive set, buffers are allocated with headroom and their fill limit is tuned
+     * while the flowgraph runs
+     */
+    void set_buffer_size_policy(buffer_size_policy_t policy, bool adaptive = false)
+    {
+        d_buffer_policy = policy;
+        d_adaptive_buffers = adaptive;
+    }
+
+    /**
+     * @brief Trade throughput for bounded latency
+     *
+     * Caps every work call to max_items and holds each buffer to about two calls worth
+     * of unread items, so that items are handed downstream in small chunks as soon as
+     * they are produced instead of queueing up in large buffers.  Within a thread the
+     * blocks downstream run before the ones feeding them, draining what is in flight
+     * first.  Per edge limits can
+     * still be given with the max_buffer_fill and max_buffer_read buffer properties.
+     * Replaces the adaptive buffer tuning when set.
+     *
+     * @param max_items items per work call, 0 to go back to maximizing throughput
+     */
+    void set_latency_mode(size_t max_items) { d_max_items_per_call = max_items; }
+
+    /**
+     * @brief Turn on the performance counters of every block run by this scheduler
+     *
+     * Counters are off by default, blocks can also be turned on one by one
+     */
+    void set_perf_counters_enabled(bool enable = true) { d_perf_counters = enable; }
+
+    /**
+     * @brief Keep connected block groups on the same NUMA node
+     *
+     * Binds each thread without a processor affinity of its own to the CPUs of one
+     * node, filling a node with groups that exchange buffers before moving on to the
+     * next.  Buffers are always placed on the node of the thread writing them, this
+     * makes their readers run there too.
+     */
+    void set_numa_placement(bool enable = true) { d_numa_placement = enable; }
+
+    /**
+     * @brief Select how threads wait for work when they have nothing to do
+     *
+     * Spinning saves the sleep and wake-up of a blocking wait on every hand-off between
+     * threads, at the cost of keeping cores busy.  Applies to the block group of the
+     * given name, or with no name, to every thread without a strategy of its own
+     *
+     * @param props strategy and number of polls before yielding or sleeping
+     * @param group_name name of the block group, as given to add_block_group
+     */
+    void set_wait_strategy(const wait_strategy_properties& props,
+                           const std::string& group_name = "")
+    {
+        if (group_name.empty()) {
+            d_wait_strategy = props;
+        } else {
+            d_group_wait_strategies[group_name] = props;
+        }
+    }
+
     /**
      * @brief Initialize the multi-threaded scheduler
      *
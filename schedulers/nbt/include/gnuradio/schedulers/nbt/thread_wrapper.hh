@@ -9,6 +9,7 @@
 #include <thread>
 
 #include "graph_executor.hh"
+#include "wait_strategy.hh"
 
 namespace gr {
 namespace schedulers {
@@ -28,14 +29,17 @@ private:
      *
      */
     concurrent_queue<scheduler_message_sptr> msgq;
+    message_waiter d_waiter;
     std::thread d_thread;
     bool d_thread_stopped = false;
+    std::atomic<bool> d_blocks_started = false;
     std::unique_ptr<graph_executor> _exec;
 
     int _id;
     block_group_properties d_block_group;
     std::vector<block_sptr> d_blocks;
     std::map<nodeid_t, block_sptr> d_block_id_to_block_map;
+    std::vector<bool> d_source_blocks; // indexed in the same order as d_blocks
 
     logger_sptr _logger;
     logger_sptr _debug_logger;
@@ -46,35 +50,56 @@ private:
     int d_flush_cnt = 0;
     std::atomic<bool> kick_pending = false;
 
+    /**
+     * @brief Set while a work notification is sitting in msgq
+     *
+     * Neighbors only enqueue a wake-up when this transitions from clear to set, so a
+     * fast producer results in at most one outstanding notification for this thread
+     */
+    std::atomic<bool> d_work_pending = false;
+
 public:
     typedef std::shared_ptr<thread_wrapper> sptr;
 
     static sptr make(int id,
                      block_group_properties bgp,
                      buffer_manager::sptr bufman,
-                     flowgraph_monitor_sptr fgmon)
+                     flowgraph_monitor_sptr fgmon,
+                     const wait_strategy_properties& wait = wait_strategy_properties())
     {
-        return std::make_shared<thread_wrapper>(id, bgp, bufman, fgmon);
+        return std::make_shared<thread_wrapper>(id, bgp, bufman, fgmon, wait);
     }
 
     thread_wrapper(int id,
                    block_group_properties bgp,
                    buffer_manager::sptr bufman,
-                   flowgraph_monitor_sptr fgmon);
+                   flowgraph_monitor_sptr fgmon,
+                   const wait_strategy_properties& wait = wait_strategy_properties());
     int id() { return _id; }
     const std::string& name() { return d_block_group.name(); }
 
-    void push_message(scheduler_message_sptr msg) { msgq.push(msg); }
-    bool pop_message(scheduler_message_sptr& msg) { return msgq.pop(msg); }
+    void push_message(scheduler_message_sptr msg);
+    bool pop_message(scheduler_message_sptr& msg) { return d_waiter.wait(msgq, msg); }
+    const wait_strategy_properties& wait_strategy() const { return d_waiter.properties(); }
     bool pop_message_nonblocking(scheduler_message_sptr& msg)
     {
         return msgq.try_pop(msg);
     }
+    /**
+     * @brief Number of messages waiting in the queue of this thread
+     *
+     * Work notifications are coalesced, so at most one of them is ever counted
+     */
+    size_t queued_messages() const { return msgq.size_approx(); }
 
     void start();
     void stop();
     void stop_blocks()
     {
+        // Reached both from EXIT and from stop(), the blocks only see one stop
+        if (!d_blocks_started.exchange(false)) {
+            return;
+        }
         for (auto& b : d_blocks) {
             b->stop();
         }
@@ -87,6 +112,25 @@ public:
     void handle_parameter_change(std::shared_ptr<param_change_action> item);
     static void thread_body(thread_wrapper* top);
 
+    /**
+     * @brief Move the output buffers of the blocks to the NUMA node of this thread
+     *
+     * The node of the processor affinity when it lies within one node, otherwise the
+     * node the thread is running on.  Called from the thread itself before any work.
+     */
+    void place_output_buffers();
+
+    /**
+     * @brief The blocks were already started (by the partitioning warm-up), start()
+     * only kicks off the work
+     */
+    void set_blocks_started() { d_blocks_started = true; }
+
+    void set_max_items_per_call(size_t max_items)
+    {
+        _exec->set_max_items_per_call(max_items);
+    }
+
     void start_flushing()
     {
         d_flushing = true;
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <gnuradio/concurrent_queue.hh>
+#include <gnuradio/scheduler_message.hh>
+
+#include <string>
+
+namespace gr {
+namespace schedulers {
+
+/**
+ * @brief How a scheduler thread waits for its next message
+ *
+ * BLOCKING sleeps in the queue right away (after the short fixed spin of the queue's
+ * semaphore).  BUSY_SPIN polls the queue and never gives up the core.  SPIN_YIELD polls
+ * for spin_count tries, then keeps polling but yields the core between tries.
+ * SPIN_BLOCK polls for up to spin_count tries and then sleeps, adapting how long it
+ * polls to how long messages have recently taken to arrive
+ */
+enum class wait_strategy_t { BLOCKING, BUSY_SPIN, SPIN_YIELD, SPIN_BLOCK };
+
+struct wait_strategy_properties {
+    wait_strategy_t strategy = wait_strategy_t::BLOCKING;
+    unsigned int spin_count = 4096; // polls before yielding or sleeping
+};
+
+/**
+ * @brief Parse a wait strategy from its name in the scheduler options
+ *
+ * One of blocking, busy_spin, spin_yield or spin_block
+ */
+wait_strategy_t wait_strategy_from_string(const std::string& name);
+
+/**
+ * @brief Pops messages off a scheduler thread queue using a wait strategy
+ *
+ */
+class message_waiter
+{
+public:
+    message_waiter(const wait_strategy_properties& props = wait_strategy_properties());
+
+    /**
+     * @brief Wait until a message is available and pop it
+     */
+    bool wait(concurrent_queue<scheduler_message_sptr>& q, scheduler_message_sptr& msg);
+
+    const wait_strategy_properties& properties() const { return d_props; }
+    /**
+     * @brief Number of polls the next SPIN_BLOCK wait makes before sleeping
+     */
+    unsigned int spin_limit() const { return d_spin_limit; }
+
+private:
+    wait_strategy_properties d_props;
+    unsigned int d_spin_limit;
+
+    static constexpr unsigned int s_min_spins = 16;
+};
+
+} // namespace schedulers
+} // namespace gr
@@ -0,0 +1,265 @@
+#include "auto_partitioner.hh"
+#include "graph_executor.hh"
+
+#include <yaml-cpp/yaml.h>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <numeric>
+#include <thread>
+
+namespace gr {
+namespace schedulers {
+
+/**
+ * @brief Stands in for the scheduler threads while the warm-up runs
+ *
+ * Readiness notifications are dropped since the warm-up polls every block, everything
+ * else is held to be delivered once the threads exist
+ */
+struct warmup_interface : public neighbor_interface {
+    std::vector<scheduler_message_sptr>& msgs;
+    warmup_interface(std::vector<scheduler_message_sptr>& msgs_) : msgs(msgs_) {}
+    void push_message(scheduler_message_sptr msg) override
+    {
+        if (msg->type() != scheduler_message_t::SCHEDULER_ACTION) {
+            msgs.push_back(msg);
+        }
+    }
+};
+
+auto_partitioner::auto_partitioner(const auto_partition_properties& props)
+    : d_props(props)
+{
+    _logger = logging::get_logger("auto_partitioner", "default");
+    _debug_logger = logging::get_logger("auto_partitioner_dbg", "debug");
+}
+
+block_vector_t auto_partitioner::order_blocks(flat_graph_sptr fg, block_vector_t blocks)
+{
+    block_vector_t result;
+    for (auto& subgraph : fg->partition()) {
+        for (auto& b : subgraph) {
+            if (std::find(blocks.begin(), blocks.end(), b) != blocks.end()) {
+                result.push_back(b);
+            }
+        }
+    }
+    return result;
+}
+
+std::vector<double>
+auto_partitioner::measure(buffer_manager::sptr bufman,
+                          const block_vector_t& blocks,
+                          std::vector<std::vector<scheduler_message_sptr>>& pending_msgs)
+{
+    std::vector<double> cost(blocks.size(), 0.0);
+    pending_msgs.assign(blocks.size(), {});
+    d_items.assign(blocks.size(), 0);
+
+    std::vector<std::unique_ptr<graph_executor>> execs;
+    for (size_t i = 0; i < blocks.size(); i++) {
+        auto intf = std::make_shared<warmup_interface>(pending_msgs[i]);
+        blocks[i]->set_parent_intf(intf);
+        for (auto& p : blocks[i]->all_ports()) {
+            p->set_parent_intf(intf);
+        }
+
+        execs.push_back(std::make_unique<graph_executor>(blocks[i]->alias() + "_warmup"));
+        execs.back()->initialize(bufman, { blocks[i] });
+        // One pass per call so every block advances at the same pace
+        execs.back()->set_max_passes(1);
+    }
+
+    // The blocks stay started for the run that follows, so that blocks doing real work
+    // in start() and stop() (streams, files, pacing) see a single start and stop
+    for (auto& b : blocks) {
+        b->start();
+    }
+
+    // Items each block handled, its outputs or for a sink its inputs
+    auto items_handled = [](const block_sptr& b) -> uint64_t {
+        if (!b->output_stream_ports().empty()) {
+            auto buf = b->output_stream_ports()[0]->buffer();
+            return buf ? buf->total_written() : 0;
+        }
+        if (!b->input_stream_ports().empty()) {
+            auto rdr = b->input_stream_ports()[0]->buffer_reader();
+            return rdr ? rdr->total_read() : 0;
+        }
+        return 0;
+    };
+    std::vector<uint64_t> items_before(blocks.size());
+    for (size_t i = 0; i < blocks.size(); i++) {
+        items_before[i] = items_handled(blocks[i]);
+    }
+
+    auto t_end = std::chrono::steady_clock::now() +
+                 std::chrono::duration<double>(d_props.warmup_seconds);
+    size_t iterations = 0;
+    bool done = false;
+    while (!done && std::chrono::steady_clock::now() < t_end) {
+        bool progress = false;
+        for (size_t i = 0; i < blocks.size(); i++) {
+            auto t1 = std::chrono::steady_clock::now();
+            auto status = execs[i]->run_one_iteration()[0];
+            auto t2 = std::chrono::steady_clock::now();
+            cost[i] += std::chrono::duration<double>(t2 - t1).count();
+
+            if (status == executor_iteration_status::READY) {
+                progress = true;
+            } else if (status == executor_iteration_status::DONE) {
+                // The block reports DONE again once the threads run it
+                done = true;
+            }
+        }
+        iterations++;
+        if (!progress) {
+            break;
+        }
+    }
+
+    for (size_t i = 0; i < blocks.size(); i++) {
+        d_items[i] = items_handled(blocks[i]) - items_before[i];
+        GR_LOG_DEBUG(_debug_logger,
+                     "warm-up cost of {}: {} s, {} items ({} items/s) over {} iterations",
+                     blocks[i]->alias(),
+                     cost[i],
+                     d_items[i],
+                     cost[i] > 0.0 ? d_items[i] / cost[i] : 0.0,
+                     iterations);
+    }
+
+    return cost;
+}
+
+std::vector<double> auto_partitioner::load_profile(const block_vector_t& blocks)
+{
+    std::vector<double> cost;
+    if (d_props.profile_file.empty()) {
+        return cost;
+    }
+
+    YAML::Node profile;
+    try {
+        profile = YAML::LoadFile(d_props.profile_file);
+    } catch (const YAML::Exception&) {
+        return cost;
+    }
+
+    auto entries = profile["blocks"];
+    if (!entries || !entries.IsSequence() || entries.size() != blocks.size()) {
+        GR_LOG_INFO(_logger,
+                    "profile {} does not match the flowgraph, profiling again",
+                    d_props.profile_file);
+        return cost;
+    }
+
+    for (size_t i = 0; i < blocks.size(); i++) {
+        // Aliases carry the node id, which is not stable from one run to the next
+        if (entries[i]["name"].as<std::string>("") != blocks[i]->name()) {
+            GR_LOG_INFO(_logger,
+                        "profile {} does not match the flowgraph, profiling again",
+                        d_props.profile_file);
+            return {};
+        }
+        cost.push_back(entries[i]["cost"].as<double>(0.0));
+    }
+
+    return cost;
+}
+
+void auto_partitioner::save_profile(const block_vector_t& blocks,
+                                    const std::vector<double>& cost)
+{
+    if (d_props.profile_file.empty()) {
+        return;
+    }
+
+    YAML::Node profile;
+    for (size_t i = 0; i < blocks.size(); i++) {
+        YAML::Node entry;
+        entry["name"] = blocks[i]->name();
+        entry["alias"] = blocks[i]->alias();
+        entry["cost"] = cost[i];
+        if (d_items.size() == blocks.size()) {
+            entry["items"] = d_items[i];
+            entry["items_per_sec"] = cost[i] > 0.0 ? d_items[i] / cost[i] : 0.0;
+        }
+        profile["blocks"].push_back(entry);
+    }
+
+    std::ofstream f(d_props.profile_file);
+    if (!f) {
+        GR_LOG_WARN(_logger, "unable to write profile {}", d_props.profile_file);
+        return;
+    }
+    f << profile;
+}
+
+std::vector<block_group_properties>
+auto_partitioner::partition(const block_vector_t& blocks,
+                            const std::vector<double>& cost,
+                            unsigned int nthreads,
+                            bool pin_heavy_blocks,
+                            const std::vector<unsigned int>& reserved_cpus)
+{
+    std::vector<block_group_properties> groups;
+    if (blocks.empty()) {
+        return groups;
+    }
+
+    double total = std::accumulate(cost.begin(), cost.end(), 0.0);
+    if (total <= 0.0 || nthreads == 0) {
+        // Nothing was measured, fall back to thread per block
+        for (auto& b : blocks) {
+            groups.push_back(block_group_properties({ b }));
+        }
+        return groups;
+    }
+
+    // Each thread should carry an equal share of the total cost
+    double target = total / nthreads;
+    unsigned int ncpus = std::max(1u, std::thread::hardware_concurrency());
+    unsigned int next_cpu = 0;
+
+    block_vector_t current;
+    double current_cost = 0.0;
+    auto close_group = [&]() {
+        if (!current.empty()) {
+            groups.push_back(block_group_properties(current));
+            current.clear();
+            current_cost = 0.0;
+        }
+    };
+
+    for (size_t i = 0; i < blocks.size(); i++) {
+        if (cost[i] >= target) {
+            close_group();
+            std::vector<unsigned int> affinity;
+            // Skip the cores already given to block groups by hand
+            while (next_cpu < ncpus &&
+                   std::find(reserved_cpus.begin(), reserved_cpus.end(), next_cpu) !=
+                       reserved_cpus.end()) {
+                next_cpu++;
+            }
+            if (pin_heavy_blocks && next_cpu < ncpus) {
+                affinity.push_back(next_cpu++);
+            }
+            groups.push_back(block_group_properties({ blocks[i] }, "", affinity));
+            continue;
+        }
+
+        if (!current.empty() && current_cost + cost[i] > target) {
+            close_group();
+        }
+        current.push_back(blocks[i]);
+        current_cost += cost[i];
+    }
+    close_group();
+
+    return groups;
+}
+
+} // namespace schedulers
+} // namespace gr
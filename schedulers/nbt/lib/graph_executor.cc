@@ -1,5 +1,7 @@
 #include "graph_executor.hh"
 
+#include <cmath>
+
 namespace gr {
 namespace schedulers {
 
@@ -8,29 +10,156 @@ inline static unsigned int round_down(unsigned int n, unsigned int multiple)
     return (n / multiple) * multiple;
 }
 
-std::map<nodeid_t, executor_iteration_status>
-graph_executor::run_one_iteration(std::vector<block_sptr> blocks)
+std::vector<block_sptr> graph_executor::topological_order(const std::vector<block_sptr>& blocks)
 {
-    std::map<nodeid_t, executor_iteration_status> per_block_status;
+    // Edges between the given blocks, found from the connections of their stream ports
+    size_t n = blocks.size();
+    std::vector<std::vector<size_t>> downstream(n);
+    std::vector<size_t> num_upstream(n, 0);
+    for (size_t i = 0; i < n; i++) {
+        auto output_ports = blocks[i]->output_stream_ports();
+        for (size_t j = 0; j < n; j++) {
+            if (i == j) {
+                continue;
+            }
+            auto input_ports = blocks[j]->input_stream_ports();
+            bool connected = false;
+            for (auto& op : output_ports) {
+                for (auto& cp : op->connected_ports()) {
+                    if (std::find(input_ports.begin(), input_ports.end(), cp) !=
+                        input_ports.end()) {
+                        connected = true;
+                    }
+                }
+            }
+            if (connected) {
+                downstream[i].push_back(j);
+                num_upstream[j]++;
+            }
+        }
+    }
 
-    // If no blocks are specified for the iteration, then run over all the blocks
-    // in the default ordering
-    if (blocks.empty()) {
-        blocks = d_blocks;
+    // Kahn's algorithm, taking ready blocks in their original order
+    std::vector<block_sptr> result;
+    std::vector<bool> placed(n, false);
+    while (result.size() < n) {
+        bool found = false;
+        for (size_t i = 0; i < n; i++) {
+            if (!placed[i] && num_upstream[i] == 0) {
+                placed[i] = true;
+                found = true;
+                result.push_back(blocks[i]);
+                for (auto j : downstream[i]) {
+                    num_upstream[j]--;
+                }
+                break;
+            }
+        }
+        if (!found) {
+            // Loop in the graph, keep the remaining blocks in the order given
+            for (size_t i = 0; i < n; i++) {
+                if (!placed[i]) {
+                    result.push_back(blocks[i]);
+                }
+            }
+            break;
+        }
     }
 
-    for (auto const& b : blocks) { // TODO - order the blocks
+    return result;
+}
 
-        std::vector<block_work_input_sptr> work_input;   //(num_input_ports);
-        std::vector<block_work_output_sptr> work_output; //(num_output_ports);
+void graph_executor::initialize(buffer_manager::sptr bufman, std::vector<block_sptr> blocks)
+{
+    _bufman = bufman;
+    d_blocks = topological_order(blocks);
+
+    d_input_ports.clear();
+    d_output_ports.clear();
+    d_work_inputs.clear();
+    d_work_outputs.clear();
+    for (auto const& b : d_blocks) {
+        d_input_ports.push_back(b->input_stream_ports());
+        d_output_ports.push_back(b->output_stream_ports());
+
+        std::vector<block_work_input_sptr> work_input;
+        for (auto p : d_input_ports.back()) {
+            // Set before any writer runs so the history is never overwritten, with room
+            // for it to grow up to the max history while running
+            b->freeze_max_history();
+            p->buffer_reader()->reserve_history(b->max_history());
+            p->buffer_reader()->set_history(b->history());
+            work_input.push_back(std::make_shared<block_work_input>(0, p->buffer_reader()));
+        }
+        std::vector<block_work_output_sptr> work_output;
+        for (auto p : d_output_ports.back()) {
+            work_output.push_back(std::make_shared<block_work_output>(0, p->buffer()));
+        }
+        d_work_inputs.push_back(std::move(work_input));
+        d_work_outputs.push_back(std::move(work_output));
+    }
+    d_block_status.assign(d_blocks.size(), executor_iteration_status::READY);
+    d_callback_retry.assign(d_blocks.size(), s_min_callback_retry);
+    d_callback_retry_at.assign(d_blocks.size(), timer_service::clock::time_point());
+
+    d_notify_input_msg =
+        std::make_shared<scheduler_action>(scheduler_action_t::NOTIFY_INPUT);
+    d_notify_output_msg =
+        std::make_shared<scheduler_action>(scheduler_action_t::NOTIFY_OUTPUT);
+}
+
+const std::vector<executor_iteration_status>& graph_executor::run_one_iteration()
+{
+    for (unsigned int pass = 0; pass < d_max_passes; pass++) {
+        run_one_pass();
+
+        bool progress = false;
+        for (auto& s : d_block_status) {
+            if (s == executor_iteration_status::DONE) {
+                // Hand DONE back right away so it cannot be masked by a later pass
+                return d_block_status;
+            }
+            if (s == executor_iteration_status::READY) {
+                progress = true;
+            }
+        }
+        if (!progress) {
+            break;
+        }
+    }
+
+    return d_block_status;
+}
+
+void graph_executor::run_one_pass()
+{
+    size_t nblocks = d_blocks.size();
+    for (size_t k = 0; k < nblocks; k++) {
+        // In latency mode the blocks closest to the sinks go first, so what is already
+        // in flight is drained before the sources produce more
+        size_t blk_idx = d_max_items_per_call > 0 ? nblocks - 1 - k : k;
+        auto const& b = d_blocks[blk_idx];
+        auto& work_input = d_work_inputs[blk_idx];
+        auto& work_output = d_work_outputs[blk_idx];
+        auto& block_status = d_block_status[blk_idx];
+        auto& pc = b->pc();
+        bool pc_enabled = pc.enabled();
+        double input_fill = 0.0;
+        double output_fill = 0.0;
 
         // for each input port of the block
         bool ready = true;
-        for (auto p : b->input_stream_ports()) {
-            auto p_buf = p->buffer_reader();
+        for (auto& w : work_input) {
+            auto& p_buf = w->buffer;
             auto max_read = p_buf->max_buffer_read();
             auto min_read = p_buf->min_buffer_read();
 
+            // The history can change at runtime, e.g. when a filter gets new taps, within
+            // the max history reserved above
+            if (p_buf->history() != b->history()) {
+                p_buf->set_history(b->history());
+            }
+
             buffer_info_t read_info;
             ready = p_buf->read_info(read_info);
             GR_LOG_DEBUG(
@@ -43,27 +172,48 @@ graph_executor::run_one_iteration(std::vector<block_sptr> blocks)
                 (min_read > 0 && read_info.n_items < (int)min_read)) {
 
                 p_buf->input_blocked_callback(s_min_items_to_process);
+                p_buf->count_input_blocked();
+                if (pc_enabled) {
+                    pc.record_input_blocked();
+                }
 
                 ready = false;
                 break;
             }
 
+            if (pc_enabled) {
+                // In bytes, the item size of the reader may differ from the buffer's
+                input_fill =
+                    std::max(input_fill,
+                             (double)p_buf->bytes_available() / p_buf->buffer_buf_size());
+            }
+
             if (max_read > 0 && read_info.n_items > (int)max_read) {
                 read_info.n_items = max_read;
             }
 
+            if (d_max_items_per_call > 0) {
+                // As many input items as a capped call can use
+                auto max_items =
+                    std::max({ 1.0,
+                               std::ceil(d_max_items_per_call / b->relative_rate()),
+                               (double)min_read });
+                if (read_info.n_items > max_items) {
+                    read_info.n_items = (int)max_items;
+                }
+            }
 
-            auto tags = p_buf->get_tags(read_info.n_items);
-            work_input.push_back(std::make_shared<block_work_input>(read_info.n_items, p_buf));
+            w->n_items = read_info.n_items;
+            w->n_consumed = -1;
         }
 
         if (!ready) {
-            per_block_status[b->id()] = executor_iteration_status::BLKD_IN;
+            block_status = executor_iteration_status::BLKD_IN;
             continue;
         }
 
         // for each output port of the block
-        for (auto p : b->output_stream_ports()) {
+        for (auto& w : work_output) {
 
             // When a block has multiple output buffers, it adds the restriction
             // that the work call can only produce the minimum available across
@@ -71,7 +221,7 @@ graph_executor::run_one_iteration(std::vector<block_sptr> blocks)
 
             size_t max_output_buffer = std::numeric_limits<int>::max();
 
-            auto p_buf = p->buffer();
+            auto& p_buf = w->buffer;
             auto max_fill = p_buf->max_buffer_fill();
             auto min_fill = p_buf->min_buffer_fill();
 
@@ -89,9 +239,19 @@ graph_executor::run_one_iteration(std::vector<block_sptr> blocks)
                 (min_fill > 0 && tmp_buf_size < min_fill)) {
                 ready = false;
                 p_buf->output_blocked_callback(false);
+                p_buf->count_output_blocked();
+                if (pc_enabled) {
+                    pc.record_output_blocked();
+                }
                 break;
             }
 
+            if (pc_enabled) {
+                // Not from the space available, which is capped at half the buffer
+                output_fill = std::max(
+                    output_fill, (double)p_buf->bytes_in_use() / p_buf->buf_size());
+            }
+
             if (tmp_buf_size < max_output_buffer)
                 max_output_buffer = tmp_buf_size;
 
@@ -99,6 +259,12 @@ graph_executor::run_one_iteration(std::vector<block_sptr> blocks)
                 max_output_buffer = max_fill;
             }
 
+            if (d_max_items_per_call > 0) {
+                max_output_buffer =
+                    std::min(max_output_buffer,
+                             std::max(d_max_items_per_call, (size_t)b->output_multiple()));
+            }
+
             if (b->output_multiple_set()) {
                 max_output_buffer = round_down(max_output_buffer, b->output_multiple());
             }
@@ -110,14 +276,12 @@ graph_executor::run_one_iteration(std::vector<block_sptr> blocks)
             if (!ready)
                 break;
 
-
-            std::vector<tag_t> tags; // needs to be associated with edge buffers
-
-            work_output.push_back(std::make_shared<block_work_output>(max_output_buffer, p_buf));
+            w->n_items = max_output_buffer;
+            w->n_produced = -1;
         }
 
         if (!ready) {
-            per_block_status[b->id()] = executor_iteration_status::BLKD_OUT;
+            block_status = executor_iteration_status::BLKD_OUT;
             continue;
         }
 
@@ -135,17 +299,44 @@ graph_executor::run_one_iteration(std::vector<block_sptr> blocks)
                 }
 
 
+                perf_counters::clock::time_point work_start;
+                if (pc_enabled) {
+                    work_start = perf_counters::clock::now();
+                }
+
                 ret = b->do_work(work_input, work_output);
+
+                if (pc_enabled) {
+                    auto work_end = perf_counters::clock::now();
+                    uint64_t nconsumed = 0;
+                    uint64_t nproduced = 0;
+                    if (ret == work_return_code_t::WORK_OK ||
+                        ret == work_return_code_t::WORK_DONE) {
+                        for (auto& w : work_input) {
+                            nconsumed += std::max(w->n_consumed, 0);
+                        }
+                        for (auto& w : work_output) {
+                            nproduced += std::max(w->n_produced, 0);
+                        }
+                    }
+                    pc.record_work(work_start,
+                                   work_end,
+                                   work_output.empty() ? 0 : work_output[0]->n_items,
+                                   nconsumed,
+                                   nproduced,
+                                   input_fill,
+                                   output_fill);
+                }
                 GR_LOG_DEBUG(_debug_logger, "do_work returned {}", ret);
                 // ret = work_return_code_t::WORK_OK;
 
                 if (ret == work_return_code_t::WORK_DONE) {
-                    per_block_status[b->id()] = executor_iteration_status::DONE;
-                    GR_LOG_DEBUG(_debug_logger, "pbs[{}]: {}", b->id(), per_block_status[b->id()]);
+                    block_status = executor_iteration_status::DONE;
+                    GR_LOG_DEBUG(_debug_logger, "pbs[{}]: {}", b->id(), block_status);
                     break;
                 } else if (ret == work_return_code_t::WORK_OK) {
-                    per_block_status[b->id()] = executor_iteration_status::READY;
-                    GR_LOG_DEBUG(_debug_logger, "pbs[{}]: {}", b->id(), per_block_status[b->id()]);
+                    block_status = executor_iteration_status::READY;
+                    GR_LOG_DEBUG(_debug_logger, "pbs[{}]: {}", b->id(), block_status);
 
                     // If a source block, and no outputs were produced, mark as BLKD_IN
                     if (!work_input.size() && work_output.size()) {
@@ -154,9 +345,8 @@ graph_executor::run_one_iteration(std::vector<block_sptr> blocks)
                             max_output = std::max(w->n_produced, max_output);
                         }
                         if (max_output <= 0) {
-                            per_block_status[b->id()] =
-                                executor_iteration_status::BLKD_IN;
-                                GR_LOG_DEBUG(_debug_logger, "pbs[{}]: {}", b->id(), per_block_status[b->id()]);
+                            block_status = executor_iteration_status::BLKD_IN;
+                            GR_LOG_DEBUG(_debug_logger, "pbs[{}]: {}", b->id(), block_status);
                         }
                     }
 
@@ -170,16 +360,30 @@ graph_executor::run_one_iteration(std::vector<block_sptr> blocks)
                     }
                     if (work_output[0]->n_items < b->output_multiple()) // min block size
                     {
-                        per_block_status[b->id()] = executor_iteration_status::BLKD_IN;
-                        GR_LOG_DEBUG(_debug_logger, "pbs[{}]: {}", b->id(), per_block_status[b->id()]);
+                        block_status = executor_iteration_status::BLKD_IN;
+                        GR_LOG_DEBUG(_debug_logger, "pbs[{}]: {}", b->id(), block_status);
                         // call the input blocked callback
                         break;
                     }
                 } else if (ret == work_return_code_t::WORK_INSUFFICIENT_OUTPUT_ITEMS) {
-                    per_block_status[b->id()] = executor_iteration_status::BLKD_OUT;
-                    GR_LOG_DEBUG(_debug_logger, "pbs[{}]: {}", b->id(), per_block_status[b->id()]);
+                    block_status = executor_iteration_status::BLKD_OUT;
+                    GR_LOG_DEBUG(_debug_logger, "pbs[{}]: {}", b->id(), block_status);
                     // call the output blocked callback
                     break;
+                } else if (ret == work_return_code_t::WORK_CALLBACK_INITIATED) {
+                    // Nothing consumed or produced, the block calls back when it can
+                    // make progress
+                    block_status = executor_iteration_status::BLKD_IN;
+                    GR_LOG_DEBUG(_debug_logger, "pbs[{}]: {}", b->id(), block_status);
+
+                    auto now = timer_service::clock::now();
+                    if (now >= d_callback_retry_at[blk_idx]) {
+                        auto& retry = d_callback_retry[blk_idx];
+                        d_callback_retry_at[blk_idx] = now + retry;
+                        b->notify_scheduler_at(d_callback_retry_at[blk_idx]);
+                        retry = std::min(retry * 2, s_max_callback_retry);
+                    }
+                    break;
                 }
 
                 
@@ -189,36 +393,38 @@ graph_executor::run_one_iteration(std::vector<block_sptr> blocks)
             if (ret == work_return_code_t::WORK_OK ||
                 ret == work_return_code_t::WORK_DONE) {
 
+                d_callback_retry[blk_idx] = s_min_callback_retry;
+
+                auto& input_ports = d_input_ports[blk_idx];
+                auto& output_ports = d_output_ports[blk_idx];
 
-                int input_port_index = 0;
-                for (auto p : b->input_stream_ports()) {
-                    auto p_buf = p->buffer_reader();
-
-                    if (!p_buf->tags().empty()) {
-                        // Pass the tags according to TPP
-                        if (b->tag_propagation_policy() ==
-                            tag_propagation_policy_t::TPP_ALL_TO_ALL) {
-                            int output_port_index = 0;
-                            for (auto op : b->output_stream_ports()) {
-                                auto p_out_buf = op->buffer();
-                                p_out_buf->propagate_tags(
-                                    p_buf, work_input[input_port_index]->n_consumed);
-
-                                output_port_index++;
-                            }
-                        } else if (b->tag_propagation_policy() ==
-                                   tag_propagation_policy_t::TPP_ONE_TO_ONE) {
-                            int output_port_index = 0;
-                            for (auto op : b->output_stream_ports()) {
-                                if (output_port_index == input_port_index) {
-                                    auto p_out_buf = op->buffer();
-                                    p_out_buf->propagate_tags(
-                                        p_buf, work_input[input_port_index]->n_consumed);
-                                }
-                                output_port_index++;
-                            }
+                // Pass the tags in the consumed windows according to TPP, taking each
+                // downstream buffer mutex once per work call
+                auto tpp = b->tag_propagation_policy();
+                if (tpp == tag_propagation_policy_t::TPP_ALL_TO_ALL) {
+                    d_tag_window.clear();
+                    for (auto& w : work_input) {
+                        w->buffer->consumed_tags(w->n_consumed, d_tag_window);
+                    }
+                    if (!d_tag_window.empty()) {
+                        for (auto& w : work_output) {
+                            w->buffer->propagate_tags(d_tag_window, b->relative_rate());
                         }
                     }
+                } else if (tpp == tag_propagation_policy_t::TPP_ONE_TO_ONE) {
+                    for (size_t i = 0; i < work_input.size() && i < work_output.size();
+                         i++) {
+                        d_tag_window.clear();
+                        work_input[i]->buffer->consumed_tags(work_input[i]->n_consumed,
+                                                             d_tag_window);
+                        work_output[i]->buffer->propagate_tags(d_tag_window,
+                                                               b->relative_rate());
+                    }
+                }
+
+                for (size_t input_port_index = 0; input_port_index < input_ports.size();
+                     input_port_index++) {
+                    auto& p_buf = work_input[input_port_index]->buffer;
 
                     GR_LOG_DEBUG(_debug_logger,
                                  "post_read {} - {}",
@@ -226,15 +432,14 @@ graph_executor::run_one_iteration(std::vector<block_sptr> blocks)
                                  work_input[input_port_index]->n_consumed);
 
                     p_buf->post_read(work_input[input_port_index]->n_consumed);
-                    p->notify_connected_ports(std::make_shared<scheduler_action>(
-                        scheduler_action_t::NOTIFY_OUTPUT));
-
-                    input_port_index++;
+                    input_ports[input_port_index]->notify_connected_ports(
+                        d_notify_output_msg);
                 }
 
-                int output_port_index = 0;
-                for (auto p : b->output_stream_ports()) {
-                    auto p_buf = p->buffer();
+                for (size_t output_port_index = 0;
+                     output_port_index < output_ports.size();
+                     output_port_index++) {
+                    auto& p_buf = work_output[output_port_index]->buffer;
 
                     GR_LOG_DEBUG(_debug_logger,
                                  "post_write {} - {}",
@@ -242,19 +447,14 @@ graph_executor::run_one_iteration(std::vector<block_sptr> blocks)
                                  work_output[output_port_index]->n_produced);
                     p_buf->post_write(work_output[output_port_index]->n_produced);
 
-                    p->notify_connected_ports(std::make_shared<scheduler_action>(
-                        scheduler_action_t::NOTIFY_INPUT));
-
-                    output_port_index++;
+                    output_ports[output_port_index]->notify_connected_ports(
+                        d_notify_input_msg);
 
                     p_buf->prune_tags();
                 }
             }
         }
     }
-
-    
-    return per_block_status;
 }
 
 } // namespace schedulers
@@ -0,0 +1,143 @@
+#include "numa_placer.hh"
+
+#include <gnuradio/logging.hh>
+#include <gnuradio/numa.hh>
+
+#include <map>
+#include <queue>
+#include <set>
+
+namespace gr {
+namespace schedulers {
+
+std::vector<int>
+numa_placer::assign_nodes(std::vector<block_group_properties>& groups,
+                          const edge_vector_t& edges,
+                          const std::vector<std::vector<unsigned int>>& node_cpus)
+{
+    if (node_cpus.empty()) {
+        return std::vector<int>(groups.size(), -1);
+    }
+
+    std::map<unsigned int, int> cpu_node;
+    for (size_t k = 0; k < node_cpus.size(); k++) {
+        for (auto c : node_cpus[k]) {
+            cpu_node[c] = k;
+        }
+    }
+
+    // Groups that share a stream edge
+    std::map<nodeid_t, size_t> group_of_block;
+    for (size_t i = 0; i < groups.size(); i++) {
+        for (auto& b : groups[i].blocks()) {
+            group_of_block[b->id()] = i;
+        }
+    }
+    std::vector<std::set<size_t>> neighbors(groups.size());
+    for (auto& e : edges) {
+        auto src = group_of_block.find(e->src().node()->id());
+        auto dst = group_of_block.find(e->dst().node()->id());
+        if (src != group_of_block.end() && dst != group_of_block.end() &&
+            src->second != dst->second) {
+            neighbors[src->second].insert(dst->second);
+            neighbors[dst->second].insert(src->second);
+        }
+    }
+
+    std::vector<int> node(groups.size(), -1);
+    std::vector<bool> placed(groups.size(), false);
+    std::vector<int> load(node_cpus.size(), 0);
+    auto spare = [&](int k) { return (int)node_cpus[k].size() - load[k]; };
+
+    // Pinned groups stay put
+    for (size_t i = 0; i < groups.size(); i++) {
+        auto affinity = groups[i].processor_affinity();
+        if (affinity.empty()) {
+            continue;
+        }
+        placed[i] = true;
+        for (auto c : affinity) {
+            auto it = cpu_node.find(c);
+            if (it == cpu_node.end() || (node[i] >= 0 && node[i] != it->second)) {
+                node[i] = -1;
+                break;
+            }
+            node[i] = it->second;
+        }
+        if (node[i] >= 0) {
+            load[node[i]]++;
+        }
+    }
+
+    for (size_t start = 0; start < groups.size(); start++) {
+        if (placed[start]) {
+            continue;
+        }
+
+        std::queue<size_t> q;
+        q.push(start);
+        placed[start] = true;
+        while (!q.empty()) {
+            auto g = q.front();
+            q.pop();
+
+            std::vector<int> votes(node_cpus.size(), 0);
+            for (auto n : neighbors[g]) {
+                if (node[n] >= 0) {
+                    votes[node[n]]++;
+                }
+            }
+            int best = -1;
+            for (size_t k = 0; k < node_cpus.size(); k++) {
+                if (spare(k) > 0 && votes[k] > 0 && (best < 0 || votes[k] > votes[best])) {
+                    best = k;
+                }
+            }
+            if (best < 0) {
+                // Nothing placed next to it yet, or those nodes are full
+                best = 0;
+                for (size_t k = 1; k < node_cpus.size(); k++) {
+                    if (spare(k) > spare(best)) {
+                        best = k;
+                    }
+                }
+            }
+            node[g] = best;
+            load[best]++;
+
+            for (auto n : neighbors[g]) {
+                if (!placed[n]) {
+                    placed[n] = true;
+                    q.push(n);
+                }
+            }
+        }
+    }
+
+    return node;
+}
+
+void numa_placer::place(std::vector<block_group_properties>& groups,
+                        const edge_vector_t& edges)
+{
+    if (numa::num_nodes() <= 1) {
+        return;
+    }
+
+    std::vector<std::vector<unsigned int>> node_cpus;
+    for (int k = 0; k < numa::num_nodes(); k++) {
+        node_cpus.push_back(numa::node_cpus(k));
+    }
+
+    auto logger = logging::get_logger("numa_placer", "default");
+    auto node = assign_nodes(groups, edges, node_cpus);
+    for (size_t i = 0; i < groups.size(); i++) {
+        if (groups[i].processor_affinity().empty() && node[i] >= 0) {
+            groups[i].set_processor_affinity(node_cpus[node[i]]);
+            GR_LOG_INFO(logger, "{} placed on NUMA node {}", groups[i].name(), node[i]);
+        }
+    }
+}
+
+} // namespace schedulers
+} // namespace gr
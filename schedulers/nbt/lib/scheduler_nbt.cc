@@ -25,60 +25,142 @@ void scheduler_nbt::add_block_group(const std::vector<block_sptr>& blocks,
         std::move(block_group_properties(blocks, name, affinity_mask)));
 }
 
-void scheduler_nbt::initialize(flat_graph_sptr fg, flowgraph_monitor_sptr fgmon)
+void scheduler_nbt::create_thread(block_group_properties& bg,
+                                  buffer_manager::sptr bufman,
+                                  flowgraph_monitor_sptr fgmon)
 {
+    auto wait = d_wait_strategy;
+    auto it = d_group_wait_strategies.find(bg.name());
+    if (it != d_group_wait_strategies.end()) {
+        wait = it->second;
+    }
 
+    auto t = thread_wrapper::make(id(), bg, bufman, fgmon, wait);
+    t->set_max_items_per_call(d_max_items_per_call);
+    if (d_blocks_started) {
+        // Already started for the warm-up
+        t->set_blocks_started();
+    }
+    _threads.push_back(t);
 
+    for (auto& b : bg.blocks()) {
+        b->set_parent_intf(t);
+        for (auto& p : b->all_ports()) {
+            p->set_parent_intf(t); // give a shared pointer to the scheduler class
+        }
+        _block_thread_map[b->id()] = t;
+    }
+}
+
+void scheduler_nbt::initialize(flat_graph_sptr fg, flowgraph_monitor_sptr fgmon)
+{
     auto bufman = std::make_shared<buffer_manager>(s_fixed_buf_size);
+    bufman->set_size_policy(d_buffer_policy, d_adaptive_buffers);
+    bufman->set_max_items_per_call(d_max_items_per_call);
+    std::vector<std::vector<block_sptr>> thread_groups;
+    for (auto& bg : _block_groups) {
+        thread_groups.push_back(bg.blocks());
+    }
+    bufman->set_thread_groups(thread_groups);
     bufman->initialize_buffers(fg, _default_buf_properties);
+    d_bufman = bufman;
 
 
     //  Partition the flowgraph according to how blocks are specified in groups
     //  By default, one Thread Per Block
 
     auto blocks = fg->calc_used_blocks();
+    if (d_perf_counters) {
+        for (auto& b : blocks) {
+            b->set_perf_counters_enabled(true);
+        }
+    }
+
+    // When partitioning automatically, profile the whole graph before any thread exists
+    // so that only the warm-up run touches the buffers
+    block_vector_t profiled_blocks;
+    std::vector<double> profiled_cost;
+    std::vector<std::vector<scheduler_message_sptr>> pending_msgs;
+    if (d_auto_partition) {
+        auto_partitioner ap(d_auto_partition_props);
+        profiled_blocks = auto_partitioner::order_blocks(fg, blocks);
+        profiled_cost = ap.load_profile(profiled_blocks);
+        if (profiled_cost.empty()) {
+            profiled_cost = ap.measure(bufman, profiled_blocks, pending_msgs);
+            ap.save_profile(profiled_blocks, profiled_cost);
+            d_blocks_started = true;
+        }
+    }
 
     // look at our block groups, create confs and remove from blocks
+    std::vector<block_group_properties> groups;
     for (auto& bg : _block_groups) {
-        std::vector<block_sptr> blocks_for_this_thread;
-
         if (bg.blocks().size()) {
-            auto t = thread_wrapper::make(id(), bg, bufman, fgmon);
-            _threads.push_back(t);
-
-            std::vector<node_sptr> node_vec;
             for (auto& b : bg.blocks()) {
                 auto it = std::find(blocks.begin(), blocks.end(), b);
                 if (it != blocks.end()) {
                     blocks.erase(it);
                 }
+            }
+            groups.push_back(bg);
+        }
+    }
 
-                node_vec.push_back(b);
-
-                b->set_parent_intf(t);
-                for (auto& p : b->all_ports()) {
-                    p->set_parent_intf(t); // give a shared pointer to the scheduler class
-                }
-                _block_thread_map[b->id()] = t;
+    if (d_auto_partition) {
+        // Only place the blocks that were not grouped by hand
+        block_vector_t auto_blocks;
+        std::vector<double> auto_cost;
+        for (size_t i = 0; i < profiled_blocks.size(); i++) {
+            if (std::find(blocks.begin(), blocks.end(), profiled_blocks[i]) !=
+                blocks.end()) {
+                auto_blocks.push_back(profiled_blocks[i]);
+                auto_cost.push_back(profiled_cost[i]);
             }
         }
+
+        unsigned int nthreads = d_auto_partition_props.max_threads;
+        if (nthreads == 0) {
+            nthreads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        // Threads of the manual groups already take up part of the machine
+        nthreads = std::max(1, (int)nthreads - (int)groups.size());
+
+        std::vector<unsigned int> reserved_cpus;
+        for (auto& bg : groups) {
+            auto affinity = bg.processor_affinity();
+            reserved_cpus.insert(reserved_cpus.end(), affinity.begin(), affinity.end());
+        }
+
+        auto auto_groups =
+            auto_partitioner::partition(auto_blocks,
+                                        auto_cost,
+                                        nthreads,
+                                        d_auto_partition_props.pin_heavy_blocks,
+                                        reserved_cpus);
+        groups.insert(groups.end(), auto_groups.begin(), auto_groups.end());
+        blocks.clear();
     }
 
     // For the remaining blocks that weren't in block groups
     for (auto& b : blocks) {
+        groups.push_back(block_group_properties({ b }));
+    }
 
-        std::vector<node_sptr> node_vec;
-        node_vec.push_back(b);
+    // The affinity has to be known when the threads are created, since each thread
+    // places its output buffers as it starts
+    if (d_numa_placement) {
+        numa_placer::place(groups, fg->stream_edges());
+    }
 
-        auto t = thread_wrapper::make(id(), block_group_properties({ b }), bufman, fgmon);
-        _threads.push_back(t);
+    for (auto& bg : groups) {
+        create_thread(bg, bufman, fgmon);
+    }
 
-        b->set_parent_intf(t);
-        for (auto& p : b->all_ports()) {
-            p->set_parent_intf(t); // give a shared pointer to the scheduler class
+    // Deliver the messages that blocks sent each other during the warm-up
+    for (size_t i = 0; i < pending_msgs.size(); i++) {
+        for (auto& msg : pending_msgs[i]) {
+            _block_thread_map[profiled_blocks[i]->id()]->push_message(msg);
         }
-
-        _block_thread_map[b->id()] = t;
     }
 }
 
@@ -87,9 +169,15 @@ void scheduler_nbt::start()
     for (const auto& thd : _threads) {
         thd->start();
     }
+    if (d_bufman) {
+        d_bufman->start_adaptation();
+    }
 }
 void scheduler_nbt::stop()
 {
+    if (d_bufman) {
+        d_bufman->stop_adaptation();
+    }
     for (const auto& thd : _threads) {
         thd->stop();
     }
@@ -99,15 +187,14 @@ void scheduler_nbt::wait()
     for (const auto& thd : _threads) {
         thd->wait();
     }
+    if (d_bufman) {
+        d_bufman->stop_adaptation();
+    }
 }
 void scheduler_nbt::run()
 {
-    for (const auto& thd : _threads) {
-        thd->start();
-    }
-    for (const auto& thd : _threads) {
-        thd->wait();
-    }
+    start();
+    wait();
 }
 
 } // namespace schedulers
@@ -127,6 +214,47 @@ std::shared_ptr<gr::scheduler> factory(const std::string& options)
     auto buf_size = opt_yaml["buffer_size"].as<size_t>(32768);
     auto name = opt_yaml["name"].as<std::string>("nbt");
 
-    return gr::schedulers::scheduler_nbt::make(name, buf_size);
+    auto sched = gr::schedulers::scheduler_nbt::make(name, buf_size);
+
+    if (opt_yaml["auto_partition"].as<bool>(false)) {
+        gr::schedulers::auto_partition_properties props;
+        props.max_threads = opt_yaml["max_threads"].as<unsigned int>(0);
+        props.warmup_seconds = opt_yaml["warmup_seconds"].as<double>(0.1);
+        props.profile_file = opt_yaml["profile_file"].as<std::string>("");
+        props.pin_heavy_blocks = opt_yaml["pin_heavy_blocks"].as<bool>(true);
+        sched->set_auto_partition(props);
+    }
+
+    if (opt_yaml["buffer_policy"].as<std::string>("fixed") == "cache_aware") {
+        sched->set_buffer_size_policy(gr::buffer_size_policy_t::CACHE_AWARE,
+                                      opt_yaml["adaptive_buffers"].as<bool>(false));
+    } else if (opt_yaml["adaptive_buffers"].as<bool>(false)) {
+        sched->set_buffer_size_policy(gr::buffer_size_policy_t::FIXED, true);
+    }
+
+    sched->set_latency_mode(opt_yaml["latency_max_items"].as<size_t>(0));
+    sched->set_numa_placement(opt_yaml["numa_placement"].as<bool>(false));
+    sched->set_perf_counters_enabled(opt_yaml["perf_counters"].as<bool>(false));
+
+    // e.g. {wait_strategy: spin_block, spin_count: 4096,
+    //       group_wait_strategies: {rx: {wait_strategy: busy_spin}}}
+    // with the groups taking what they leave out from the top level
+    auto parse_wait = [](const YAML::Node& node,
+                         gr::schedulers::wait_strategy_properties props) {
+        if (node["wait_strategy"]) {
+            props.strategy = gr::schedulers::wait_strategy_from_string(
+                node["wait_strategy"].as<std::string>());
+        }
+        props.spin_count = node["spin_count"].as<unsigned int>(props.spin_count);
+        return props;
+    };
+    auto wait = parse_wait(opt_yaml, gr::schedulers::wait_strategy_properties());
+    sched->set_wait_strategy(wait);
+    for (auto group : opt_yaml["group_wait_strategies"]) {
+        sched->set_wait_strategy(parse_wait(group.second, wait),
+                                 group.first.as<std::string>());
+    }
+
+    return sched;
 }
 }
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "thread_wrapper.hh"
+#include <gnuradio/numa.hh>
 #include <gnuradio/thread.hh>
 #include <fmt/core.h>
 #include <thread>
@@ -9,26 +10,33 @@ namespace schedulers {
 thread_wrapper::thread_wrapper(int id,
                                block_group_properties bgp,
                                buffer_manager::sptr bufman,
-                               flowgraph_monitor_sptr fgmon)
-    : _id(id), d_block_group(bgp), d_blocks(bgp.blocks())
+                               flowgraph_monitor_sptr fgmon,
+                               const wait_strategy_properties& wait)
+    : d_waiter(wait), _id(id), d_block_group(bgp), d_blocks(bgp.blocks())
 {
     _logger = logging::get_logger(bgp.name(), "default");
     _debug_logger = logging::get_logger(bgp.name() + "_dbg", "debug");
 
-    for (auto b : d_blocks) {
-        d_block_id_to_block_map[b->id()] = b;
-    }
-
     d_fgmon = fgmon;
     _exec = std::make_unique<graph_executor>(bgp.name());
     _exec->initialize(bufman, d_blocks);
+    // Statuses from the executor follow its topological ordering of the blocks
+    d_blocks = _exec->blocks();
+
+    for (auto b : d_blocks) {
+        d_block_id_to_block_map[b->id()] = b;
+        d_source_blocks.push_back(b->input_stream_ports().empty());
+    }
     d_thread = std::thread(thread_body, this);
 }
 
 void thread_wrapper::start()
 {
-    for (auto& b : d_blocks) {
-        b->start();
+    if (!d_blocks_started) {
+        for (auto& b : d_blocks) {
+            b->start();
+        }
+        d_blocks_started = true;
     }
     push_message(std::make_shared<scheduler_action>(scheduler_action_t::NOTIFY_ALL, 0));
 }
@@ -37,9 +45,7 @@ void thread_wrapper::stop()
     d_thread_stopped = true;
     push_message(std::make_shared<scheduler_action>(scheduler_action_t::EXIT, 0));
     d_thread.join();
-    for (auto& b : d_blocks) {
-        b->stop();
-    }
+    stop_blocks();
 }
 void thread_wrapper::wait()
 {
@@ -54,18 +60,37 @@ void thread_wrapper::run()
     wait();
 }
 
+void thread_wrapper::push_message(scheduler_message_sptr msg)
+{
+    if (msg->type() == scheduler_message_t::SCHEDULER_ACTION) {
+        switch (std::static_pointer_cast<scheduler_action>(msg)->action()) {
+        case scheduler_action_t::NOTIFY_INPUT:
+        case scheduler_action_t::NOTIFY_OUTPUT:
+        case scheduler_action_t::NOTIFY_ALL:
+            // A wake-up is already queued, the work it triggers will see this update
+            if (d_work_pending.exchange(true, std::memory_order_acq_rel)) {
+                return;
+            }
+            break;
+        default:
+            break;
+        }
+    }
+    msgq.push(msg);
+}
+
 bool thread_wrapper::handle_work_notification()
 {
-    auto s = _exec->run_one_iteration(d_blocks);
+    auto& s = _exec->run_one_iteration();
 
     // Based on state of the run_one_iteration, do things
     // If any of the blocks are done, notify the flowgraph monitor
-    for (auto elem : s) {
-        if (elem.second == executor_iteration_status::DONE) {
+    for (size_t i = 0; i < s.size(); i++) {
+        if (s[i] == executor_iteration_status::DONE) {
             GR_LOG_DEBUG(
-                _debug_logger, "Signalling DONE to FGM from block {}", elem.first);
+                _debug_logger, "Signalling DONE to FGM from block {}", d_blocks[i]->id());
             d_fgmon->push_message(
-                fg_monitor_message(fg_monitor_message_t::DONE, id(), elem.first));
+                fg_monitor_message(fg_monitor_message_t::DONE, id(), d_blocks[i]->id()));
             break; // only notify the fgmon once
         }
     }
@@ -73,21 +98,26 @@ bool thread_wrapper::handle_work_notification()
     bool notify_self_ = false;
     bool kick = false;
     bool all_blkd = true;
-    for (auto elem : s) {
-        if (elem.second == executor_iteration_status::READY ||
-            elem.second == executor_iteration_status::BLKD_OUT) {
+    for (size_t i = 0; i < s.size(); i++) {
+        if (s[i] == executor_iteration_status::READY ||
+            s[i] == executor_iteration_status::BLKD_OUT) {
             notify_self_ = true;
-        } else if (elem.second == executor_iteration_status::BLKD_IN) {
+        } else if (s[i] == executor_iteration_status::BLKD_IN) {
             kick = true;
         }
 
-        if (elem.second != executor_iteration_status::BLKD_IN &&
-            elem.second != executor_iteration_status::BLKD_OUT) {
+        if (s[i] != executor_iteration_status::BLKD_IN &&
+            s[i] != executor_iteration_status::BLKD_OUT) {
             // Ignore source blocks
-            if (!d_block_id_to_block_map[elem.first]->input_stream_ports().size()) {
+            if (d_source_blocks[i]) {
                 all_blkd = false;
             }
         }
+
+        // A block waiting on a timer still has work to come
+        if (d_blocks[i]->wakeup_pending()) {
+            all_blkd = false;
+        }
     }
 
     if (d_flushing) {
@@ -159,6 +189,24 @@ void thread_wrapper::handle_parameter_change(std::shared_ptr<param_change_action
 }
 
 
+void thread_wrapper::place_output_buffers()
+{
+    // A thread free to run anywhere stays where it was started, if the kernel can help it
+    int node = numa::node_of_cpus(d_block_group.processor_affinity());
+    if (node < 0) {
+        node = numa::current_node();
+    }
+
+    for (auto& b : d_blocks) {
+        for (auto& p : b->output_stream_ports()) {
+            if (p->buffer()) {
+                p->buffer()->set_numa_node(node);
+            }
+        }
+    }
+    gr_log_debug(_debug_logger, "output buffers placed on NUMA node {}", node);
+}
+
 void thread_wrapper::thread_body(thread_wrapper* top)
 {
     GR_LOG_INFO(top->_logger, "starting thread");
@@ -182,6 +230,10 @@ void thread_wrapper::thread_body(thread_wrapper* top)
                                              top->d_block_group.processor_affinity());
     }
 
+    // Place the output buffers from the thread that writes them, so that they follow
+    // the writer rather than the thread that built the flowgraph
+    top->place_output_buffers();
+
     // // Set thread priority if it was set before fg was started
     // if (block->thread_priority() > 0) {
     //     gr::thread::set_thread_priority(d->thread, block->thread_priority());
@@ -283,6 +335,12 @@ void thread_wrapper::thread_body(thread_wrapper* top)
             }
         }
 
+        // Clear the pending flag before calling work so that any notification arriving
+        // from here on enqueues a fresh wake-up
+        if (top->d_work_pending.exchange(false, std::memory_order_acq_rel)) {
+            do_some_work = true;
+        }
+
         bool work_returned_ready = false;
         if (do_some_work) {
             work_returned_ready = top->handle_work_notification();
@@ -0,0 +1,91 @@
+#include "wait_strategy.hh"
+
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace gr {
+namespace schedulers {
+
+namespace {
+// Tell the core we are polling, so a hyperthread sibling gets the pipeline meanwhile
+inline void cpu_relax()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+}
+} // namespace
+
+wait_strategy_t wait_strategy_from_string(const std::string& name)
+{
+    if (name == "blocking") {
+        return wait_strategy_t::BLOCKING;
+    } else if (name == "busy_spin") {
+        return wait_strategy_t::BUSY_SPIN;
+    } else if (name == "spin_yield") {
+        return wait_strategy_t::SPIN_YIELD;
+    } else if (name == "spin_block") {
+        return wait_strategy_t::SPIN_BLOCK;
+    }
+    throw std::invalid_argument("unknown wait strategy: " + name);
+}
+
+message_waiter::message_waiter(const wait_strategy_properties& props)
+    : d_props(props), d_spin_limit(std::max(props.spin_count, s_min_spins))
+{
+}
+
+bool message_waiter::wait(concurrent_queue<scheduler_message_sptr>& q,
+                          scheduler_message_sptr& msg)
+{
+    switch (d_props.strategy) {
+    case wait_strategy_t::BUSY_SPIN:
+        while (!q.try_pop(msg)) {
+            cpu_relax();
+        }
+        return true;
+
+    case wait_strategy_t::SPIN_YIELD:
+        for (unsigned int i = 0; i < d_props.spin_count; i++) {
+            if (q.try_pop(msg)) {
+                return true;
+            }
+            cpu_relax();
+        }
+        while (!q.try_pop(msg)) {
+            std::this_thread::yield();
+        }
+        return true;
+
+    case wait_strategy_t::SPIN_BLOCK: {
+        unsigned int max_spins = std::max(d_props.spin_count, s_min_spins);
+        for (unsigned int i = 0; i < d_spin_limit; i++) {
+            if (q.try_pop(msg)) {
+                // Move the limit towards twice what this wait took, the same adaptation
+                // as glibc's adaptive mutexes
+                int target = (int)std::min(2 * i + s_min_spins, max_spins);
+                d_spin_limit = (int)d_spin_limit + (target - (int)d_spin_limit) / 8;
+                return true;
+            }
+            cpu_relax();
+        }
+        // Polling did not pay off this time, poll less next time
+        d_spin_limit = std::max(d_spin_limit - d_spin_limit / 8, s_min_spins);
+        return q.pop(msg);
+    }
+
+    case wait_strategy_t::BLOCKING:
+    default:
+        return q.pop(msg);
+    }
+}
+
+} // namespace schedulers
+} // namespace gr
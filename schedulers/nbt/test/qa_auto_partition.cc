@@ -0,0 +1,188 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <thread>
+
+#include <gnuradio/blocks/copy.hh>
+#include <gnuradio/blocks/vector_sink.hh>
+#include <gnuradio/blocks/vector_source.hh>
+#include <gnuradio/flowgraph.hh>
+#include <gnuradio/math/multiply_const.hh>
+#include <gnuradio/port.hh>
+#include <gnuradio/schedulers/nbt/scheduler_nbt.hh>
+#include <gnuradio/sync_block.hh>
+
+using namespace gr;
+
+TEST(SchedulerAutoPartition, FuseCheapBlocks)
+{
+    block_vector_t blocks;
+    for (int i = 0; i < 6; i++) {
+        blocks.push_back(blocks::copy::make({ sizeof(float) }));
+    }
+    std::vector<double> cost{ 1.0, 1.0, 1.0, 10.0, 1.0, 1.0 };
+
+    auto groups = schedulers::auto_partitioner::partition(blocks, cost, 4, true);
+
+    ASSERT_EQ(groups.size(), 3u);
+    EXPECT_EQ(groups[0].blocks(), block_vector_t(blocks.begin(), blocks.begin() + 3));
+    EXPECT_EQ(groups[1].blocks(), block_vector_t{ blocks[3] });
+    EXPECT_EQ(groups[2].blocks(), block_vector_t(blocks.begin() + 4, blocks.end()));
+
+    // Only the heavy block gets a dedicated core
+    EXPECT_EQ(groups[0].processor_affinity().size(), 0u);
+    EXPECT_EQ(groups[1].processor_affinity().size(), 1u);
+    EXPECT_EQ(groups[2].processor_affinity().size(), 0u);
+
+    // Nothing measured, one thread per block
+    groups = schedulers::auto_partitioner::partition(
+        blocks, std::vector<double>(blocks.size(), 0.0), 4, true);
+    EXPECT_EQ(groups.size(), blocks.size());
+}
+
+TEST(SchedulerAutoPartition, WarmupAndProfile)
+{
+    int nsamples = 1000000;
+    int nblocks = 8;
+    std::vector<float> input_data(nsamples);
+    std::vector<float> expected_data(nsamples);
+    for (int i = 0; i < nsamples; i++) {
+        input_data[i] = i % 256;
+        expected_data[i] = input_data[i] * 3.0;
+    }
+
+    std::string profile_file = "qa_auto_partition_profile.yml";
+    std::remove(profile_file.c_str());
+
+    // The first run profiles and saves, the second run reuses the profile
+    for (int run = 0; run < 2; run++) {
+        auto src = blocks::vector_source_f::make_cpu({ input_data, false });
+        auto snk = blocks::vector_sink_f::make({});
+        std::vector<block_sptr> chain;
+        for (int i = 0; i < nblocks; i++) {
+            chain.push_back(i == nblocks / 2 ? block_sptr(math::multiply_const_ff::make_cpu({ 3.0 }))
+                                             : block_sptr(blocks::copy::make({ sizeof(float) })));
+        }
+
+        auto fg = flowgraph::make();
+        fg->connect(src, 0, chain[0], 0);
+        for (int i = 1; i < nblocks; i++) {
+            fg->connect(chain[i - 1], 0, chain[i], 0);
+        }
+        fg->connect(chain[nblocks - 1], 0, snk, 0);
+
+        auto sched = schedulers::scheduler_nbt::make("nbt");
+        schedulers::auto_partition_properties props;
+        props.max_threads = 2;
+        props.warmup_seconds = 0.01;
+        props.profile_file = profile_file;
+        sched->set_auto_partition(props);
+        fg->add_scheduler(sched);
+
+        fg->start();
+        fg->wait();
+
+        EXPECT_EQ(snk->data(), expected_data);
+        EXPECT_TRUE(std::ifstream(profile_file).good());
+    }
+
+    std::remove(profile_file.c_str());
+}
+
+TEST(SchedulerAutoPartition, ReservedCpus)
+{
+    block_vector_t blocks;
+    for (int i = 0; i < 3; i++) {
+        blocks.push_back(blocks::copy::make({ sizeof(float) }));
+    }
+    std::vector<double> cost{ 10.0, 10.0, 10.0 };
+
+    // Cores in hand placed groups are left alone
+    auto groups =
+        schedulers::auto_partitioner::partition(blocks, cost, 3, true, { 0, 2 });
+    ASSERT_EQ(groups.size(), 3u);
+    if (std::thread::hardware_concurrency() >= 5) {
+        EXPECT_EQ(groups[0].processor_affinity(), std::vector<unsigned int>{ 1 });
+        EXPECT_EQ(groups[1].processor_affinity(), std::vector<unsigned int>{ 3 });
+        EXPECT_EQ(groups[2].processor_affinity(), std::vector<unsigned int>{ 4 });
+    }
+    for (auto& bg : groups) {
+        for (auto c : bg.processor_affinity()) {
+            EXPECT_NE(c, 0u);
+            EXPECT_NE(c, 2u);
+        }
+    }
+}
+
+namespace {
+// Copies its input, counting the calls to start and stop
+class start_counter : public sync_block
+{
+public:
+    start_counter() : sync_block("start_counter")
+    {
+        add_port(port<float>::make("in", port_direction_t::INPUT));
+        add_port(port<float>::make("out", port_direction_t::OUTPUT));
+    }
+
+    bool start() override
+    {
+        n_start++;
+        return sync_block::start();
+    }
+    bool stop() override
+    {
+        n_stop++;
+        return sync_block::stop();
+    }
+
+    work_return_code_t work(std::vector<block_work_input_sptr>& work_input,
+                            std::vector<block_work_output_sptr>& work_output) override
+    {
+        auto n = work_output[0]->n_items;
+        std::memcpy(work_output[0]->items<float>(),
+                    work_input[0]->items<float>(),
+                    n * sizeof(float));
+        work_output[0]->n_produced = n;
+        return work_return_code_t::WORK_OK;
+    }
+
+    std::atomic<int> n_start = 0;
+    std::atomic<int> n_stop = 0;
+};
+} // namespace
+
+TEST(SchedulerAutoPartition, StartOnce)
+{
+    int nsamples = 100000;
+    std::vector<float> input_data(nsamples);
+    for (int i = 0; i < nsamples; i++) {
+        input_data[i] = i;
+    }
+
+    auto src = blocks::vector_source_f::make({ input_data, false });
+    auto counter = std::make_shared<start_counter>();
+    auto snk = blocks::vector_sink_f::make({});
+
+    auto fg = flowgraph::make();
+    fg->connect(src, 0, counter, 0);
+    fg->connect(counter, 0, snk, 0);
+
+    auto sched = schedulers::scheduler_nbt::make("nbt");
+    schedulers::auto_partition_properties props;
+    props.max_threads = 3;
+    props.warmup_seconds = 0.01;
+    sched->set_auto_partition(props);
+    fg->set_scheduler(sched);
+
+    fg->start();
+    fg->wait();
+
+    // Started for the warm-up and kept running, then stopped once
+    EXPECT_EQ(counter->n_start, 1);
+    EXPECT_EQ(counter->n_stop, 1);
+    EXPECT_EQ(snk->data(), input_data);
+}
@@ -66,3 +66,40 @@ TEST(SchedulerBlockGrouping, BasicBlockGrouping)
         }
     }
 }
+
+TEST(SchedulerBlockGrouping, ReverseOrderedGroup)
+{
+    int nsamples = 1000000;
+    int nblocks = 6;
+    std::vector<float> input_data(nsamples);
+    for (int i = 0; i < nsamples; i++) {
+        input_data[i] = i % 1024;
+    }
+
+    auto src = blocks::vector_source_f::make_cpu({ input_data, false });
+    auto snk = blocks::vector_sink_f::make({});
+    std::vector<block_sptr> mult_blks(nblocks);
+    for (int i = 0; i < nblocks; i++) {
+        mult_blks[i] = math::multiply_const_ff::make_cpu({ 1.0 });
+    }
+
+    flowgraph_sptr fg(new flowgraph());
+    fg->connect(src, 0, mult_blks[0], 0);
+    for (int i = 1; i < nblocks; i++) {
+        fg->connect(mult_blks[i - 1], 0, mult_blks[i], 0);
+    }
+    fg->connect(mult_blks[nblocks - 1], 0, snk, 0);
+
+    // The group is given sink first, the executor runs it source first
+    std::vector<block_sptr> bg(mult_blks.rbegin(), mult_blks.rend());
+    EXPECT_EQ(schedulers::graph_executor::topological_order(bg), mult_blks);
+
+    auto sch = schedulers::scheduler_nbt::make("nbtsched");
+    sch->add_block_group(bg);
+    fg->add_scheduler(sch);
+
+    fg->start();
+    fg->wait();
+
+    EXPECT_EQ(snk->data(), input_data);
+}
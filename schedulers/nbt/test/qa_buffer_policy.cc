@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+
+#include <gnuradio/blocks/copy.hh>
+#include <gnuradio/blocks/vector_sink.hh>
+#include <gnuradio/blocks/vector_source.hh>
+#include <gnuradio/buffer_cpu_vmcirc.hh>
+#include <gnuradio/buffer_management.hh>
+#include <gnuradio/flowgraph.hh>
+#include <gnuradio/schedulers/nbt/scheduler_nbt.hh>
+
+using namespace gr;
+
+TEST(BufferPolicyTest, CacheAwareSizes)
+{
+    auto src = blocks::vector_source_f::make({ std::vector<float>(1000), false });
+    auto copy1 = blocks::copy::make({ sizeof(float) });
+    auto copy2 = blocks::copy::make({ sizeof(float) });
+    auto snk = blocks::vector_sink_f::make({});
+
+    auto fg = flowgraph::make();
+    fg->connect(src, 0, copy1, 0);
+    fg->connect(copy1, 0, copy2, 0);
+    fg->connect(copy2, 0, snk, 0);
+
+    buffer_manager bufman(32768);
+    bufman.set_size_policy(buffer_size_policy_t::CACHE_AWARE);
+    bufman.set_thread_groups({ { copy1, copy2 } });
+    bufman.initialize_buffers(flat_graph::make_flat(fg),
+                              buffer_cpu_vmcirc_properties::make(
+                                  buffer_cpu_vmcirc_type::AUTO));
+
+    for (auto& b : std::vector<block_sptr>{ src, copy1, copy2 }) {
+        auto buf = b->output_stream_ports()[0]->buffer();
+        ASSERT_NE(buf, nullptr);
+        // Sizes are rounded up to a page multiple by the doubly mapped buffer
+        EXPECT_GE(buf->buf_size(), 8192u);
+        EXPECT_LE(buf->buf_size(), 4u * 1024 * 1024 + 65536);
+        EXPECT_EQ(buf->fill_limit(), 0u);
+    }
+}
+
+TEST(BufferPolicyTest, AdaptFillLimit)
+{
+    auto src = blocks::vector_source_f::make({ std::vector<float>(1000), false });
+    auto snk = blocks::vector_sink_f::make({});
+
+    auto fg = flowgraph::make();
+    fg->connect(src, 0, snk, 0);
+
+    buffer_manager bufman(32768);
+    bufman.set_size_policy(buffer_size_policy_t::FIXED, true);
+    bufman.initialize_buffers(flat_graph::make_flat(fg),
+                              buffer_cpu_vmcirc_properties::make(
+                                  buffer_cpu_vmcirc_type::AUTO));
+
+    auto buf = src->output_stream_ports()[0]->buffer();
+    auto rdr = snk->input_stream_ports()[0]->buffer_reader();
+    auto limit = buf->fill_limit();
+    EXPECT_EQ(limit, 32768u * 2 / sizeof(float));
+    EXPECT_GE(buf->num_items(), 4 * limit);
+    EXPECT_LE(buf->space_available(), limit);
+
+    // Writer and reader both waiting, the buffer is allowed to fill further
+    buf->count_output_blocked();
+    rdr->count_input_blocked();
+    bufman.adapt();
+    EXPECT_EQ(buf->fill_limit(), 2 * limit);
+
+    // Nothing blocked, nothing changes
+    bufman.adapt();
+    EXPECT_EQ(buf->fill_limit(), 2 * limit);
+
+    // Only the writer waiting, the buffer is held to less
+    buf->count_output_blocked();
+    bufman.adapt();
+    EXPECT_EQ(buf->fill_limit(), limit);
+}
+
+TEST(BufferPolicyTest, CacheAwareAdaptiveFlowgraph)
+{
+    int nsamples = 1000000;
+    std::vector<float> input_data(nsamples);
+    for (int i = 0; i < nsamples; i++) {
+        input_data[i] = i;
+    }
+    auto src = blocks::vector_source_f::make({ input_data, false });
+    auto snk = blocks::vector_sink_f::make({});
+    std::vector<blocks::copy::sptr> copy_blks(4);
+    for (auto& c : copy_blks) {
+        c = blocks::copy::make({ sizeof(float) });
+    }
+
+    auto fg = flowgraph::make();
+    fg->connect(src, 0, copy_blks[0], 0);
+    for (size_t i = 1; i < copy_blks.size(); i++) {
+        fg->connect(copy_blks[i - 1], 0, copy_blks[i], 0);
+    }
+    fg->connect(copy_blks[copy_blks.size() - 1], 0, snk, 0);
+
+    auto sched = schedulers::scheduler_nbt::make("nbt");
+    sched->set_buffer_size_policy(buffer_size_policy_t::CACHE_AWARE, true);
+    sched->add_block_group({ copy_blks[0], copy_blks[1] });
+    fg->set_scheduler(sched);
+
+    fg->start();
+    fg->wait();
+
+    EXPECT_EQ(snk->data(), input_data);
+}
@@ -0,0 +1,81 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include <gnuradio/blocks/copy.hh>
+#include <gnuradio/blocks/null_sink.hh>
+#include <gnuradio/blocks/null_source.hh>
+#include <gnuradio/buffer_cpu_vmcirc.hh>
+#include <gnuradio/buffer_management.hh>
+#include <gnuradio/flat_graph.hh>
+#include <gnuradio/graph.hh>
+#include <gnuradio/schedulers/nbt/graph_executor.hh>
+
+// Count every heap allocation made by the process so the executor hot path can be
+// checked for allocations
+static std::atomic<size_t> s_num_allocations = 0;
+
+void* operator new(std::size_t size)
+{
+    s_num_allocations++;
+    if (void* ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+using namespace gr;
+
+// Swallows the notifications that the executor sends to neighboring blocks
+struct null_neighbor_interface : public neighbor_interface {
+    void push_message(scheduler_message_sptr msg) override {}
+};
+
+TEST(SchedulerExecutorAllocations, ZeroAllocationsPerIteration)
+{
+    auto src = blocks::null_source::make({ 1, sizeof(gr_complex) });
+    auto copy1 = blocks::copy::make({ sizeof(gr_complex) });
+    auto copy2 = blocks::copy::make({ sizeof(gr_complex) });
+    auto snk = blocks::null_sink::make({ 1, sizeof(gr_complex) });
+
+    auto g = std::make_shared<graph>();
+    g->connect(src, 0, copy1, 0);
+    g->connect(copy1, 0, copy2, 0);
+    g->connect(copy2, 0, snk, 0);
+    auto fg = flat_graph::make_flat(g);
+
+    auto bufman = std::make_shared<buffer_manager>(32768);
+    bufman->initialize_buffers(fg, BUFFER_CPU_VMCIRC_ARGS);
+
+    std::vector<block_sptr> blocks{ src, copy1, copy2, snk };
+    auto intf = std::make_shared<null_neighbor_interface>();
+    for (auto& b : blocks) {
+        b->set_parent_intf(intf);
+        for (auto& p : b->all_ports()) {
+            p->set_parent_intf(intf);
+        }
+    }
+
+    schedulers::graph_executor exec("qa_executor_allocations");
+    exec.initialize(bufman, blocks);
+
+    // warm up
+    for (int i = 0; i < 100; i++) {
+        exec.run_one_iteration();
+    }
+
+    size_t num_iterations = 1000;
+    auto allocs_before = s_num_allocations.load();
+    for (size_t i = 0; i < num_iterations; i++) {
+        auto& status = exec.run_one_iteration();
+        EXPECT_EQ(status.size(), blocks.size());
+    }
+    auto allocs_after = s_num_allocations.load();
+
+    EXPECT_EQ(allocs_after - allocs_before, 0);
+    EXPECT_GT(snk->input_stream_ports()[0]->buffer_reader()->total_read(), 0);
+}
@@ -0,0 +1,187 @@
+#include <gtest/gtest.h>
+
+#include <gnuradio/blocks/vector_sink.hh>
+#include <gnuradio/blocks/vector_source.hh>
+#include <gnuradio/buffer_cpu_vmcirc.hh>
+#include <gnuradio/flowgraph.hh>
+#include <gnuradio/port.hh>
+#include <gnuradio/schedulers/nbt/scheduler_nbt.hh>
+#include <gnuradio/sync_block.hh>
+
+#include <chrono>
+#include <thread>
+
+using namespace gr;
+
+namespace {
+// Sum of the last length items, reading the previous items through the history
+class moving_sum : public sync_block
+{
+public:
+    moving_sum(unsigned int length) : sync_block("moving_sum"), d_length(length)
+    {
+        add_port(port<float>::make("in", port_direction_t::INPUT));
+        add_port(port<float>::make("out", port_direction_t::OUTPUT));
+        set_history(length);
+    }
+
+    work_return_code_t work(std::vector<block_work_input_sptr>& work_input,
+                            std::vector<block_work_output_sptr>& work_output) override
+    {
+        auto in = work_input[0]->items<float>();
+        auto out = work_output[0]->items<float>();
+        for (int i = 0; i < work_output[0]->n_items; i++) {
+            float sum = 0;
+            for (unsigned int k = 0; k < d_length; k++) {
+                sum += in[i + k];
+            }
+            out[i] = sum;
+        }
+        work_output[0]->n_produced = work_output[0]->n_items;
+        return work_return_code_t::WORK_OK;
+    }
+
+private:
+    unsigned int d_length;
+};
+
+// Copies its input, with a delay of 4 from the 1000th item on by growing the history
+class late_delay : public sync_block
+{
+public:
+    late_delay() : sync_block("late_delay")
+    {
+        add_port(port<float>::make("in", port_direction_t::INPUT));
+        add_port(port<float>::make("out", port_direction_t::OUTPUT));
+        set_max_history(5);
+    }
+
+    work_return_code_t work(std::vector<block_work_input_sptr>& work_input,
+                            std::vector<block_work_output_sptr>& work_output) override
+    {
+        if (d_nitems == 1000 && history() == 1) {
+            // Let the source fill the buffer up, overwriting whatever is not reserved
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            set_history(5);
+            work_output[0]->n_produced = 0;
+            return work_return_code_t::WORK_OK;
+        }
+
+        auto in = work_input[0]->items<float>();
+        auto out = work_output[0]->items<float>();
+        auto n = work_output[0]->n_items;
+        if (d_nitems < 1000) {
+            n = std::min(n, (int)(1000 - d_nitems));
+        }
+        for (int i = 0; i < n; i++) {
+            out[i] = in[i];
+        }
+        d_nitems += n;
+        work_output[0]->n_produced = n;
+        return work_return_code_t::WORK_OK;
+    }
+
+private:
+    uint64_t d_nitems = 0;
+};
+} // namespace
+
+TEST(HistoryTest, ReaderWindow)
+{
+    auto props = buffer_cpu_vmcirc_properties::make(buffer_cpu_vmcirc_type::AUTO);
+    auto buf = props->factory()(8192, sizeof(float), props);
+    auto rdr = buf->add_reader(props, sizeof(float));
+    rdr->set_history(4);
+    EXPECT_EQ(rdr->history(), 4u);
+
+    // Go around the buffer a few times so the window crosses the wrap point
+    uint64_t n = 0;
+    for (int iter = 0; iter < 100; iter++) {
+        buffer_info_t info;
+        buf->write_info(info);
+        auto nwrite = std::min(info.n_items, 1000);
+        ASSERT_GT(nwrite, 0);
+        auto out = static_cast<float*>(buf->write_ptr());
+        for (int i = 0; i < nwrite; i++) {
+            out[i] = n + i + 1;
+        }
+        buf->post_write(nwrite);
+
+        auto in = static_cast<const float*>(rdr->read_ptr());
+        auto nread = rdr->items_available();
+        for (size_t i = 0; i < nread; i++) {
+            // the 3 items before the first unread one are readable, zeros at the start
+            auto expected = (float)(n + i + 1) - 3;
+            ASSERT_EQ(in[i], expected < 1 ? 0 : expected);
+        }
+        rdr->post_read(nread);
+        n += nread;
+    }
+
+    // The writer does not overwrite the history
+    auto history = buf->num_items() * 3 / 4;
+    rdr->set_history(history);
+    buffer_info_t info;
+    buf->write_info(info);
+    EXPECT_LT((size_t)info.n_items, buf->num_items() - (history - 1));
+
+    EXPECT_THROW(rdr->set_history(buf->num_items() * 2), std::runtime_error);
+}
+
+TEST(HistoryTest, MovingSum)
+{
+    int nsamples = 100000;
+    unsigned int length = 17;
+    std::vector<float> input_data(nsamples);
+    for (int i = 0; i < nsamples; i++) {
+        input_data[i] = i % 256;
+    }
+    std::vector<float> expected(nsamples);
+    for (int i = 0; i < nsamples; i++) {
+        for (int k = std::max(0, i - (int)length + 1); k <= i; k++) {
+            expected[i] += input_data[k];
+        }
+    }
+
+    auto src = blocks::vector_source_f::make({ input_data, false });
+    auto sum = std::make_shared<moving_sum>(length);
+    auto snk = blocks::vector_sink_f::make({});
+
+    auto fg = flowgraph::make();
+    fg->connect(src, 0, sum, 0);
+    fg->connect(sum, 0, snk, 0);
+    fg->start();
+    fg->wait();
+
+    EXPECT_EQ(snk->data(), expected);
+
+    EXPECT_THROW(sum->set_history(0), std::invalid_argument);
+}
+
+TEST(HistoryTest, GrowWhileRunning)
+{
+    int nsamples = 100000;
+    std::vector<float> input_data(nsamples);
+    for (int i = 0; i < nsamples; i++) {
+        input_data[i] = i;
+    }
+    std::vector<float> expected(input_data.begin(), input_data.begin() + 1000);
+    expected.insert(expected.end(), input_data.begin() + 996, input_data.end() - 4);
+
+    auto src = blocks::vector_source_f::make({ input_data, false });
+    auto delay = std::make_shared<late_delay>();
+    auto snk = blocks::vector_sink_f::make({});
+
+    auto fg = flowgraph::make();
+    fg->connect(src, 0, delay, 0);
+    fg->connect(delay, 0, snk, 0);
+    fg->start();
+    fg->wait();
+
+    EXPECT_EQ(snk->data(), expected);
+
+    // The buffers were sized for a history of 5, no more
+    EXPECT_EQ(delay->max_history(), 5u);
+    EXPECT_THROW(delay->set_history(10), std::invalid_argument);
+    EXPECT_THROW(delay->set_max_history(10), std::invalid_argument);
+}
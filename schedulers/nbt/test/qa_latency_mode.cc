@@ -0,0 +1,269 @@
+#include <gtest/gtest.h>
+
+#include <gnuradio/blocks/copy.hh>
+#include <gnuradio/blocks/head.hh>
+#include <gnuradio/blocks/latency_probe.hh>
+#include <gnuradio/blocks/latency_stamp.hh>
+#include <gnuradio/blocks/null_sink.hh>
+#include <gnuradio/blocks/null_source.hh>
+#include <gnuradio/blocks/throttle.hh>
+#include <gnuradio/blocks/vector_sink.hh>
+#include <gnuradio/blocks/vector_source.hh>
+#include <gnuradio/buffer_cpu_vmcirc.hh>
+#include <gnuradio/buffer_management.hh>
+#include <gnuradio/buffer_passthrough.hh>
+#include <gnuradio/flat_graph.hh>
+#include <gnuradio/flowgraph.hh>
+#include <gnuradio/graph.hh>
+#include <gnuradio/port.hh>
+#include <gnuradio/schedulers/nbt/graph_executor.hh>
+#include <gnuradio/schedulers/nbt/scheduler_nbt.hh>
+#include <gnuradio/sync_block.hh>
+
+#include <atomic>
+#include <cstring>
+
+using namespace gr;
+
+namespace {
+// Copies its input, keeping track of the largest work call
+class window_recorder : public sync_block
+{
+public:
+    window_recorder() : sync_block("window_recorder")
+    {
+        add_port(port<float>::make("in", port_direction_t::INPUT));
+        add_port(port<float>::make("out", port_direction_t::OUTPUT));
+    }
+
+    work_return_code_t work(std::vector<block_work_input_sptr>& work_input,
+                            std::vector<block_work_output_sptr>& work_output) override
+    {
+        d_max_input = std::max(d_max_input.load(), (int)work_input[0]->n_items);
+        d_max_output = std::max(d_max_output.load(), (int)work_output[0]->n_items);
+
+        auto n = work_output[0]->n_items;
+        std::memcpy(work_output[0]->items<float>(),
+                    work_input[0]->items<float>(),
+                    n * sizeof(float));
+        work_output[0]->n_produced = n;
+        return work_return_code_t::WORK_OK;
+    }
+
+    int max_input() const { return d_max_input; }
+    int max_output() const { return d_max_output; }
+
+private:
+    std::atomic<int> d_max_input = 0;
+    std::atomic<int> d_max_output = 0;
+};
+
+// Copies its input, appending its name to a shared log on each work call
+class call_logger : public sync_block
+{
+public:
+    call_logger(const std::string& name, std::shared_ptr<std::vector<std::string>> log)
+        : sync_block("call_logger"), d_name(name), d_log(log)
+    {
+        add_port(port<float>::make("in", port_direction_t::INPUT));
+        add_port(port<float>::make("out", port_direction_t::OUTPUT));
+    }
+
+    work_return_code_t work(std::vector<block_work_input_sptr>& work_input,
+                            std::vector<block_work_output_sptr>& work_output) override
+    {
+        d_log->push_back(d_name);
+
+        auto n = work_output[0]->n_items;
+        std::memcpy(work_output[0]->items<float>(),
+                    work_input[0]->items<float>(),
+                    n * sizeof(float));
+        work_output[0]->n_produced = n;
+        return work_return_code_t::WORK_OK;
+    }
+
+private:
+    std::string d_name;
+    std::shared_ptr<std::vector<std::string>> d_log;
+};
+
+struct null_neighbor_interface : public neighbor_interface {
+    void push_message(scheduler_message_sptr msg) override {}
+};
+
+// Order of the first work calls of three chained blocks run directly on an executor
+std::vector<std::string> call_order(size_t max_items_per_call)
+{
+    auto log = std::make_shared<std::vector<std::string>>();
+    auto src = blocks::null_source::make({ 1, sizeof(float) });
+    auto first = std::make_shared<call_logger>("first", log);
+    auto second = std::make_shared<call_logger>("second", log);
+    auto third = std::make_shared<call_logger>("third", log);
+    auto snk = blocks::null_sink::make({ 1, sizeof(float) });
+
+    auto g = std::make_shared<graph>();
+    g->connect(src, 0, first, 0);
+    g->connect(first, 0, second, 0);
+    g->connect(second, 0, third, 0);
+    g->connect(third, 0, snk, 0);
+    auto fg = flat_graph::make_flat(g);
+
+    auto bufman = std::make_shared<buffer_manager>(32768);
+    bufman->set_max_items_per_call(max_items_per_call);
+    bufman->initialize_buffers(fg, BUFFER_CPU_VMCIRC_ARGS);
+
+    std::vector<block_sptr> blocks{ src, first, second, third, snk };
+    auto intf = std::make_shared<null_neighbor_interface>();
+    for (auto& b : blocks) {
+        b->set_parent_intf(intf);
+        for (auto& p : b->all_ports()) {
+            p->set_parent_intf(intf);
+        }
+    }
+
+    schedulers::graph_executor exec("qa_latency_mode");
+    exec.initialize(bufman, blocks);
+    exec.set_max_items_per_call(max_items_per_call);
+    exec.run_one_iteration();
+
+    log->resize(std::min(log->size(), (size_t)3));
+    return *log;
+}
+
+// Median latency through a throttled chain, stamped right after the source
+double median_latency(size_t max_items_per_call)
+{
+    std::vector<float> input_data(1000);
+    auto src = blocks::vector_source_f::make({ input_data, true });
+    auto stamp = blocks::latency_stamp::make_cpu({ 100, sizeof(float) });
+    auto throttle = blocks::throttle::make_cpu({ 100000, true, sizeof(float) });
+    auto head = blocks::head::make_cpu({ 20000, sizeof(float) });
+    auto probe = blocks::latency_probe::make_cpu({ 100000, sizeof(float) });
+
+    auto fg = flowgraph::make();
+    fg->connect(src, 0, stamp, 0);
+    fg->connect(stamp, 0, throttle, 0);
+    fg->connect(throttle, 0, head, 0);
+    fg->connect(head, 0, probe, 0);
+
+    auto sched = schedulers::scheduler_nbt::make("nbt");
+    sched->set_latency_mode(max_items_per_call);
+    fg->set_scheduler(sched);
+    fg->start();
+    fg->wait();
+
+    EXPECT_GT(probe->num_samples(), 100u);
+    EXPECT_LE(probe->percentile(50), probe->percentile(99));
+    EXPECT_LE(probe->percentile(99), probe->percentile(100));
+    return probe->percentile(50);
+}
+} // namespace
+
+TEST(LatencyModeTest, CappedCalls)
+{
+    int nsamples = 100000;
+    std::vector<float> input_data(nsamples);
+    for (int i = 0; i < nsamples; i++) {
+        input_data[i] = i;
+    }
+
+    auto src = blocks::vector_source_f::make({ input_data, false });
+    auto rec = std::make_shared<window_recorder>();
+    auto snk = blocks::vector_sink_f::make({});
+
+    auto fg = flowgraph::make();
+    fg->connect(src, 0, rec, 0);
+    fg->connect(rec, 0, snk, 0);
+
+    auto sched = schedulers::scheduler_nbt::make("nbt");
+    sched->set_latency_mode(64);
+    fg->set_scheduler(sched);
+    fg->start();
+    fg->wait();
+
+    EXPECT_EQ(snk->data(), input_data);
+    EXPECT_LE(rec->max_input(), 64);
+    EXPECT_LE(rec->max_output(), 64);
+
+    // Two calls worth of unread items at most
+    EXPECT_EQ(src->output_stream_ports()[0]->buffer()->fill_limit(), 128u);
+    EXPECT_EQ(rec->output_stream_ports()[0]->buffer()->fill_limit(), 128u);
+}
+
+TEST(LatencyModeTest, SinksFirst)
+{
+    // Each pass runs from the source down, so data goes all the way through at once
+    EXPECT_EQ(call_order(0), (std::vector<std::string>{ "first", "second", "third" }));
+
+    // Each pass runs from the sink up: the second block takes the chunk the first one
+    // passed on before the first takes the next chunk from the source
+    EXPECT_EQ(call_order(64), (std::vector<std::string>{ "first", "second", "first" }));
+}
+
+TEST(LatencyModeTest, PassThroughFillLimit)
+{
+    auto props = buffer_cpu_vmcirc_properties::make(buffer_cpu_vmcirc_type::AUTO);
+    auto buf = props->factory()(8192, sizeof(float), props);
+    auto rdr = buf->add_reader(props, sizeof(float));
+    auto view = buffer_passthrough::make(buf, rdr, sizeof(float));
+    auto view_rdr = view->add_reader(props, sizeof(float));
+    view->set_fill_limit(128);
+
+    // Much more waiting upstream than the view may hold unread
+    buf->post_write(1000);
+    EXPECT_EQ(view->space_available(), 128u);
+
+    rdr->post_read(100);
+    view->post_write(100);
+    EXPECT_EQ(view->space_available(), 28u);
+
+    rdr->post_read(28);
+    view->post_write(28);
+    EXPECT_EQ(view->space_available(), 0u);
+
+    // Reading downstream makes room again
+    view_rdr->post_read(64);
+    EXPECT_EQ(view->space_available(), 64u);
+}
+
+TEST(LatencyModeTest, PassThroughEdge)
+{
+    int nsamples = 100000;
+    std::vector<float> input_data(nsamples);
+    for (int i = 0; i < nsamples; i++) {
+        input_data[i] = i;
+    }
+
+    auto src = blocks::vector_source_f::make({ input_data, false });
+    auto copy = blocks::copy::make({ sizeof(float) });
+    auto rec = std::make_shared<window_recorder>();
+    auto snk = blocks::vector_sink_f::make({});
+
+    auto fg = flowgraph::make();
+    fg->connect(src, 0, copy, 0);
+    fg->connect(copy, 0, rec, 0);
+    fg->connect(rec, 0, snk, 0);
+
+    auto sched = schedulers::scheduler_nbt::make("nbt");
+    sched->set_latency_mode(64);
+    fg->set_scheduler(sched);
+    fg->start();
+    fg->wait();
+
+    EXPECT_EQ(snk->data(), input_data);
+    EXPECT_LE(rec->max_input(), 64);
+
+    // The view of the source buffer is held to the same fill as a real buffer
+    auto buf = copy->output_stream_ports()[0]->buffer();
+    EXPECT_EQ(buf->type().rfind("buffer_passthrough", 0), 0u) << buf->type();
+    EXPECT_EQ(buf->fill_limit(), 128u);
+}
+
+TEST(LatencyModeTest, Probe)
+{
+    auto throughput = median_latency(0);
+    auto latency = median_latency(64);
+
+    // Items no longer wait behind most of a buffer for the throttle
+    EXPECT_LT(latency, throughput);
+}
@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+
+#include <gnuradio/blocks/vector_sink.hh>
+#include <gnuradio/blocks/vector_source.hh>
+#include <gnuradio/flowgraph.hh>
+#include <gnuradio/port.hh>
+#include <gnuradio/schedulers/nbt/scheduler_nbt.hh>
+#include <gnuradio/schedulers/nbt/thread_wrapper.hh>
+#include <gnuradio/sync_block.hh>
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+using namespace gr;
+
+namespace {
+// Copies its input and floods its own scheduler thread with work notifications from
+// inside work, while that thread is busy and cannot drain them
+class notify_burst : public sync_block
+{
+public:
+    notify_burst() : sync_block("notify_burst")
+    {
+        add_port(port<float>::make("in", port_direction_t::INPUT));
+        add_port(port<float>::make("out", port_direction_t::OUTPUT));
+    }
+
+    work_return_code_t work(std::vector<block_work_input_sptr>& work_input,
+                            std::vector<block_work_output_sptr>& work_output) override
+    {
+        auto in = work_input[0]->items<float>();
+        auto out = work_output[0]->items<float>();
+        auto n = work_output[0]->n_items;
+        for (int i = 0; i < n; i++) {
+            out[i] = in[i];
+        }
+
+        notify_all(100);
+        auto t = std::dynamic_pointer_cast<schedulers::thread_wrapper>(p_scheduler);
+        if (t) {
+            d_max_queued = std::max(d_max_queued, t->queued_messages());
+        }
+
+        work_output[0]->n_produced = n;
+        return work_return_code_t::WORK_OK;
+    }
+
+    void notify_all(int count)
+    {
+        auto sched = p_scheduler;
+        if (!sched) {
+            return;
+        }
+        for (int i = 0; i < count; i++) {
+            sched->push_message(
+                std::make_shared<scheduler_action>(scheduler_action_t::NOTIFY_INPUT));
+            sched->push_message(
+                std::make_shared<scheduler_action>(scheduler_action_t::NOTIFY_OUTPUT));
+            sched->push_message(
+                std::make_shared<scheduler_action>(scheduler_action_t::NOTIFY_ALL));
+        }
+    }
+
+    size_t max_queued() const { return d_max_queued; }
+
+private:
+    size_t d_max_queued = 0;
+};
+} // namespace
+
+TEST(NotificationTest, BurstIsCoalesced)
+{
+    int nsamples = 1000000;
+    std::vector<float> input_data(nsamples);
+    for (int i = 0; i < nsamples; i++) {
+        input_data[i] = i;
+    }
+    auto src = blocks::vector_source_f::make({ input_data, false });
+    auto burst = std::make_shared<notify_burst>();
+    auto snk = blocks::vector_sink_f::make({});
+
+    auto fg = flowgraph::make();
+    fg->connect(src, 0, burst, 0);
+    fg->connect(burst, 0, snk, 0);
+
+    fg->start();
+
+    // Another thread keeps notifying the same scheduler thread while it runs, racing
+    // with the thread clearing its pending flag
+    std::atomic<bool> running = true;
+    std::thread flood([&]() {
+        while (running) {
+            burst->notify_all(10);
+        }
+    });
+
+    fg->wait();
+    running = false;
+    flood.join();
+
+    // No wake-up was lost along the way
+    EXPECT_EQ(snk->data(), input_data);
+
+    // 300 notifications per work call, but at most one of them queued.  Besides it only
+    // the DONE and EXIT of the flowgraph monitor can be waiting
+    EXPECT_GT(burst->max_queued(), 0u);
+    EXPECT_LE(burst->max_queued(), 3u);
+}
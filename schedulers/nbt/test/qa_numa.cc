@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+
+#include <gnuradio/blocks/copy.hh>
+#include <gnuradio/blocks/vector_sink.hh>
+#include <gnuradio/blocks/vector_source.hh>
+#include <gnuradio/buffer_cpu_simple.hh>
+#include <gnuradio/flowgraph.hh>
+#include <gnuradio/numa.hh>
+#include <gnuradio/schedulers/nbt/scheduler_nbt.hh>
+
+using namespace gr;
+using namespace gr::schedulers;
+
+TEST(NumaTest, Topology)
+{
+    ASSERT_GE(numa::num_nodes(), 1);
+
+    size_t ncpus = 0;
+    for (int node = 0; node < numa::num_nodes(); node++) {
+        for (auto c : numa::node_cpus(node)) {
+            EXPECT_EQ(numa::node_of_cpu(c), node);
+            ncpus++;
+        }
+        EXPECT_EQ(numa::node_of_cpus(numa::node_cpus(node)),
+                  numa::node_cpus(node).empty() ? -1 : node);
+    }
+    EXPECT_GE(ncpus, 1u);
+    EXPECT_TRUE(numa::node_cpus(numa::num_nodes()).empty());
+    EXPECT_EQ(numa::node_of_cpus({}), -1);
+
+    int node = numa::current_node();
+    EXPECT_GE(node, 0);
+    EXPECT_LT(node, numa::num_nodes());
+
+    auto buf = buffer_cpu_simple::make(65536, sizeof(float), nullptr);
+    EXPECT_EQ(buf->numa_node(), -1);
+    buf->set_numa_node(node);
+    EXPECT_EQ(buf->numa_node(), node);
+}
+
+TEST(NumaTest, AssignNodes)
+{
+    std::vector<block_sptr> b;
+    for (int i = 0; i < 5; i++) {
+        b.push_back(blocks::copy::make({ sizeof(float) }));
+    }
+    auto fg = flowgraph::make();
+    // Two chains, b0 -> b1 -> b2 and b3 -> b4
+    fg->connect(b[0], 0, b[1], 0);
+    fg->connect(b[1], 0, b[2], 0);
+    fg->connect(b[3], 0, b[4], 0);
+
+    // Two nodes of two CPUs each
+    std::vector<std::vector<unsigned int>> node_cpus{ { 0, 1 }, { 2, 3 } };
+
+    // Interleaved, the chains still land on a node each
+    std::vector<block_group_properties> groups{ block_group_properties({ b[0] }),
+                                                block_group_properties({ b[3] }),
+                                                block_group_properties({ b[1], b[2] }),
+                                                block_group_properties({ b[4] }) };
+    auto node = numa_placer::assign_nodes(groups, fg->edges(), node_cpus);
+    EXPECT_EQ(node, std::vector<int>({ 0, 1, 0, 1 }));
+
+    // A chain longer than a node spills over
+    groups = { block_group_properties({ b[0] }),
+               block_group_properties({ b[1] }),
+               block_group_properties({ b[2] }) };
+    node = numa_placer::assign_nodes(groups, fg->edges(), node_cpus);
+    EXPECT_EQ(node, std::vector<int>({ 0, 0, 1 }));
+
+    // Pinned groups stay, and pull their neighbors over
+    groups = { block_group_properties({ b[3] }),
+               block_group_properties({ b[4] }, "", { 3 }),
+               block_group_properties({ b[0] }, "", { 1, 2 }) };
+    node = numa_placer::assign_nodes(groups, fg->edges(), node_cpus);
+    EXPECT_EQ(node, std::vector<int>({ 1, 1, -1 }));
+}
+
+TEST(NumaTest, Flowgraph)
+{
+    int nsamples = 200000;
+    std::vector<float> input_data(nsamples);
+    for (int i = 0; i < nsamples; i++) {
+        input_data[i] = i;
+    }
+
+    auto src = blocks::vector_source_f::make({ input_data, false });
+    auto copy0 = blocks::copy::make({ sizeof(float) });
+    auto copy1 = blocks::copy::make({ sizeof(float) });
+    auto snk = blocks::vector_sink_f::make({});
+
+    auto fg = flowgraph::make();
+    fg->connect(src, 0, copy0, 0);
+    fg->connect(copy0, 0, copy1, 0);
+    fg->connect(copy1, 0, snk, 0);
+
+    auto sched = scheduler_nbt::make("nbt");
+    sched->add_block_group({ copy0, copy1 }, "copies", { 0 });
+    sched->set_numa_placement();
+    fg->set_scheduler(sched);
+
+    fg->start();
+    fg->wait();
+
+    EXPECT_EQ(snk->data(), input_data);
+
+    // Each writer placed its output buffer on its own node
+    EXPECT_EQ(copy0->output_stream_ports()[0]->buffer()->numa_node(), numa::node_of_cpu(0));
+    EXPECT_EQ(copy1->output_stream_ports()[0]->buffer()->numa_node(), numa::node_of_cpu(0));
+    EXPECT_GE(src->output_stream_ports()[0]->buffer()->numa_node(), 0);
+}
@@ -0,0 +1,217 @@
+#include <gtest/gtest.h>
+
+#include <gnuradio/blocks/head.hh>
+#include <gnuradio/blocks/vector_sink.hh>
+#include <gnuradio/blocks/vector_source.hh>
+#include <gnuradio/buffer_cpu_vmcirc.hh>
+#include <gnuradio/buffer_passthrough.hh>
+#include <gnuradio/flowgraph.hh>
+#include <gnuradio/port.hh>
+#include <gnuradio/schedulers/nbt/scheduler_nbt.hh>
+#include <gnuradio/sync_block.hh>
+
+#include <atomic>
+#include <cstring>
+
+using namespace gr;
+
+namespace {
+// Copies its input, counting the calls where the output was not a view of the input
+class checked_copy : public sync_block
+{
+public:
+    checked_copy() : sync_block("checked_copy")
+    {
+        add_port(port<float>::make("in", port_direction_t::INPUT));
+        add_port(port<float>::make("out", port_direction_t::OUTPUT));
+        set_pass_through(0, 0);
+    }
+
+    work_return_code_t work(std::vector<block_work_input_sptr>& work_input,
+                            std::vector<block_work_output_sptr>& work_output) override
+    {
+        auto in = work_input[0]->items<float>();
+        auto out = work_output[0]->items<float>();
+        auto n = work_output[0]->n_items;
+        if (out != in) {
+            d_copies++;
+            std::memcpy(out, in, n * sizeof(float));
+        }
+        work_output[0]->n_produced = n;
+        return work_return_code_t::WORK_OK;
+    }
+
+    uint64_t copies() const { return d_copies; }
+
+private:
+    std::atomic<uint64_t> d_copies = 0;
+};
+
+// Copies its input from the far end of a long history
+class history_copy : public sync_block
+{
+public:
+    history_copy(unsigned int history) : sync_block("history_copy")
+    {
+        add_port(port<float>::make("in", port_direction_t::INPUT));
+        add_port(port<float>::make("out", port_direction_t::OUTPUT));
+        set_history(history);
+    }
+
+    work_return_code_t work(std::vector<block_work_input_sptr>& work_input,
+                            std::vector<block_work_output_sptr>& work_output) override
+    {
+        auto in = work_input[0]->items<float>() + history() - 1;
+        auto n = work_output[0]->n_items;
+        std::memcpy(work_output[0]->items<float>(), in, n * sizeof(float));
+        work_output[0]->n_produced = n;
+        return work_return_code_t::WORK_OK;
+    }
+};
+} // namespace
+
+TEST(PassThroughTest, BufferView)
+{
+    auto props = buffer_cpu_vmcirc_properties::make(buffer_cpu_vmcirc_type::AUTO);
+    auto buf = props->factory()(8192, sizeof(float), props);
+    auto rdr = buf->add_reader(props, sizeof(float));
+    auto view = buffer_passthrough::make(buf, rdr, sizeof(float));
+    auto view_rdr = view->add_reader(props, sizeof(float));
+    EXPECT_EQ(view->buf_size(), buf->buf_size());
+
+    // Go around the buffer a few times so the windows cross the wrap point
+    uint64_t n = 0;
+    for (int iter = 0; iter < 100; iter++) {
+        buffer_info_t info;
+        buf->write_info(info);
+        auto nwrite = std::min(info.n_items, 1000);
+        ASSERT_GT(nwrite, 0);
+        auto out = static_cast<float*>(buf->write_ptr());
+        for (int i = 0; i < nwrite; i++) {
+            out[i] = n + i;
+        }
+        buf->post_write(nwrite);
+
+        // The pass-through writes where it reads, as much as it can read
+        EXPECT_EQ(view->write_ptr(), rdr->read_ptr());
+        EXPECT_EQ(view->space_available(), rdr->items_available());
+        auto npass = rdr->items_available();
+        rdr->post_read(npass);
+        view->post_write(npass);
+
+        auto in = static_cast<const float*>(view_rdr->read_ptr());
+        auto nread = view_rdr->items_available();
+        ASSERT_EQ(nread, npass);
+        for (size_t i = 0; i < nread; i++) {
+            ASSERT_EQ(in[i], (float)(n + i));
+        }
+        view_rdr->post_read(nread);
+        n += nread;
+    }
+
+    // Items passed but not yet read downstream are not overwritten
+    buffer_info_t info;
+    buf->write_info(info);
+    auto space = info.n_items;
+    buf->post_write(space);
+    rdr->post_read(space);
+    view->post_write(space);
+    buf->write_info(info);
+    EXPECT_LT(info.n_items, space);
+    view_rdr->post_read(space);
+    buf->write_info(info);
+    EXPECT_EQ(info.n_items, space);
+}
+
+TEST(PassThroughTest, Flowgraph)
+{
+    int nsamples = 1000000;
+    size_t nhead = 900000;
+    std::vector<float> input_data(nsamples);
+    for (int i = 0; i < nsamples; i++) {
+        input_data[i] = i;
+    }
+    std::vector<float> expected(input_data.begin(), input_data.begin() + nhead);
+
+    auto src = blocks::vector_source_f::make({ input_data, false });
+    auto copy0 = std::make_shared<checked_copy>();
+    auto head = blocks::head::make_cpu({ nhead, sizeof(float) });
+    auto copy1 = std::make_shared<checked_copy>();
+    auto snk0 = blocks::vector_sink_f::make({});
+    auto snk1 = blocks::vector_sink_f::make({});
+
+    // A chain of pass-throughs, all viewing the output of the source, and two readers
+    auto fg = flowgraph::make();
+    fg->connect(src, 0, copy0, 0);
+    fg->connect(copy0, 0, head, 0);
+    fg->connect(head, 0, copy1, 0);
+    fg->connect(copy1, 0, snk0, 0);
+    fg->connect(copy1, 0, snk1, 0);
+    fg->start();
+    fg->wait();
+
+    EXPECT_EQ(snk0->data(), expected);
+    EXPECT_EQ(snk1->data(), expected);
+    EXPECT_EQ(copy0->copies(), 0u);
+    EXPECT_EQ(copy1->copies(), 0u);
+    for (auto& b : std::vector<block_sptr>{ copy0, head, copy1 }) {
+        auto buf = b->output_stream_ports()[0]->buffer();
+        EXPECT_EQ(buf->type().rfind("buffer_passthrough", 0), 0u) << buf->type();
+    }
+}
+
+TEST(PassThroughTest, FallbackToCopy)
+{
+    int nsamples = 100000;
+    std::vector<float> input_data(nsamples);
+    for (int i = 0; i < nsamples; i++) {
+        input_data[i] = i;
+    }
+
+    auto src = blocks::vector_source_f::make({ input_data, false });
+    auto copy0 = std::make_shared<checked_copy>();
+    auto snk = blocks::vector_sink_f::make({});
+
+    // A block with history cannot hand its read pointer on, so it gets a buffer
+    copy0->set_history(3);
+
+    auto fg = flowgraph::make();
+    fg->connect(src, 0, copy0, 0);
+    fg->connect(copy0, 0, snk, 0);
+    fg->start();
+    fg->wait();
+
+    EXPECT_GT(copy0->copies(), 0u);
+    EXPECT_NE(copy0->output_stream_ports()[0]->buffer()->type().rfind(
+                  "buffer_passthrough", 0),
+              0u);
+}
+
+TEST(PassThroughTest, LargeHistoryReader)
+{
+    int nsamples = 200000;
+    unsigned int history = 50000;
+    std::vector<float> input_data(nsamples);
+    for (int i = 0; i < nsamples; i++) {
+        input_data[i] = i;
+    }
+
+    auto src = blocks::vector_source_f::make({ input_data, false });
+    auto copy0 = std::make_shared<checked_copy>();
+    auto hist = std::make_shared<history_copy>(history);
+    auto snk = blocks::vector_sink_f::make({});
+
+    // The source buffer is only sized for the copy, far short of the history behind it
+    auto fg = flowgraph::make();
+    fg->connect(src, 0, copy0, 0);
+    fg->connect(copy0, 0, hist, 0);
+    fg->connect(hist, 0, snk, 0);
+    fg->start();
+    fg->wait();
+
+    EXPECT_EQ(snk->data(), input_data);
+    auto buf = copy0->output_stream_ports()[0]->buffer();
+    EXPECT_NE(buf->type().rfind("buffer_passthrough", 0), 0u) << buf->type();
+    EXPECT_GE(buf->num_items(), 2 * history);
+    EXPECT_GT(copy0->copies(), 0u);
+}
@@ -0,0 +1,43 @@
+#!/usr/bin/env python3
+
+from newsched import gr_unittest, gr, blocks
+
+class test_perf_counters(gr_unittest.TestCase):
+
+    def setUp(self):
+        self.tb = gr.flowgraph()
+
+    def tearDown(self):
+        self.tb = None
+
+    def test_counters(self):
+        nsamples = 100000
+        input_data = list(range(nsamples))
+
+        src = blocks.vector_source_f(input_data, False)
+        cp1 = blocks.copy(gr.sizeof_float)
+        snk1 = blocks.vector_sink_f()
+
+        self.tb.connect(src, 0, cp1, 0)
+        self.tb.connect(cp1, 0, snk1, 0)
+
+        # Off until asked for
+        cp1.set_perf_counters_enabled(True)
+
+        self.tb.start()
+        self.tb.wait()
+
+        self.assertEqual(input_data, snk1.data())
+
+        pc = cp1.pc_snapshot()
+        self.assertGreater(pc.work_calls, 0)
+        self.assertEqual(pc.items_consumed, nsamples)
+        self.assertEqual(pc.items_produced, nsamples)
+        self.assertGreater(pc.work_time, 0.0)
+        self.assertEqual(sum(pc.work_time_histogram), pc.work_calls)
+
+        cp1.reset_perf_counters()
+        self.assertEqual(cp1.pc_snapshot().work_calls, 0)
+
+if __name__ == "__main__":
+    gr_unittest.run(test_perf_counters)
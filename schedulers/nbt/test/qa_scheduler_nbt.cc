@@ -10,6 +10,7 @@
 #include <gnuradio/blocks/vector_source.hh>
 #include <gnuradio/flowgraph.hh>
 #include <gnuradio/schedulers/nbt/scheduler_nbt.hh>
+#include <gnuradio/buffer_cpu_simple.hh>
 #include <gnuradio/buffer_cpu_vmcirc.hh>
 
 using namespace gr;
@@ -171,3 +172,35 @@ TEST(SchedulerMTTest, CustomCPUBuffers)
     EXPECT_EQ(snk1->data(), input_data);
     EXPECT_EQ(snk2->data(), input_data);
 }
+
+TEST(SchedulerMTTest, SimpleCPUBuffers)
+{
+    int nsamples = 1000000;
+    std::vector<float> input_data(nsamples);
+    for (int i = 0; i < nsamples; i++) {
+        input_data[i] = i;
+    }
+    auto src = blocks::vector_source_f::make({ input_data, false });
+    auto snk = blocks::vector_sink_f::make({});
+    std::vector<blocks::copy::sptr> copy_blks(8);
+    for (auto& c : copy_blks) {
+        c = blocks::copy::make({ sizeof(float) });
+    }
+
+    flowgraph_sptr fg(new flowgraph());
+    fg->connect(src, 0, copy_blks[0], 0);
+    for (size_t i = 1; i < copy_blks.size(); i++) {
+        fg->connect(copy_blks[i - 1], 0, copy_blks[i], 0);
+    }
+    fg->connect(copy_blks[copy_blks.size() - 1], 0, snk, 0);
+
+    auto sched = schedulers::scheduler_nbt::make("nbt", 4096);
+    sched->set_default_buffer_factory(BUFFER_CPU_SIMPLE_ARGS);
+    fg->set_scheduler(sched);
+
+    fg->start();
+    fg->wait();
+
+    EXPECT_EQ(snk->data().size(), input_data.size());
+    EXPECT_EQ(snk->data(), input_data);
+}
@@ -13,9 +13,132 @@
 #include <gnuradio/flowgraph.hh>
 #include <gnuradio/schedulers/nbt/scheduler_nbt.hh>
 #include <gnuradio/buffer_cpu_vmcirc.hh>
+#include <gnuradio/tag_store.hh>
 
 using namespace gr;
 
+TEST(SchedulerMTTags, TagStore)
+{
+    tag_store ts;
+    for (uint64_t i = 0; i < 1000; i++) {
+        ts.insert(tag_t(10 * i, pmtf::wrap(), pmtf::wrap()));
+    }
+    // Out of order insertion lands after the tags at the same offset
+    ts.insert(tag_t(55, pmtf::wrap(), pmtf::wrap()));
+    ts.insert(tag_t(50, pmtf::wrap(), pmtf::wrap()));
+    EXPECT_EQ(ts.size(), 1002u);
+    EXPECT_TRUE(std::is_sorted(ts.begin(), ts.end(), tag_t::offset_compare));
+
+    std::vector<tag_t> window;
+    ts.in_window(50, 70, window);
+    ASSERT_EQ(window.size(), 4u);
+    EXPECT_EQ(window[0].offset, 50u);
+    EXPECT_EQ(window[1].offset, 50u);
+    EXPECT_EQ(window[2].offset, 55u);
+    EXPECT_EQ(window[3].offset, 60u);
+
+    ts.prune(5000);
+    EXPECT_EQ(ts.size(), 500u);
+    EXPECT_EQ(ts.begin()->offset, 5000u);
+}
+
+TEST(SchedulerMTTags, ReaderWindows)
+{
+    auto props = buffer_cpu_vmcirc_properties::make(buffer_cpu_vmcirc_type::AUTO);
+    auto buf = props->factory()(8192, sizeof(float), props);
+    auto rdr = buf->add_reader(props, sizeof(float));
+    // A reader of pairs of items
+    auto rdr2 = buf->add_reader(props, 2 * sizeof(float));
+
+    for (uint64_t i = 0; i < 100; i++) {
+        buf->add_tag(3 * i, pmtf::wrap(), pmtf::wrap());
+    }
+
+    EXPECT_EQ(rdr->get_tags(30).size(), 10u);
+    EXPECT_EQ(rdr->tags_in_window(3, 9).size(), 2u);
+
+    // Offsets 0, 3, 6 and 9 fall in items 0, 1, 3 and 4 of the pairs
+    auto tags = rdr2->tags_in_window(0, 5);
+    ASSERT_EQ(tags.size(), 4u);
+    EXPECT_EQ(tags[0].offset, 0u);
+    EXPECT_EQ(tags[1].offset, 1u);
+    EXPECT_EQ(tags[2].offset, 3u);
+    EXPECT_EQ(tags[3].offset, 4u);
+
+    buf->post_write(300);
+    rdr->post_read(150);
+    rdr2->post_read(75);
+    buf->prune_tags();
+    EXPECT_EQ(buf->tags().size(), 50u);
+}
+
+TEST(SchedulerMTTags, DenseTags)
+{
+    size_t N = 40000;
+    auto fg = flowgraph::make();
+    auto src = gr::blocks::null_source::make({});
+    auto head = gr::blocks::head::make_cpu({N});
+    auto ann0 = gr::blocks::annotator::make_cpu(
+        {10, 1, 1, tag_propagation_policy_t::TPP_ALL_TO_ALL});
+    auto ann1 = gr::blocks::annotator::make_cpu(
+        {10, 1, 1, tag_propagation_policy_t::TPP_ALL_TO_ALL});
+    auto snk0 = gr::blocks::null_sink::make({});
+
+    fg->connect(src, 0, head, 0);
+    fg->connect(head, 0, ann0, 0);
+    fg->connect(ann0, 0, ann1, 0);
+    fg->connect(ann1, 0, snk0, 0);
+
+    auto sched = schedulers::scheduler_nbt::make();
+    fg->set_scheduler(sched);
+    fg->validate();
+
+    fg->run();
+
+    auto tags1 = ann1->data();
+    EXPECT_EQ(tags1.size(), N / 10);
+    EXPECT_TRUE(std::is_sorted(tags1.begin(), tags1.end(), tag_t::offset_compare));
+}
+
+TEST(SchedulerMTTags, DenseTagsFanout)
+{
+    size_t N = 40000;
+    size_t nout = 4;
+    auto fg = flowgraph::make();
+    auto src = gr::blocks::null_source::make({});
+    auto head = gr::blocks::head::make_cpu({N});
+    auto ann0 = gr::blocks::annotator::make_cpu(
+        {10, 1, nout, tag_propagation_policy_t::TPP_ALL_TO_ALL});
+
+    fg->connect(src, 0, head, 0);
+    fg->connect(head, 0, ann0, 0);
+
+    std::vector<gr::blocks::annotator::sptr> anns;
+    for (size_t i = 0; i < nout; i++) {
+        auto ann = gr::blocks::annotator::make_cpu(
+            {N, 1, 1, tag_propagation_policy_t::TPP_ALL_TO_ALL});
+        auto snk = gr::blocks::null_sink::make({});
+        fg->connect(ann0, i, ann, 0);
+        fg->connect(ann, 0, snk, 0);
+        anns.push_back(ann);
+    }
+
+    auto sched = schedulers::scheduler_nbt::make();
+    fg->set_scheduler(sched);
+    fg->validate();
+
+    fg->run();
+
+    for (auto& ann : anns) {
+        auto tags = ann->data();
+        ASSERT_EQ(tags.size(), N / 10);
+        // Each tag shows up once, at the offset it was added at
+        for (size_t i = 0; i < tags.size(); i++) {
+            EXPECT_EQ(tags[i].offset, 10 * i);
+        }
+    }
+}
+
 TEST(SchedulerMTTags, OneToOne)
 {
     size_t N = 40000;
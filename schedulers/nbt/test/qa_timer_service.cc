@@ -0,0 +1,185 @@
+#include <gtest/gtest.h>
+
+#include <gnuradio/blocks/head.hh>
+#include <gnuradio/blocks/throttle.hh>
+#include <gnuradio/blocks/vector_sink.hh>
+#include <gnuradio/blocks/vector_source.hh>
+#include <gnuradio/flowgraph.hh>
+#include <gnuradio/port.hh>
+#include <gnuradio/schedulers/nbt/scheduler_nbt.hh>
+#include <gnuradio/sync_block.hh>
+#include <gnuradio/timer_service.hh>
+
+#include <atomic>
+#include <cstring>
+#include <future>
+#include <mutex>
+#include <numeric>
+
+using namespace gr;
+
+namespace {
+// Asks to be called back until the given time, without ever calling back itself
+class gate : public sync_block
+{
+public:
+    gate(std::chrono::milliseconds closed_for)
+        : sync_block("gate"), d_closed_for(closed_for)
+    {
+        add_port(port<float>::make("in", port_direction_t::INPUT));
+        add_port(port<float>::make("out", port_direction_t::OUTPUT));
+    }
+
+    bool start() override
+    {
+        d_open_at = timer_service::clock::now() + d_closed_for;
+        return sync_block::start();
+    }
+
+    work_return_code_t work(std::vector<block_work_input_sptr>& work_input,
+                            std::vector<block_work_output_sptr>& work_output) override
+    {
+        d_calls++;
+        if (timer_service::clock::now() < d_open_at) {
+            return work_return_code_t::WORK_CALLBACK_INITIATED;
+        }
+        auto n = work_output[0]->n_items;
+        std::memcpy(work_output[0]->items<float>(),
+                    work_input[0]->items<float>(),
+                    n * sizeof(float));
+        work_output[0]->n_produced = n;
+        return work_return_code_t::WORK_OK;
+    }
+
+    uint64_t calls() const { return d_calls; }
+
+private:
+    std::chrono::milliseconds d_closed_for;
+    timer_service::clock::time_point d_open_at;
+    std::atomic<uint64_t> d_calls = 0;
+};
+} // namespace
+
+TEST(TimerServiceTest, Order)
+{
+    timer_service ts;
+    std::mutex mutex;
+    std::vector<int> fired;
+    std::vector<timer_service::clock::time_point> fired_at;
+    auto record = [&](int i) {
+        return [&, i]() {
+            std::lock_guard<std::mutex> lock(mutex);
+            fired.push_back(i);
+            fired_at.push_back(timer_service::clock::now());
+        };
+    };
+
+    auto t0 = timer_service::clock::now();
+    std::vector<std::chrono::milliseconds> delays{ std::chrono::milliseconds(30),
+                                                   std::chrono::milliseconds(10),
+                                                   std::chrono::milliseconds(40),
+                                                   std::chrono::milliseconds(20) };
+    std::vector<timer_service::timer_id> ids;
+    for (size_t i = 0; i < delays.size(); i++) {
+        ids.push_back(ts.schedule_at(t0 + delays[i], record(i)));
+    }
+    EXPECT_EQ(ts.pending(), 4u);
+    EXPECT_TRUE(ts.cancel(ids[2]));
+    EXPECT_FALSE(ts.cancel(ids[2]));
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    std::lock_guard<std::mutex> lock(mutex);
+    ASSERT_EQ(fired, (std::vector<int>{ 1, 3, 0 }));
+    for (size_t i = 0; i < fired.size(); i++) {
+        EXPECT_GE(fired_at[i], t0 + delays[fired[i]]);
+    }
+    EXPECT_EQ(ts.pending(), 0u);
+    EXPECT_FALSE(ts.cancel(ids[0]));
+}
+
+TEST(TimerServiceTest, Throttle)
+{
+    size_t nsamples = 20000;
+    double rate = 100000;
+    std::vector<float> input_data(1000);
+    for (size_t i = 0; i < input_data.size(); i++) {
+        input_data[i] = i;
+    }
+
+    auto src = blocks::vector_source_f::make({ input_data, true });
+    auto throttle = blocks::throttle::make_cpu({ rate, true, sizeof(float) });
+    auto head = blocks::head::make_cpu({ nsamples, sizeof(float) });
+    auto snk = blocks::vector_sink_f::make({});
+
+    auto fg = flowgraph::make();
+    fg->connect(src, 0, throttle, 0);
+    fg->connect(throttle, 0, head, 0);
+    fg->connect(head, 0, snk, 0);
+
+    auto t0 = std::chrono::steady_clock::now();
+    fg->start();
+    fg->wait();
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0)
+                         .count();
+
+    auto data = snk->data();
+    ASSERT_EQ(data.size(), nsamples);
+    for (size_t i = 0; i < nsamples; i++) {
+        ASSERT_EQ(data[i], input_data[i % input_data.size()]);
+    }
+    EXPECT_GE(elapsed, 0.9 * nsamples / rate);
+    EXPECT_LT(elapsed, 2.0 * nsamples / rate + 0.2);
+}
+
+TEST(TimerServiceTest, CallbackRetry)
+{
+    size_t nsamples = 10000;
+    std::vector<float> input_data(1000);
+    for (size_t i = 0; i < input_data.size(); i++) {
+        input_data[i] = i;
+    }
+
+    auto src = blocks::vector_source_f::make({ input_data, true });
+    auto g = std::make_shared<gate>(std::chrono::milliseconds(50));
+    auto head = blocks::head::make_cpu({ nsamples, sizeof(float) });
+    auto snk = blocks::vector_sink_f::make({});
+
+    auto fg = flowgraph::make();
+    fg->connect(src, 0, g, 0);
+    fg->connect(g, 0, head, 0);
+    fg->connect(head, 0, snk, 0);
+    fg->start();
+    fg->wait();
+
+    EXPECT_EQ(snk->data().size(), nsamples);
+    // Retried by the scheduler with backoff rather than in a busy loop
+    EXPECT_LT(g->calls(), 200u);
+}
+
+TEST(TimerServiceTest, WakeupDuringFlush)
+{
+    // A short finite input, so the flowgraph is already flushing while the gate waits
+    // on its wake-ups, and the last one must still let the flush finish
+    std::vector<float> input_data(1000);
+    std::iota(input_data.begin(), input_data.end(), 0.0f);
+
+    for (int iter = 0; iter < 20; iter++) {
+        auto src = blocks::vector_source_f::make({ input_data, false });
+        auto g = std::make_shared<gate>(std::chrono::milliseconds(20));
+        auto snk = blocks::vector_sink_f::make({});
+
+        auto fg = flowgraph::make();
+        fg->connect(src, 0, g, 0);
+        fg->connect(g, 0, snk, 0);
+        fg->start();
+
+        auto done = std::async(std::launch::async, [fg]() { fg->wait(); });
+        auto status = done.wait_for(std::chrono::seconds(5));
+        if (status != std::future_status::ready) {
+            fg->stop();
+        }
+        ASSERT_EQ(status, std::future_status::ready) << "iteration " << iter;
+        EXPECT_EQ(snk->data(), input_data);
+    }
+}
@@ -0,0 +1,174 @@
+#include <gtest/gtest.h>
+
+#include <gnuradio/blocks/copy.hh>
+#include <gnuradio/blocks/vector_sink.hh>
+#include <gnuradio/blocks/vector_source.hh>
+#include <gnuradio/flowgraph.hh>
+#include <gnuradio/schedulers/nbt/scheduler_nbt.hh>
+
+#include <chrono>
+#include <set>
+#include <thread>
+
+using namespace gr;
+using namespace gr::schedulers;
+
+// The plugin entry point of the scheduler library
+extern "C" std::shared_ptr<gr::scheduler> factory(const std::string& options);
+
+TEST(WaitStrategyTest, FromString)
+{
+    EXPECT_EQ(wait_strategy_from_string("blocking"), wait_strategy_t::BLOCKING);
+    EXPECT_EQ(wait_strategy_from_string("busy_spin"), wait_strategy_t::BUSY_SPIN);
+    EXPECT_EQ(wait_strategy_from_string("spin_yield"), wait_strategy_t::SPIN_YIELD);
+    EXPECT_EQ(wait_strategy_from_string("spin_block"), wait_strategy_t::SPIN_BLOCK);
+    EXPECT_THROW(wait_strategy_from_string("sleepy"), std::invalid_argument);
+}
+
+TEST(WaitStrategyTest, Waiter)
+{
+    auto msg_in = std::make_shared<scheduler_action>(scheduler_action_t::NOTIFY_ALL, 0);
+    for (auto strategy : { wait_strategy_t::BLOCKING,
+                           wait_strategy_t::BUSY_SPIN,
+                           wait_strategy_t::SPIN_YIELD,
+                           wait_strategy_t::SPIN_BLOCK }) {
+        concurrent_queue<scheduler_message_sptr> q;
+        message_waiter waiter({ strategy, 1000 });
+
+        // Already queued
+        scheduler_message_sptr msg;
+        q.push(msg_in);
+        EXPECT_TRUE(waiter.wait(q, msg));
+        EXPECT_EQ(msg, msg_in);
+
+        // Arriving well after all the polling is over
+        msg = nullptr;
+        std::thread t([&]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            q.push(msg_in);
+        });
+        EXPECT_TRUE(waiter.wait(q, msg));
+        EXPECT_EQ(msg, msg_in);
+        t.join();
+    }
+}
+
+TEST(WaitStrategyTest, AdaptiveSpin)
+{
+    concurrent_queue<scheduler_message_sptr> q;
+    message_waiter waiter({ wait_strategy_t::SPIN_BLOCK, 4096 });
+    EXPECT_EQ(waiter.spin_limit(), 4096u);
+
+    // Messages that only come after sleeping make the polling shorter
+    scheduler_message_sptr msg;
+    for (int i = 0; i < 5; i++) {
+        std::thread t([&]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            q.push(std::make_shared<scheduler_action>(scheduler_action_t::NOTIFY_ALL, 0));
+        });
+        waiter.wait(q, msg);
+        t.join();
+    }
+    auto limit = waiter.spin_limit();
+    EXPECT_LT(limit, 4096u);
+
+    // but never down to nothing
+    for (int i = 0; i < 100; i++) {
+        q.push(std::make_shared<scheduler_action>(scheduler_action_t::NOTIFY_ALL, 0));
+        waiter.wait(q, msg);
+    }
+    EXPECT_GE(waiter.spin_limit(), 16u);
+    EXPECT_LE(waiter.spin_limit(), limit);
+}
+
+TEST(WaitStrategyTest, Flowgraph)
+{
+    int nsamples = 200000;
+    std::vector<float> input_data(nsamples);
+    for (int i = 0; i < nsamples; i++) {
+        input_data[i] = i;
+    }
+
+    for (auto strategy : { wait_strategy_t::BLOCKING,
+                           wait_strategy_t::BUSY_SPIN,
+                           wait_strategy_t::SPIN_YIELD,
+                           wait_strategy_t::SPIN_BLOCK }) {
+        auto src = blocks::vector_source_f::make({ input_data, false });
+        auto copy0 = blocks::copy::make({ sizeof(float) });
+        auto copy1 = blocks::copy::make({ sizeof(float) });
+        auto snk = blocks::vector_sink_f::make({});
+
+        auto fg = flowgraph::make();
+        fg->connect(src, 0, copy0, 0);
+        fg->connect(copy0, 0, copy1, 0);
+        fg->connect(copy1, 0, snk, 0);
+
+        // One group with a strategy of its own, the rest on the default
+        auto sched = scheduler_nbt::make("nbt");
+        sched->add_block_group({ copy0, copy1 }, "rx");
+        sched->set_wait_strategy({ strategy, 1000 }, "rx");
+        sched->set_wait_strategy({ wait_strategy_t::SPIN_BLOCK, 1000 });
+        fg->set_scheduler(sched);
+
+        fg->start();
+        fg->wait();
+
+        EXPECT_EQ(snk->data(), input_data);
+    }
+}
+
+TEST(WaitStrategyTest, Factory)
+{
+    int nsamples = 100000;
+    std::vector<float> input_data(nsamples);
+    for (int i = 0; i < nsamples; i++) {
+        input_data[i] = i;
+    }
+
+    auto src = blocks::vector_source_f::make({ input_data, false });
+    auto copy0 = blocks::copy::make({ sizeof(float) });
+    auto copy1 = blocks::copy::make({ sizeof(float) });
+    auto snk = blocks::vector_sink_f::make({});
+
+    auto fg = flowgraph::make();
+    fg->connect(src, 0, copy0, 0);
+    fg->connect(copy0, 0, copy1, 0);
+    fg->connect(copy1, 0, snk, 0);
+
+    // The groups take what they leave out from the top level
+    auto sched = std::dynamic_pointer_cast<scheduler_nbt>(
+        factory("{wait_strategy: spin_yield, spin_count: 2000, "
+                "group_wait_strategies: {rx: {wait_strategy: busy_spin}, "
+                "tx: {spin_count: 500}}}"));
+    ASSERT_TRUE(sched);
+    sched->add_block_group({ copy0 }, "rx");
+    sched->add_block_group({ copy1 }, "tx");
+    fg->set_scheduler(sched);
+
+    fg->start();
+    fg->wait();
+    EXPECT_EQ(snk->data(), input_data);
+
+    std::set<std::string> groups;
+    ASSERT_GE(sched->threads().size(), 3u);
+    for (auto& t : sched->threads()) {
+        auto& wait = t->wait_strategy();
+        if (t->name() == "rx") {
+            EXPECT_EQ(wait.strategy, wait_strategy_t::BUSY_SPIN);
+            EXPECT_EQ(wait.spin_count, 2000u);
+        } else if (t->name() == "tx") {
+            EXPECT_EQ(wait.strategy, wait_strategy_t::SPIN_YIELD);
+            EXPECT_EQ(wait.spin_count, 500u);
+        } else {
+            EXPECT_EQ(wait.strategy, wait_strategy_t::SPIN_YIELD) << t->name();
+            EXPECT_EQ(wait.spin_count, 2000u) << t->name();
+        }
+        groups.insert(t->name());
+    }
+    EXPECT_EQ(groups.count("rx"), 1u);
+    EXPECT_EQ(groups.count("tx"), 1u);
+
+    EXPECT_THROW(factory("{wait_strategy: sleepy}"), std::invalid_argument);
+    EXPECT_THROW(factory("{group_wait_strategies: {rx: {wait_strategy: sleepy}}}"),
+                 std::invalid_argument);
+}
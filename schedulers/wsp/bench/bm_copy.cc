@@ -0,0 +1,93 @@
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+#include <gnuradio/blocks/copy.hh>
+#include <gnuradio/blocks/head.hh>
+#include <gnuradio/blocks/null_sink.hh>
+#include <gnuradio/blocks/null_source.hh>
+#include <gnuradio/flowgraph.hh>
+#include <gnuradio/realtime.hh>
+#include <gnuradio/schedulers/wsp/scheduler_wsp.hh>
+#include <gnuradio/buffer_cpu_simple.hh>
+#include <gnuradio/buffer_cpu_vmcirc.hh>
+
+#include <iostream>
+
+#include "CLI/App.hpp"
+#include "CLI/Formatter.hpp"
+#include "CLI/Config.hpp"
+
+using namespace gr;
+
+int main(int argc, char* argv[])
+{
+    uint64_t samples = 15000000;
+    unsigned int nblocks = 4;
+    unsigned int nthreads = 0;
+    int veclen = 1;
+    int buffer_type = 1;
+    int buffer_size = 32768;
+    bool rt_prio = false;
+
+    std::vector<unsigned int> cpu_affinity;
+
+    CLI::App app{"App description"};
+
+    app.add_option("--samples", samples, "Number of Samples");
+    app.add_option("--veclen", veclen, "Vector Length");
+    app.add_option("--nblocks", nblocks, "Number of copy blocks");
+    app.add_option("--nthreads", nthreads, "Number of worker threads (0: hardware concurrency)");
+    app.add_option("--buffer_type", buffer_type, "Buffer Type (0:simple, 1:vmcirc)");
+    app.add_option("--buffer_size", buffer_size, "Buffer Size in bytes");
+    app.add_flag("--rt_prio", rt_prio, "Enable Real-time priority");
+    app.add_option("--cpus", cpu_affinity, "Pin worker threads to CPUs");
+
+    CLI11_PARSE(app, argc, argv);
+
+    if (rt_prio && gr::enable_realtime_scheduling() != RT_OK) {
+        std::cout << "Error: failed to enable real-time scheduling." << std::endl;
+    }
+
+    {
+        auto src = blocks::null_source::make({1, sizeof(gr_complex) * veclen});
+        auto head = blocks::head::make_cpu({samples / veclen, sizeof(gr_complex) * veclen});
+        auto snk = blocks::null_sink::make({1, sizeof(gr_complex) * veclen});
+        std::vector<blocks::copy::sptr> copy_blks(nblocks);
+        for (unsigned int i = 0; i < nblocks; i++) {
+            copy_blks[i] = blocks::copy::make({sizeof(gr_complex) * veclen});
+        }
+        flowgraph_sptr fg(new flowgraph());
+
+        fg->connect(src, 0, head, 0);
+        fg->connect(head, 0, copy_blks[0], 0);
+        for (unsigned int i = 0; i < nblocks - 1; i++) {
+            fg->connect(copy_blks[i], 0, copy_blks[i + 1], 0);
+        }
+        fg->connect(copy_blks[nblocks - 1], 0, snk, 0);
+
+        auto sched = schedulers::scheduler_wsp::make("wsp", buffer_size, nthreads, cpu_affinity);
+        std::cout << "Initializing WSP scheduler with " << sched->num_workers()
+                  << " workers and buffer size of " << buffer_size << std::endl;
+        fg->add_scheduler(sched);
+
+        if (buffer_type == 0) {
+            sched->set_default_buffer_factory(BUFFER_CPU_SIMPLE_ARGS);
+        } else if (buffer_type == 1) {
+            sched->set_default_buffer_factory(BUFFER_CPU_VMCIRC_ARGS);
+        }
+
+        fg->validate();
+
+        auto t1 = std::chrono::steady_clock::now();
+
+        fg->start();
+        fg->wait();
+
+        auto t2 = std::chrono::steady_clock::now();
+        auto time =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1).count() / 1e9;
+
+        std::cout << "[PROFILE_TIME]" << time << "[PROFILE_TIME]" << std::endl;
+    }
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <gnuradio/block.hh>
+#include <gnuradio/buffer_management.hh>
+#include <gnuradio/concurrent_queue.hh>
+#include <gnuradio/neighbor_interface.hh>
+#include <gnuradio/scheduler_message.hh>
+#include <gnuradio/schedulers/nbt/graph_executor.hh>
+
+#include <atomic>
+
+namespace gr {
+namespace schedulers {
+
+class scheduler_wsp;
+
+/**
+ * @brief A single block executed as a task on the worker pool
+ *
+ * The task is the parent interface of the block and its ports, so readiness
+ * notifications from neighboring blocks arrive here and make the task runnable.  A task
+ * is in the pool at most once; notifications that arrive while it is queued are
+ * absorbed, and notifications that arrive while it is running cause it to run again.
+ *
+ */
+class block_task : public neighbor_interface
+{
+public:
+    enum class state_t { IDLE, QUEUED, RUNNING, RUNNING_NOTIFIED };
+
+private:
+    block_sptr d_block;
+    scheduler_wsp* d_sched;
+    graph_executor d_exec;
+    bool d_source_block;
+    bool d_done = false;
+
+    std::atomic<state_t> d_state = state_t::IDLE;
+
+    /**
+     * @brief Message port, parameter query and parameter change messages for this block
+     *
+     */
+    concurrent_queue<scheduler_message_sptr> msgq;
+
+    logger_sptr _logger;
+    logger_sptr _debug_logger;
+
+    void handle_messages();
+
+public:
+    typedef std::shared_ptr<block_task> sptr;
+
+    static sptr make(block_sptr blk, scheduler_wsp* sched, buffer_manager::sptr bufman)
+    {
+        return std::make_shared<block_task>(blk, sched, bufman);
+    }
+    block_task(block_sptr blk, scheduler_wsp* sched, buffer_manager::sptr bufman);
+
+    block_sptr block() { return d_block; }
+    state_t state() { return d_state.load(); }
+
+    void push_message(scheduler_message_sptr msg) override;
+
+    /**
+     * @brief Make the task runnable
+     *
+     * Called by neighbors whenever the readiness of this block may have changed
+     */
+    void notify();
+
+    /**
+     * @brief Execute the block once, called from a worker thread
+     *
+     */
+    void run();
+};
+
+} // namespace schedulers
+} // namespace gr
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <gnuradio/block.hh>
+#include <gnuradio/buffer_cpu_vmcirc.hh>
+#include <gnuradio/buffer_management.hh>
+#include <gnuradio/scheduler.hh>
+
+#include "block_task.hh"
+#include "worker_pool.hh"
+
+#include <map>
+#include <thread>
+
+namespace gr {
+namespace schedulers {
+
+/**
+ * @brief Work-stealing thread pool scheduler
+ *
+ * Rather than dedicating an OS thread to each block, every block is a task that is run
+ * on a fixed number of worker threads whenever the readiness of its input or output
+ * buffers changes.  This keeps large flowgraphs from oversubscribing the machine.
+ *
+ */
+class scheduler_wsp : public scheduler
+{
+private:
+    const int s_fixed_buf_size;
+    const size_t s_num_workers;
+    std::vector<unsigned int> d_affinity;
+
+    std::unique_ptr<worker_pool> d_pool;
+    std::vector<block_task::sptr> d_tasks;
+    std::map<nodeid_t, block_task::sptr> d_block_task_map;
+    flowgraph_monitor_sptr d_fgmon;
+
+    // Number of tasks that are queued or running; the graph is quiescent at 0
+    std::atomic<int> d_num_active = 0;
+    std::atomic<bool> d_done_signalled = false;
+    std::atomic<bool> d_flushing = false;
+    std::atomic<bool> d_flushed_signalled = false;
+    std::atomic<bool> d_blocks_started = false;
+
+    std::mutex d_exit_mutex;
+    std::condition_variable d_exit_cv;
+    bool d_exit = false;
+
+    void signal_flushed();
+    void stop_blocks();
+
+public:
+    typedef std::shared_ptr<scheduler_wsp> sptr;
+    static sptr make(const std::string name = "wsp",
+                     const unsigned int fixed_buf_size = 32768,
+                     const size_t num_workers = 0,
+                     const std::vector<unsigned int>& affinity = {})
+    {
+        return std::make_shared<scheduler_wsp>(
+            name, fixed_buf_size, num_workers, affinity);
+    }
+
+    /**
+     * @brief Construct a new work-stealing scheduler
+     *
+     * @param name name of the scheduler
+     * @param fixed_buf_size buffer size in bytes
+     * @param num_workers number of worker threads, 0 uses the hardware concurrency
+     * @param affinity if not empty, CPUs to pin the worker threads to
+     */
+    scheduler_wsp(const std::string name = "wsp",
+                  const unsigned int fixed_buf_size = 32768,
+                  const size_t num_workers = 0,
+                  const std::vector<unsigned int>& affinity = {})
+        : scheduler(name),
+          s_fixed_buf_size(fixed_buf_size),
+          s_num_workers(num_workers ? num_workers
+                                    : std::max(1u, std::thread::hardware_concurrency())),
+          d_affinity(affinity)
+    {
+        _default_buf_properties =
+            buffer_cpu_vmcirc_properties::make(buffer_cpu_vmcirc_type::AUTO);
+    }
+    ~scheduler_wsp(){};
+
+    void push_message(scheduler_message_sptr msg);
+
+    /**
+     * @brief Initialize the work-stealing scheduler
+     *
+     * Creates the buffers and a task for each block in the graph
+     *
+     * @param fg subgraph assigned to this scheduler
+     * @param fgmon sptr to flowgraph monitor object
+     */
+    void initialize(flat_graph_sptr fg, flowgraph_monitor_sptr fgmon);
+    void start();
+    void stop();
+    void wait();
+    void run();
+
+    size_t num_workers() { return s_num_workers; }
+
+    // Used by block_task to hand itself to the pool and report its status
+    worker_pool* pool() { return d_pool.get(); }
+    bool flushing() { return d_flushing; }
+    void task_activated() { d_num_active++; }
+    void task_deactivated();
+    void block_done(block_task* task);
+};
+} // namespace schedulers
+} // namespace gr
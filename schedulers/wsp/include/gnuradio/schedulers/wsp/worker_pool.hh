@@ -0,0 +1,80 @@
+#pragma once
+
+#include <gnuradio/logging.hh>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace gr {
+namespace schedulers {
+
+class block_task;
+
+/**
+ * @brief Fixed size pool of worker threads with work stealing
+ *
+ * Each worker owns a deque of runnable tasks.  A worker pops from the back of its own
+ * deque so that a block made runnable by the block it just executed runs next on the
+ * same core while the data is still in cache.  When its deque is empty, a worker steals
+ * from the front of the other workers' deques before going to sleep.
+ *
+ */
+class worker_pool
+{
+private:
+    struct worker {
+        std::mutex mutex;
+        std::deque<block_task*> tasks;
+        std::thread thread;
+    };
+
+    std::vector<std::unique_ptr<worker>> d_workers;
+    std::vector<unsigned int> d_affinity;
+    std::atomic<bool> d_stopped = false;
+    std::atomic<size_t> d_num_queued = 0;
+    std::atomic<size_t> d_num_sleeping = 0;
+    std::atomic<size_t> d_next_worker = 0;
+
+    std::mutex d_sleep_mutex;
+    std::condition_variable d_sleep_cv;
+
+    logger_sptr _logger;
+    logger_sptr _debug_logger;
+
+    block_task* pop(size_t idx);
+    static void worker_body(worker_pool* top, size_t idx);
+
+public:
+    /**
+     * @brief Construct a new worker pool object
+     *
+     * @param name name used for logging and thread names
+     * @param num_workers number of OS threads to create
+     * @param affinity if not empty, worker i is pinned to affinity[i % affinity.size()]
+     */
+    worker_pool(const std::string& name,
+                size_t num_workers,
+                const std::vector<unsigned int>& affinity = {});
+    ~worker_pool();
+
+    size_t num_workers() { return d_workers.size(); }
+
+    void start();
+    void stop();
+
+    /**
+     * @brief Queue a task to be executed
+     *
+     * When called from one of the pool's workers, the task goes onto that worker's own
+     * deque, otherwise the workers are chosen round robin
+     */
+    void submit(block_task* task);
+};
+
+} // namespace schedulers
+} // namespace gr
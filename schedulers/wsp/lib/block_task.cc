@@ -0,0 +1,118 @@
+#include <gnuradio/schedulers/wsp/block_task.hh>
+#include <gnuradio/schedulers/wsp/scheduler_wsp.hh>
+
+namespace gr {
+namespace schedulers {
+
+block_task::block_task(block_sptr blk, scheduler_wsp* sched, buffer_manager::sptr bufman)
+    : d_block(blk), d_sched(sched), d_exec(blk->alias())
+{
+    _logger = logging::get_logger(blk->alias() + "_task", "default");
+    _debug_logger = logging::get_logger(blk->alias() + "_task_dbg", "debug");
+
+    d_exec.initialize(bufman, { blk });
+    d_source_block = blk->input_stream_ports().empty();
+}
+
+void block_task::push_message(scheduler_message_sptr msg)
+{
+    if (msg->type() == scheduler_message_t::SCHEDULER_ACTION) {
+        switch (std::static_pointer_cast<scheduler_action>(msg)->action()) {
+        case scheduler_action_t::NOTIFY_INPUT:
+        case scheduler_action_t::NOTIFY_OUTPUT:
+        case scheduler_action_t::NOTIFY_ALL:
+            notify();
+            break;
+        default:
+            // DONE and EXIT are handled by the scheduler for the whole pool
+            break;
+        }
+        return;
+    }
+
+    msgq.push(msg);
+    notify();
+}
+
+void block_task::notify()
+{
+    auto s = d_state.load();
+    while (true) {
+        if (s == state_t::IDLE) {
+            if (d_state.compare_exchange_weak(s, state_t::QUEUED)) {
+                d_sched->task_activated();
+                d_sched->pool()->submit(this);
+                return;
+            }
+        } else if (s == state_t::RUNNING) {
+            if (d_state.compare_exchange_weak(s, state_t::RUNNING_NOTIFIED)) {
+                return;
+            }
+        } else {
+            // Already queued, or already going to run again
+            return;
+        }
+    }
+}
+
+void block_task::handle_messages()
+{
+    scheduler_message_sptr msg;
+    while (msgq.try_pop(msg)) {
+        switch (msg->type()) {
+        case scheduler_message_t::MSGPORT_MESSAGE: {
+            auto m = std::static_pointer_cast<msgport_message>(msg);
+            m->callback()(m->message());
+        } break;
+        case scheduler_message_t::PARAMETER_QUERY: {
+            auto item = std::static_pointer_cast<param_query_action>(msg);
+            gr_log_debug(_debug_logger, "handle parameter query {}", item->blkid());
+            d_block->on_parameter_query(item->param_action());
+            if (item->cb_fcn() != nullptr)
+                item->cb_fcn()(item->param_action());
+        } break;
+        case scheduler_message_t::PARAMETER_CHANGE: {
+            auto item = std::static_pointer_cast<param_change_action>(msg);
+            gr_log_debug(_debug_logger, "handle parameter change {}", item->blkid());
+            d_block->on_parameter_change(item->param_action());
+            if (item->cb_fcn() != nullptr)
+                item->cb_fcn()(item->param_action());
+        } break;
+        default:
+            break;
+        }
+    }
+}
+
+void block_task::run()
+{
+    d_state.store(state_t::RUNNING);
+
+    handle_messages();
+
+    bool run_again = false;
+    // Once the flowgraph is flushing, sources stop producing and the data already in
+    // the buffers drains through the rest of the graph
+    if (!d_done && !(d_source_block && d_sched->flushing())) {
+        auto& s = d_exec.run_one_iteration();
+        if (s[0] == executor_iteration_status::DONE) {
+            d_done = true;
+            d_sched->block_done(this);
+        } else if (s[0] == executor_iteration_status::READY) {
+            run_again = true;
+        }
+    }
+
+    auto expected = state_t::RUNNING;
+    if (!run_again && d_state.compare_exchange_strong(expected, state_t::IDLE)) {
+        d_sched->task_deactivated();
+        return;
+    }
+
+    // Either there is more to do, or a neighbor notified us while we were running
+    d_state.store(state_t::QUEUED);
+    d_sched->pool()->submit(this);
+}
+
+} // namespace schedulers
+} // namespace gr
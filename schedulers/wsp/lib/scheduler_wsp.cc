@@ -0,0 +1,161 @@
+#include <gnuradio/schedulers/wsp/scheduler_wsp.hh>
+#include <yaml-cpp/yaml.h>
+
+namespace gr {
+namespace schedulers {
+
+void scheduler_wsp::push_message(scheduler_message_sptr msg)
+{
+    if (msg->type() == scheduler_message_t::SCHEDULER_ACTION) {
+        switch (std::static_pointer_cast<scheduler_action>(msg)->action()) {
+        case scheduler_action_t::DONE:
+            // fgmon says that we need to be done, let the data in the buffers drain
+            // through the graph and report FLUSHED once no task is queued or running
+            gr_log_debug(_debug_logger, "fgm signaled DONE, start flushing");
+            task_activated(); // hold off FLUSHED until every task has been kicked
+            d_flushing = true;
+            for (auto& t : d_tasks) {
+                t->notify();
+            }
+            task_deactivated();
+            return;
+        case scheduler_action_t::EXIT:
+            gr_log_debug(_debug_logger, "fgm signaled EXIT");
+            {
+                std::lock_guard<std::mutex> lk(d_exit_mutex);
+                d_exit = true;
+            }
+            d_exit_cv.notify_all();
+            return;
+        default:
+            break;
+        }
+    }
+
+    // Use 0 for blkid all blocks
+    if (msg->blkid() == 0) {
+        for (auto& t : d_tasks) {
+            t->push_message(msg);
+        }
+    } else {
+        d_block_task_map[msg->blkid()]->push_message(msg);
+    }
+}
+
+void scheduler_wsp::initialize(flat_graph_sptr fg, flowgraph_monitor_sptr fgmon)
+{
+    d_fgmon = fgmon;
+
+    auto bufman = std::make_shared<buffer_manager>(s_fixed_buf_size);
+    bufman->initialize_buffers(fg, _default_buf_properties);
+
+    d_pool = std::make_unique<worker_pool>(name(), s_num_workers, d_affinity);
+
+    for (auto& b : fg->calc_used_blocks()) {
+        auto t = block_task::make(b, this, bufman);
+        d_tasks.push_back(t);
+        d_block_task_map[b->id()] = t;
+
+        b->set_parent_intf(t);
+        for (auto& p : b->all_ports()) {
+            p->set_parent_intf(t);
+        }
+    }
+}
+
+void scheduler_wsp::task_deactivated()
+{
+    if (--d_num_active == 0 && d_flushing) {
+        signal_flushed();
+    }
+}
+
+void scheduler_wsp::signal_flushed()
+{
+    if (!d_flushed_signalled.exchange(true)) {
+        gr_log_debug(_debug_logger, "All tasks idle, pushing flushed");
+        d_fgmon->push_message(fg_monitor_message(fg_monitor_message_t::FLUSHED, id()));
+    }
+}
+
+void scheduler_wsp::block_done(block_task* task)
+{
+    if (!d_done_signalled.exchange(true)) {
+        gr_log_debug(
+            _debug_logger, "Signalling DONE to FGM from block {}", task->block()->id());
+        d_fgmon->push_message(
+            fg_monitor_message(fg_monitor_message_t::DONE, id(), task->block()->id()));
+    }
+}
+
+void scheduler_wsp::start()
+{
+    if (!d_blocks_started.exchange(true)) {
+        for (auto& t : d_tasks) {
+            t->block()->start();
+        }
+    }
+    d_pool->start();
+    for (auto& t : d_tasks) {
+        t->notify();
+    }
+}
+void scheduler_wsp::stop()
+{
+    {
+        std::lock_guard<std::mutex> lk(d_exit_mutex);
+        d_exit = true;
+    }
+    d_exit_cv.notify_all();
+
+    d_pool->stop();
+    stop_blocks();
+}
+void scheduler_wsp::wait()
+{
+    {
+        std::unique_lock<std::mutex> lk(d_exit_mutex);
+        d_exit_cv.wait(lk, [this] { return d_exit; });
+    }
+
+    d_pool->stop();
+    stop_blocks();
+    for (auto& t : d_tasks) {
+        t->block()->done();
+    }
+}
+void scheduler_wsp::stop_blocks()
+{
+    // Reached from both stop() and wait(), the blocks only see one stop
+    if (!d_blocks_started.exchange(false)) {
+        return;
+    }
+    for (auto& t : d_tasks) {
+        t->block()->stop();
+    }
+}
+void scheduler_wsp::run()
+{
+    start();
+    wait();
+}
+
+} // namespace schedulers
+} // namespace gr
+
+
+// External plugin interface for instantiating out of tree schedulers
+extern "C" {
+std::shared_ptr<gr::scheduler> factory(const std::string& options)
+{
+    auto opt_yaml = YAML::Load(options);
+
+    auto buf_size = opt_yaml["buffer_size"].as<size_t>(32768);
+    auto name = opt_yaml["name"].as<std::string>("wsp");
+    auto num_threads = opt_yaml["num_threads"].as<size_t>(0);
+    auto cpus =
+        opt_yaml["cpus"].as<std::vector<unsigned int>>(std::vector<unsigned int>{});
+
+    return gr::schedulers::scheduler_wsp::make(name, buf_size, num_threads, cpus);
+}
+}
@@ -0,0 +1,130 @@
+#include <gnuradio/schedulers/wsp/block_task.hh>
+#include <gnuradio/schedulers/wsp/worker_pool.hh>
+#include <gnuradio/thread.hh>
+#include <fmt/core.h>
+
+namespace gr {
+namespace schedulers {
+
+// Identifies the pool and worker the calling thread belongs to, if any
+static thread_local worker_pool* t_pool = nullptr;
+static thread_local size_t t_worker_idx = 0;
+
+worker_pool::worker_pool(const std::string& name,
+                         size_t num_workers,
+                         const std::vector<unsigned int>& affinity)
+    : d_affinity(affinity)
+{
+    _logger = logging::get_logger(name + "_pool", "default");
+    _debug_logger = logging::get_logger(name + "_pool_dbg", "debug");
+
+    for (size_t i = 0; i < num_workers; i++) {
+        d_workers.push_back(std::make_unique<worker>());
+    }
+}
+
+worker_pool::~worker_pool() { stop(); }
+
+void worker_pool::start()
+{
+    d_stopped = false;
+    for (size_t i = 0; i < d_workers.size(); i++) {
+        d_workers[i]->thread = std::thread(worker_body, this, i);
+    }
+}
+
+void worker_pool::stop()
+{
+    {
+        std::lock_guard<std::mutex> lk(d_sleep_mutex);
+        d_stopped = true;
+    }
+    d_sleep_cv.notify_all();
+
+    for (auto& w : d_workers) {
+        if (w->thread.joinable()) {
+            w->thread.join();
+        }
+        std::lock_guard<std::mutex> lk(w->mutex);
+        w->tasks.clear();
+    }
+    d_num_queued = 0;
+}
+
+void worker_pool::submit(block_task* task)
+{
+    size_t idx = (t_pool == this) ? t_worker_idx : d_next_worker++ % d_workers.size();
+    {
+        std::lock_guard<std::mutex> lk(d_workers[idx]->mutex);
+        d_workers[idx]->tasks.push_back(task);
+    }
+    d_num_queued++;
+
+    // A worker goes to sleep only after it has registered itself in d_num_sleeping and
+    // seen no queued tasks, so it cannot miss this wake-up
+    if (d_num_sleeping > 0) {
+        std::lock_guard<std::mutex> lk(d_sleep_mutex);
+        d_sleep_cv.notify_one();
+    }
+}
+
+block_task* worker_pool::pop(size_t idx)
+{
+    block_task* task = nullptr;
+    // Newest task from our own deque first
+    {
+        auto& w = d_workers[idx];
+        std::lock_guard<std::mutex> lk(w->mutex);
+        if (!w->tasks.empty()) {
+            task = w->tasks.back();
+            w->tasks.pop_back();
+        }
+    }
+
+    // Then steal the oldest task from the other workers
+    for (size_t i = 1; !task && i < d_workers.size(); i++) {
+        auto& w = d_workers[(idx + i) % d_workers.size()];
+        std::lock_guard<std::mutex> lk(w->mutex);
+        if (!w->tasks.empty()) {
+            task = w->tasks.front();
+            w->tasks.pop_front();
+        }
+    }
+
+    if (task) {
+        d_num_queued--;
+    }
+    return task;
+}
+
+void worker_pool::worker_body(worker_pool* top, size_t idx)
+{
+    t_pool = top;
+    t_worker_idx = idx;
+
+    thread::set_thread_name(pthread_self(), fmt::format("wsp_worker{}", idx));
+    if (!top->d_affinity.empty()) {
+        gr::thread::thread_bind_to_processor(
+            top->d_affinity[idx % top->d_affinity.size()]);
+    }
+    GR_LOG_DEBUG(top->_debug_logger, "starting worker {}", idx);
+
+    while (!top->d_stopped) {
+        auto task = top->pop(idx);
+        if (task) {
+            task->run();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lk(top->d_sleep_mutex);
+        top->d_num_sleeping++;
+        top->d_sleep_cv.wait(
+            lk, [top] { return top->d_num_queued > 0 || top->d_stopped; });
+        top->d_num_sleeping--;
+    }
+
+    t_pool = nullptr;
+}
+
+} // namespace schedulers
+} // namespace gr
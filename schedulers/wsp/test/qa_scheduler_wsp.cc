@@ -0,0 +1,164 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+#include <gnuradio/blocks/copy.hh>
+#include <gnuradio/blocks/vector_sink.hh>
+#include <gnuradio/blocks/vector_source.hh>
+#include <gnuradio/flowgraph.hh>
+#include <gnuradio/math/multiply_const.hh>
+#include <gnuradio/port.hh>
+#include <gnuradio/schedulers/wsp/scheduler_wsp.hh>
+#include <gnuradio/sync_block.hh>
+
+using namespace gr;
+
+TEST(SchedulerWSPTest, TwoSinks)
+{
+    int nsamples = 100000;
+    std::vector<float> input_data(nsamples);
+    for (int i = 0; i < nsamples; i++) {
+        input_data[i] = i;
+    }
+    auto src = blocks::vector_source_f::make_cpu({ input_data, false });
+    auto snk1 = blocks::vector_sink_f::make({});
+    auto snk2 = blocks::vector_sink_f::make({});
+
+    auto fg = flowgraph::make();
+    fg->connect(src, 0, snk1, 0);
+    fg->connect(src, 0, snk2, 0);
+
+    auto sched = schedulers::scheduler_wsp::make("wsp", 32768, 2);
+    fg->add_scheduler(sched);
+
+    fg->start();
+    fg->wait();
+
+    EXPECT_EQ(snk1->data(), input_data);
+    EXPECT_EQ(snk2->data(), input_data);
+}
+
+TEST(SchedulerWSPTest, MoreBlocksThanWorkers)
+{
+    int nsamples = 1000000;
+    int nblocks = 32;
+    std::vector<float> input_data(nsamples);
+    std::vector<float> expected_data(nsamples);
+    for (int i = 0; i < nsamples; i++) {
+        input_data[i] = i % 256;
+        expected_data[i] = input_data[i] * 2.0;
+    }
+
+    for (auto nworkers : { 1, 3 }) {
+        auto src = blocks::vector_source_f::make_cpu({ input_data, false });
+        auto mult = math::multiply_const_ff::make_cpu({ 2.0 });
+        auto snk = blocks::vector_sink_f::make({});
+        std::vector<blocks::copy::sptr> copy_blks(nblocks);
+        for (int i = 0; i < nblocks; i++) {
+            copy_blks[i] = blocks::copy::make({ sizeof(float) });
+        }
+
+        auto fg = flowgraph::make();
+        fg->connect(src, 0, copy_blks[0], 0);
+        for (int i = 0; i < nblocks - 1; i++) {
+            fg->connect(copy_blks[i], 0, copy_blks[i + 1], 0);
+        }
+        fg->connect(copy_blks[nblocks - 1], 0, mult, 0);
+        fg->connect(mult, 0, snk, 0);
+
+        auto sched = schedulers::scheduler_wsp::make("wsp", 8192, nworkers);
+        EXPECT_EQ(sched->num_workers(), (size_t)nworkers);
+        fg->add_scheduler(sched);
+
+        fg->start();
+        fg->wait();
+
+        EXPECT_EQ(snk->data(), expected_data);
+    }
+}
+
+namespace {
+// Copies its input and counts how often it is started and stopped
+class start_stop_counter : public sync_block
+{
+public:
+    start_stop_counter() : sync_block("start_stop_counter")
+    {
+        add_port(port<float>::make("in", port_direction_t::INPUT));
+        add_port(port<float>::make("out", port_direction_t::OUTPUT));
+    }
+
+    bool start() override
+    {
+        d_starts++;
+        return sync_block::start();
+    }
+    bool stop() override
+    {
+        d_stops++;
+        return sync_block::stop();
+    }
+
+    work_return_code_t work(std::vector<block_work_input_sptr>& work_input,
+                            std::vector<block_work_output_sptr>& work_output) override
+    {
+        auto in = work_input[0]->items<float>();
+        auto out = work_output[0]->items<float>();
+        for (int i = 0; i < work_output[0]->n_items; i++) {
+            out[i] = in[i];
+        }
+        work_output[0]->n_produced = work_output[0]->n_items;
+        return work_return_code_t::WORK_OK;
+    }
+
+    std::atomic<int> d_starts = 0;
+    std::atomic<int> d_stops = 0;
+};
+} // namespace
+
+TEST(SchedulerWSPTest, StopsBlocksOnce)
+{
+    std::vector<float> input_data(100000, 1.0);
+
+    // Run to completion, the flowgraph monitor stops the scheduler before wait returns
+    {
+        auto src = blocks::vector_source_f::make_cpu({ input_data, false });
+        auto counter = std::make_shared<start_stop_counter>();
+        auto snk = blocks::vector_sink_f::make({});
+
+        auto fg = flowgraph::make();
+        fg->connect(src, 0, counter, 0);
+        fg->connect(counter, 0, snk, 0);
+        fg->add_scheduler(schedulers::scheduler_wsp::make("wsp", 32768, 2));
+
+        fg->start();
+        fg->wait();
+
+        EXPECT_EQ(snk->data(), input_data);
+        EXPECT_EQ(counter->d_starts, 1);
+        EXPECT_EQ(counter->d_stops, 1);
+    }
+
+    // Stopped by the user before waiting
+    {
+        auto src = blocks::vector_source_f::make_cpu({ input_data, true });
+        auto counter = std::make_shared<start_stop_counter>();
+        auto snk = blocks::vector_sink_f::make({});
+
+        auto fg = flowgraph::make();
+        fg->connect(src, 0, counter, 0);
+        fg->connect(counter, 0, snk, 0);
+        fg->add_scheduler(schedulers::scheduler_wsp::make("wsp", 32768, 2));
+
+        fg->start();
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        fg->stop();
+        fg->wait();
+
+        EXPECT_EQ(counter->d_starts, 1);
+        EXPECT_EQ(counter->d_stops, 1);
+    }
+}